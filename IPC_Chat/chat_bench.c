@@ -0,0 +1,425 @@
+/*
+ * Load generator for the chat server.
+ *
+ * Connects N synthetic users to a running server and has each send M
+ * messages at a fixed rate, alternating broadcasts with \p2p messages to the
+ * next user. Every message carries the time it was sent, so each recipient
+ * can measure the end to end latency. Reports latency percentiles for both
+ * kinds, how many messages arrived, and the CPU time the server (and its
+ * relay processes) used while the benchmark ran.
+ *
+ * usage: ./chat_bench [-n users] [-m messages] [-r rate] [-p server pid] [-x]
+ *   -n  users to connect (default 10)
+ *   -m  messages each user sends (default 100)
+ *   -r  messages per second each user sends, 0 for as fast as possible (default 100)
+ *   -p  pid of the server, to measure its CPU use (e.g. -p $(pgrep -x server))
+ *   -x  talk to the server through shared memory rings (see shmring.h)
+ */
+#include <stdio.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "comm.h"
+#include "frame.h"
+#include "poller.h"
+#include "shmring.h"
+
+// Leave the server this long (in s) to accept everyone before sending
+#define BENCH_SETTLE_S 1
+// Stop waiting for stragglers after this long (in ms) without a message
+#define BENCH_IDLE_MS 2000
+
+typedef struct _benchUser {
+  int m_fd_read;      // messages from the server
+  int m_fd_write;     // messages to the server
+  FRAME_READER m_reader;
+  int m_sent;
+  long long m_next_send;  // when the next message is due (ns)
+  SHM_CHANNEL * m_channel;  // with -x
+  char m_shm_name[SHM_NAME_MAX];
+  int m_shm_active;       // the server agreed to use m_channel
+} BENCH_USER;
+
+// Latencies of one kind of message, in ns
+typedef struct _latencies {
+  long long * m_ns;
+  int m_count;
+  int m_cap;
+} LATENCIES;
+
+long long now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+void record_latency(LATENCIES * lat, long long ns)
+{
+  if (lat->m_count == lat->m_cap) {
+    int cap = lat->m_cap ? 2 * lat->m_cap : 1024;
+    long long * buf = realloc(lat->m_ns, cap * sizeof(long long));
+    if (buf == NULL)
+      return;
+    lat->m_ns = buf;
+    lat->m_cap = cap;
+  }
+  lat->m_ns[lat->m_count++] = ns;
+}
+
+int compare_ns(const void * a, const void * b)
+{
+  long long x = *(const long long *)a, y = *(const long long *)b;
+  return (x > y) - (x < y);
+}
+
+/*
+ * Nearest rank percentile of sorted latencies
+ */
+long long percentile(LATENCIES * lat, int pct)
+{
+  int rank = (pct * lat->m_count + 99) / 100;
+  return lat->m_ns[rank > 0 ? rank - 1 : 0];
+}
+
+void print_latencies(const char * name, LATENCIES * lat, int expected)
+{
+  printf("%-10s %8d/%-8d", name, lat->m_count, expected);
+  if (lat->m_count == 0) {
+    printf("\n");
+    return;
+  }
+  qsort(lat->m_ns, lat->m_count, sizeof(long long), compare_ns);
+  printf(" %10.1f %10.1f %10.1f %10.1f\n",
+         percentile(lat, 50) / 1000.0, percentile(lat, 90) / 1000.0,
+         percentile(lat, 99) / 1000.0, lat->m_ns[lat->m_count - 1] / 1000.0);
+}
+
+/*
+ * User and system CPU ticks used by a process, or -1 if it can't be read
+ */
+long long proc_cpu_ticks(int pid)
+{
+  char path[64], buf[1024], * s;
+  unsigned long long utime, stime;
+  FILE * f;
+
+  snprintf(path, sizeof(path), "/proc/%d/stat", pid);
+  f = fopen(path, "r");
+  if (f == NULL)
+    return -1;
+  s = fgets(buf, sizeof(buf), f);
+  fclose(f);
+  // The command name may hold spaces; the fields after it are fixed
+  if (s == NULL || (s = strrchr(buf, ')')) == NULL)
+    return -1;
+  if (sscanf(s + 2, "%*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %llu %llu",
+             &utime, &stime) != 2)
+    return -1;
+  return (long long)(utime + stime);
+}
+
+/*
+ * CPU ticks used by the server and the relays it has forked
+ */
+long long server_cpu_ticks(int pid)
+{
+  char path[64];
+  long long total = proc_cpu_ticks(pid), ticks;
+  int child;
+  FILE * f;
+
+  if (total == -1)
+    return -1;
+  snprintf(path, sizeof(path), "/proc/%d/task/%d/children", pid, pid);
+  f = fopen(path, "r");
+  if (f != NULL) {
+    while (fscanf(f, "%d", &child) == 1) {
+      if ((ticks = proc_cpu_ticks(child)) > 0)
+        total += ticks;
+    }
+    fclose(f);
+  }
+  return total;
+}
+
+/*
+ * Send message number user->m_sent from user i: even ones are broadcast,
+ * odd ones go to the next user. The frame is shorter than PIPE_BUF, so the
+ * write is all or nothing. Returns 0, or -1 if the pipe is full.
+ */
+int send_bench_msg(BENCH_USER * bench_users, int n, int i)
+{
+  char frame[FRAME_HEADER + MAX_MSG];
+  char * text = frame + FRAME_HEADER;
+  int len;
+  ssize_t nbytes;
+  BENCH_USER * user = &bench_users[i];
+
+  if (user->m_sent % 2 == 0 || n < 2)
+    len = snprintf(text, MAX_MSG, "bench b %lld", now_ns());
+  else
+    len = snprintf(text, MAX_MSG, "\\p2p bench%d bench p %lld", (i + 1) % n, now_ns());
+  if (user->m_shm_active) {
+    if (shm_ring_put(&user->m_channel->m_to_server, text, len) == -1)
+      return -1;
+    if (shm_ring_wake_reader(&user->m_channel->m_to_server))
+      shm_doorbell(user->m_fd_write);
+    return 0;
+  }
+  frame_header(frame, len);
+  do {
+    nbytes = write(bench_users[i].m_fd_write, frame, FRAME_HEADER + len);
+  } while (nbytes == -1 && errno == EINTR);
+  if (nbytes == -1) {
+    if (errno != EAGAIN)
+      perror("Couldn't send message");
+    return -1;
+  }
+  return 0;
+}
+
+/*
+ * Take the latency from a received message: "<sender>:bench b <ns>" for a
+ * broadcast, "<sender> : bench p <ns>" for a p2p message
+ */
+void handle_bench_msg(char * msg, LATENCIES * broadcast, LATENCIES * p2p)
+{
+  char kind;
+  long long sent;
+  char * s = strstr(msg, "bench ");
+
+  if (s == NULL || sscanf(s, "bench %c %lld", &kind, &sent) != 2)
+    return;
+  if (kind == 'b')
+    record_latency(broadcast, now_ns() - sent);
+  else if (kind == 'p')
+    record_latency(p2p, now_ns() - sent);
+}
+
+/*
+ * Handle what the server sent user j through the pipe. Returns -1 if the
+ * server has disconnected the user.
+ */
+int read_bench_pipe(BENCH_USER * user, LATENCIES * broadcast, LATENCIES * p2p)
+{
+  char * msg;
+  size_t len;
+  ssize_t nbytes = frame_read(&user->m_reader, user->m_fd_read);
+
+  if (nbytes == 0)
+    return -1;
+  while (frame_next(&user->m_reader, &msg, &len) == 1) {
+    if (len == 0)
+      continue; // A doorbell for the ring
+    if (user->m_channel != NULL && !user->m_shm_active &&
+        strncmp(msg, SHM_COMMAND, strlen(SHM_COMMAND)) == 0) {
+      if (strcmp(msg, SHM_ACCEPT) == 0) {
+        frame_write(user->m_fd_write, SHM_START, strlen(SHM_START));
+        user->m_shm_active = 1;
+      } else {
+        shm_channel_close(user->m_channel);
+        shm_channel_unlink(user->m_shm_name);
+        user->m_channel = NULL;
+      }
+      continue;
+    }
+    handle_bench_msg(msg, broadcast, p2p);
+  }
+  return 0;
+}
+
+/*
+ * Handle everything in the ring from the server to user, then mark the user
+ * asleep on it
+ */
+void read_bench_ring(BENCH_USER * user, LATENCIES * broadcast, LATENCIES * p2p)
+{
+  SHM_RING * ring = &user->m_channel->m_to_user;
+  char buf[MAX_MSG];
+  char * msg;
+  size_t len;
+
+  do {
+    while (shm_ring_get(ring, &msg, &len) == 1) {
+      size_t copy = len < MAX_MSG ? len : MAX_MSG - 1;
+      memcpy(buf, msg, copy);
+      buf[copy] = '\0';
+      shm_ring_done(ring, len);
+      handle_bench_msg(buf, broadcast, p2p);
+    }
+    if (shm_ring_wake_writer(ring))
+      shm_doorbell(user->m_fd_write);
+  } while (shm_ring_sleep(ring) == 0);
+}
+
+int main(int argc, char * argv[])
+{
+  int n = 10, m = 100, rate = 100, server_pid = -1, use_shm = 0, nshm = 0;
+  int opt, i, j, nready, done, max_fd = 0, expect_broadcast, expect_p2p;
+  int * fd_user;
+  long long interval, start, end, next, cpu_start = -1, cpu_end;
+  char user_id[MAX_USER_ID];
+  BENCH_USER * bench_users;
+  LATENCIES broadcast = {}, p2p = {};
+  POLLER poller;
+  POLLER_EVENT events[64];
+
+  while ((opt = getopt(argc, argv, "n:m:r:p:x")) != -1) {
+    switch (opt) {
+      case 'n': n = atoi(optarg); break;
+      case 'm': m = atoi(optarg); break;
+      case 'r': rate = atoi(optarg); break;
+      case 'p': server_pid = atoi(optarg); break;
+      case 'x': use_shm = 1; break;
+      default:
+        fprintf(stderr, "usage: %s [-n users] [-m messages] [-r rate] [-p server pid] [-x]\n", argv[0]);
+        exit(-1);
+    }
+  }
+  if (n < 1 || m < 0 || rate < 0) {
+    fprintf(stderr, "users must be positive, messages and rate not negative\n");
+    exit(-1);
+  }
+  interval = rate > 0 ? 1000000000LL / rate : 0;
+
+  bench_users = calloc(n, sizeof(BENCH_USER));
+  if (bench_users == NULL || poller_init(&poller) == -1) {
+    perror("Couldn't set up benchmark");
+    exit(-1);
+  }
+  for (i = 0; i < n; i++) {
+    int pipe_to_user[2], pipe_to_server[2];
+    snprintf(user_id, sizeof(user_id), "bench%d", i);
+    if (connect_to_server("500", user_id, pipe_to_user, pipe_to_server) == -1) {
+      fprintf(stderr, "Couldn't connect user %s\n", user_id);
+      exit(-1);
+    }
+    close(pipe_to_user[1]);
+    close(pipe_to_server[0]);
+    bench_users[i].m_fd_read = pipe_to_user[0];
+    bench_users[i].m_fd_write = pipe_to_server[1];
+    fcntl(pipe_to_user[0], F_SETFL, fcntl(pipe_to_user[0], F_GETFL) | O_NONBLOCK);
+    fcntl(pipe_to_server[1], F_SETFL, fcntl(pipe_to_server[1], F_GETFL) | O_NONBLOCK);
+    frame_reader_init(&bench_users[i].m_reader);
+    if (poller_add(&poller, pipe_to_user[0], POLLER_IN) == -1) {
+      perror("Couldn't watch pipe");
+      exit(-1);
+    }
+    if (pipe_to_user[0] > max_fd)
+      max_fd = pipe_to_user[0];
+    if (use_shm) {
+      char request[MAX_MSG];
+      bench_users[i].m_channel = shm_channel_create(bench_users[i].m_shm_name);
+      if (bench_users[i].m_channel == NULL) {
+        perror("Couldn't create shared memory");
+        exit(-1);
+      }
+      snprintf(request, sizeof(request), "%s%s", SHM_COMMAND, bench_users[i].m_shm_name);
+      frame_write(pipe_to_server[1], request, strlen(request));
+    }
+  }
+  // Map each pipe back to its user
+  fd_user = malloc((max_fd + 1) * sizeof(int));
+  if (fd_user == NULL) {
+    perror("Couldn't set up benchmark");
+    exit(-1);
+  }
+  for (i = 0; i < n; i++)
+    fd_user[bench_users[i].m_fd_read] = i;
+  // A lone user has no one to send to
+  expect_broadcast = n > 1 ? (m + 1) / 2 * n * (n - 1) : 0;
+  expect_p2p = n > 1 ? m / 2 * n : 0;
+  // Let the server accept everyone, and answer the requests for shared memory
+  end = now_ns() + BENCH_SETTLE_S * 1000000000LL;
+  while ((start = now_ns()) < end) {
+    nready = poller_wait(&poller, events, 64, (int)((end - start) / 1000000) + 1);
+    for (i = 0; i < nready; i++)
+      read_bench_pipe(&bench_users[fd_user[events[i].m_fd]], &broadcast, &p2p);
+  }
+  if (use_shm) {
+    for (i = 0; i < n; i++)
+      nshm += bench_users[i].m_shm_active;
+    printf("%d of %d users use shared memory\n", nshm, n);
+  }
+
+  if (server_pid > 0)
+    cpu_start = server_cpu_ticks(server_pid);
+  start = now_ns();
+  for (i = 0; i < n; i++) {
+    // Spread the users' sends over one interval
+    bench_users[i].m_next_send = start + interval * i / n;
+  }
+
+  while (1) {
+    // Send what is due, and find when the next message is
+    long long t = now_ns();
+    next = -1;
+    done = 1;
+    for (i = 0; i < n; i++) {
+      BENCH_USER * user = &bench_users[i];
+      if (user->m_sent < m && user->m_next_send <= t && send_bench_msg(bench_users, n, i) == 0) {
+        user->m_sent++;
+        user->m_next_send += interval;
+      }
+      if (user->m_sent < m) {
+        done = 0;
+        if (next == -1 || user->m_next_send < next)
+          next = user->m_next_send;
+      }
+    }
+    if (done && broadcast.m_count == expect_broadcast && p2p.m_count == expect_p2p)
+      break;
+
+    int timeout = BENCH_IDLE_MS;
+    if (!done)
+      timeout = next > t ? (int)((next - t + 999999) / 1000000) : 0;
+    nready = poller_wait(&poller, events, 64, timeout);
+    if (nready == -1) {
+      if (errno == EINTR)
+        continue;
+      perror("Couldn't wait on pipes");
+      break;
+    }
+    if (nready == 0 && done)
+      break; // Nothing more is coming
+    for (i = 0; i < nready; i++) {
+      j = fd_user[events[i].m_fd];
+      if (read_bench_pipe(&bench_users[j], &broadcast, &p2p) == -1) {
+        fprintf(stderr, "The server disconnected user bench%d\n", j);
+        poller_del(&poller, bench_users[j].m_fd_read);
+      }
+    }
+    // The rings take no doorbell while their reader is awake, so look at all of them
+    for (i = 0; i < n && nshm > 0; i++) {
+      if (bench_users[i].m_shm_active)
+        read_bench_ring(&bench_users[i], &broadcast, &p2p);
+    }
+  }
+  end = now_ns();
+  cpu_end = server_pid > 0 ? server_cpu_ticks(server_pid) : -1;
+
+  printf("%d users, %d messages each at %d/s, %.2f s\n", n, m, rate, (end - start) / 1e9);
+  printf("%-10s %17s %10s %10s %10s %10s\n", "latency", "received", "p50 us", "p90 us", "p99 us", "max us");
+  print_latencies("broadcast", &broadcast, expect_broadcast);
+  print_latencies("p2p", &p2p, expect_p2p);
+  if (cpu_start >= 0 && cpu_end >= 0) {
+    double cpu_s = (double)(cpu_end - cpu_start) / sysconf(_SC_CLK_TCK);
+    printf("server cpu %.2f s (%.1f%% of one core)\n", cpu_s, 100.0 * cpu_s * 1e9 / (end - start));
+  }
+
+  for (i = 0; i < n; i++) {
+    close(bench_users[i].m_fd_read);
+    close(bench_users[i].m_fd_write);
+    frame_reader_free(&bench_users[i].m_reader);
+    shm_channel_close(bench_users[i].m_channel);
+    if (bench_users[i].m_channel != NULL && !bench_users[i].m_shm_active)
+      shm_channel_unlink(bench_users[i].m_shm_name); // Never answered
+  }
+  free(fd_user);
+  free(bench_users);
+  return 0;
+}
@@ -10,6 +10,9 @@
 #include <sys/wait.h>
 #include <sys/socket.h>
 #include "comm.h"
+#include "frame.h"
+#include "poller.h"
+#include "shmring.h"
 
 /* -------------------------Main function for the client ----------------------*/
 void main(int argc, char * argv[]) {
@@ -38,17 +41,34 @@ void main(int argc, char * argv[]) {
 	int nbytesfromstin = 0;
 	int nbytesfrompipe = 0;
 	char buf[MAX_MSG];
-	char buf2[MAX_MSG];
+	size_t buflen = 0;
+	char *line, *newline;
+	FRAME_READER from_server;
+	char *msg;
+	size_t msglen;
+	POLLER poller;
+	POLLER_EVENT events[2];
+	int i, nready;
+	// "-shm" after the user name: talk to the server through shared memory
+	int use_shm = argc > 2 && strcmp(argv[2], "-shm") == 0;
+	SHM_CHANNEL * channel = NULL;
+	char shm_name[SHM_NAME_MAX];
+	int shm_active = 0;
+	if (poller_init(&poller) == -1 || poller_add(&poller, 0, POLLER_IN) == -1 ||
+	    poller_add(&poller, pipe_to_user[0], POLLER_IN) == -1) {
+		perror("Failed to watch input");
+		exit(-1);
+	}
 	// Signal handler for interrupt
 	void handle_interrupt(int sig) {
 		printf("%s\n","User interrupt");
-		if(write(pipe_to_server[1],"\\exit",sizeof("\\exit")) == -1){
+		if(frame_write(pipe_to_server[1],"\\exit",strlen("\\exit")) == -1){
 			perror("\nFailed to write to server");
 		}
 	}
 	// Signal handler for segfault
 	void handle_seg(int sig) {
-		if(write(pipe_to_server[1],"\\exit",sizeof("\\exit")) == -1){
+		if(frame_write(pipe_to_server[1],"\\exit",strlen("\\exit")) == -1){
 			perror("\nFailed to write to server");
 		}
 		printf("%s\n","Segmentation Fault");
@@ -56,32 +76,124 @@ void main(int argc, char * argv[]) {
 	}
 	signal(SIGINT,handle_interrupt);
 	signal(SIGSEGV,handle_seg);
-	while (1) {
-		// Poll for user input to server
-		nbytesfromstin = read(0,buf,sizeof(buf));
-		strtok(buf, "\n");
-		usleep(50);
-		if (nbytesfromstin > 0) {
-			if (strcmp(buf,"\\seg") == 0) {
-				memset(buf,'\0',MAX_MSG);
-				char *n=NULL;
-				*n=1;
-			}
-			if(write(pipe_to_server[1],buf,sizeof(buf)) == -1){
-				perror("\nFailed to write to server");
-			}
-			memset(buf,'\0',MAX_MSG);
-			print_prompt(username);
+	// Send a message, through the ring once the server has agreed to it
+	void send_to_server(char * text) {
+		if (shm_active) {
+			while (shm_ring_put(&channel->m_to_server, text, strlen(text)) == -1)
+				usleep(1000); // The server rings back when there is room, but typing can wait
+			if (shm_ring_wake_reader(&channel->m_to_server))
+				shm_doorbell(pipe_to_server[1]);
+		} else if (frame_write(pipe_to_server[1],text,strlen(text)) == -1) {
+			perror("\nFailed to write to server");
 		}
-		// Poll for messages from server and print to user
-		nbytesfrompipe = read(pipe_to_user[0],buf2,sizeof(buf2));
-		if (nbytesfrompipe > 0) {
-			printf("%s\n",buf2);
-			memset(buf2,'\0',MAX_MSG);
+	}
+	// Print every message waiting in the ring
+	void read_ring(void) {
+		while (shm_ring_get(&channel->m_to_user, &msg, &msglen) == 1) {
+			printf("%.*s\n", (int)msglen, msg);
 			print_prompt(username);
+			shm_ring_done(&channel->m_to_user, msglen);
 		}
-		usleep(200);
-
+		if (shm_ring_wake_writer(&channel->m_to_user))
+			shm_doorbell(pipe_to_server[1]);
+	}
+	// Answers to a request for shared memory
+	void handle_shm_answer(char * answer) {
+		if (strcmp(answer, SHM_ACCEPT) == 0) {
+			// The last message through the pipe; the ring carries the rest
+			if (frame_write(pipe_to_server[1],SHM_START,strlen(SHM_START)) == -1)
+				perror("\nFailed to write to server");
+			shm_active = 1;
+		} else {
+			shm_channel_close(channel);
+			shm_channel_unlink(shm_name);
+			channel = NULL;
+		}
+	}
+	frame_reader_init(&from_server);
+	if (use_shm) {
+		channel = shm_channel_create(shm_name);
+		if (channel == NULL) {
+			perror("Failed to create shared memory, using pipes");
+		} else {
+			char request[MAX_MSG];
+			snprintf(request, sizeof(request), "%s%s", SHM_COMMAND, shm_name);
+			if (frame_write(pipe_to_server[1],request,strlen(request)) == -1)
+				perror("\nFailed to write to server");
+		}
+	}
+	while (1) {
+		// Sleep until the user types something or the server sends a message
+		int timeout = -1;
+		if (shm_active && shm_ring_sleep(&channel->m_to_user) == 0)
+			timeout = 0; // More arrived in the ring meanwhile
+		nready = poller_wait(&poller, events, 2, timeout);
+		if (nready == -1) {
+			if (errno != EINTR)
+				perror("Failed to wait for input");
+			continue;
+		}
+		for (i = 0; i < nready; i++) {
+			if (events[i].m_fd == 0) {
+				// User input to server, one message per line
+				nbytesfromstin = read(0,buf + buflen,sizeof(buf) - 1 - buflen);
+				if (nbytesfromstin == 0 || (nbytesfromstin == -1 &&
+				    errno != EINTR && errno != EAGAIN)) {
+					// Stop watching a closed stdin, so the poller doesn't spin on it,
+					// and keep relaying the server's messages
+					poller_del(&poller, 0);
+					if (buflen > 0) {
+						send_to_server(buf); // The last line had no newline
+						buflen = 0;
+					}
+					continue;
+				} else if (nbytesfromstin < 0) {
+					continue;
+				}
+				buflen += nbytesfromstin;
+				buf[buflen] = '\0';
+				line = buf;
+				while ((newline = strchr(line, '\n')) != NULL ||
+				       (line == buf && buflen == sizeof(buf) - 1)) {
+					// A line that fills the buffer is sent as it is
+					if (newline != NULL)
+						*newline = '\0';
+					if (strcmp(line,"\\seg") == 0) {
+						char *n=NULL;
+						*n=1;
+					}
+					send_to_server(line);
+					print_prompt(username);
+					line = (newline != NULL) ? newline + 1 : buf + buflen;
+				}
+				// Keep the start of an unfinished line
+				buflen = strlen(line);
+				memmove(buf, line, buflen + 1);
+			} else {
+				// Messages from server, printed to user
+				nbytesfrompipe = frame_read(&from_server, pipe_to_user[0]);
+				if (nbytesfrompipe == 0) {
+					printf("\nServer closed the connection\n");
+					if (channel != NULL && !shm_active)
+						shm_channel_unlink(shm_name); // Never answered
+					exit(0);
+				}
+				while (frame_next(&from_server, &msg, &msglen) == 1) {
+					if (msglen == 0)
+						continue; // A doorbell for the ring
+					if (channel != NULL && !shm_active &&
+					    strncmp(msg, SHM_COMMAND, strlen(SHM_COMMAND)) == 0) {
+						handle_shm_answer(msg);
+						continue;
+					}
+					printf("%s\n",msg);
+					print_prompt(username);
+				}
+			}
+		}
+		// The pipe has been read first: it holds what the server sent before the ring
+		if (shm_active)
+			read_ring();
 	}
 	/* -------------- YOUR CODE ENDS HERE -----------------------------------*/
 }
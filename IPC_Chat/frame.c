@@ -0,0 +1,168 @@
+#include <errno.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/uio.h>
+#include "frame.h"
+
+// Bytes asked for per read()
+#define FRAME_READ_CHUNK 4096
+
+void frame_reader_init(FRAME_READER * reader) {
+  memset(reader, 0, sizeof(*reader));
+}
+
+void frame_reader_free(FRAME_READER * reader) {
+  free(reader->m_buf);
+  frame_reader_init(reader);
+}
+
+/*
+ * Put back the byte frame_next() replaced with a terminator
+ */
+static void restore_held(FRAME_READER * reader) {
+  if (reader->m_hold != NULL) {
+    *reader->m_hold = reader->m_held;
+    reader->m_hold = NULL;
+  }
+}
+
+ssize_t frame_read(FRAME_READER * reader, int fd) {
+  ssize_t nbytes;
+
+  restore_held(reader);
+  // Drop the frames already returned, then make room for another chunk
+  if (reader->m_start > 0) {
+    memmove(reader->m_buf, reader->m_buf + reader->m_start, reader->m_end - reader->m_start);
+    reader->m_end -= reader->m_start;
+    reader->m_start = 0;
+  }
+  if (reader->m_cap - reader->m_end < FRAME_READ_CHUNK) {
+    size_t cap = reader->m_cap ? 2 * reader->m_cap : 2 * FRAME_READ_CHUNK;
+    char * buf = realloc(reader->m_buf, cap);
+    if (buf == NULL) {
+      return -1;
+    }
+    reader->m_buf = buf;
+    reader->m_cap = cap;
+  }
+  do {
+    nbytes = read(fd, reader->m_buf + reader->m_end, reader->m_cap - reader->m_end);
+  } while (nbytes == -1 && errno == EINTR);
+  if (nbytes > 0) {
+    reader->m_end += nbytes;
+  }
+  return nbytes;
+}
+
+int frame_next(FRAME_READER * reader, char ** msg, size_t * len) {
+  unsigned char * header;
+  size_t length;
+
+  restore_held(reader);
+  if (reader->m_end - reader->m_start < FRAME_HEADER) {
+    return 0;
+  }
+  header = (unsigned char *)reader->m_buf + reader->m_start;
+  length = ((size_t)header[0] << 24) | ((size_t)header[1] << 16) |
+           ((size_t)header[2] << 8) | (size_t)header[3];
+  if (length > FRAME_MAX) {
+    return -1;
+  }
+  // Wait for the rest of the frame
+  if (reader->m_end - reader->m_start - FRAME_HEADER < length) {
+    return 0;
+  }
+  *msg = reader->m_buf + reader->m_start + FRAME_HEADER;
+  *len = length;
+  reader->m_start += FRAME_HEADER + length;
+  if (reader->m_start == reader->m_cap) {
+    // The frame ends the buffer, so there is no room for the terminator
+    char * buf = realloc(reader->m_buf, reader->m_cap + FRAME_READ_CHUNK);
+    if (buf == NULL) {
+      return -1;
+    }
+    *msg = buf + (*msg - reader->m_buf);
+    reader->m_buf = buf;
+    reader->m_cap += FRAME_READ_CHUNK;
+  }
+  reader->m_hold = *msg + length;
+  reader->m_held = *reader->m_hold;
+  *reader->m_hold = '\0';
+  return 1;
+}
+
+void frame_header(char * header, size_t len) {
+  header[0] = (char)((len >> 24) & 0xff);
+  header[1] = (char)((len >> 16) & 0xff);
+  header[2] = (char)((len >> 8) & 0xff);
+  header[3] = (char)(len & 0xff);
+}
+
+/*
+ * Wait until fd can take more bytes
+ */
+static int wait_writable(int fd) {
+  struct pollfd pfd;
+  pfd.fd = fd;
+  pfd.events = POLLOUT;
+  pfd.revents = 0;
+  while (poll(&pfd, 1, -1) == -1) {
+    if (errno != EINTR) {
+      return -1;
+    }
+  }
+  return 0;
+}
+
+/*
+ * Write the iovecs completely, advancing them past partial writes
+ */
+static int writev_all(int fd, struct iovec * iov, int iovcnt) {
+  while (iovcnt > 0) {
+    ssize_t nbytes = writev(fd, iov, iovcnt);
+    if (nbytes == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if ((errno == EAGAIN || errno == EWOULDBLOCK) && wait_writable(fd) == 0) {
+        continue;
+      }
+      return -1;
+    }
+    while (iovcnt > 0 && (size_t)nbytes >= iov->iov_len) {
+      nbytes -= iov->iov_len;
+      iov++;
+      iovcnt--;
+    }
+    if (iovcnt > 0) {
+      iov->iov_base = (char *)iov->iov_base + nbytes;
+      iov->iov_len -= nbytes;
+    }
+  }
+  return 0;
+}
+
+int write_all(int fd, const char * buf, size_t len) {
+  struct iovec iov;
+  iov.iov_base = (void *)buf;
+  iov.iov_len = len;
+  return writev_all(fd, &iov, 1);
+}
+
+int frame_write(int fd, const char * msg, size_t len) {
+  char header[FRAME_HEADER];
+  struct iovec iov[2];
+
+  if (len > FRAME_MAX) {
+    errno = EMSGSIZE;
+    return -1;
+  }
+  frame_header(header, len);
+  iov[0].iov_base = header;
+  iov[0].iov_len = FRAME_HEADER;
+  iov[1].iov_base = (void *)msg;
+  iov[1].iov_len = len;
+  return writev_all(fd, iov, 2);
+}
@@ -0,0 +1,62 @@
+#ifndef FRAME_H
+#define FRAME_H
+
+#include <stddef.h>
+#include <sys/types.h>
+
+/*
+ * Messages travel through the pipes as frames: a 4 byte length, most
+ * significant byte first, followed by that many bytes of text (no
+ * terminator). A pipe is a byte stream, so one read() may return part of a
+ * frame or several frames; FRAME_READER puts them back together.
+ */
+
+#define FRAME_HEADER 4
+// Longest frame accepted, to bound the memory a reader will allocate
+#define FRAME_MAX (1 << 20)
+
+typedef struct _frameReader {
+  char * m_buf;
+  size_t m_start;   // first byte not yet returned by frame_next()
+  size_t m_end;     // end of the bytes read so far
+  size_t m_cap;
+  // frame_next() terminates the message in place; the byte it overwrote
+  char * m_hold;
+  char m_held;
+} FRAME_READER;
+
+void frame_reader_init(FRAME_READER * reader);
+void frame_reader_free(FRAME_READER * reader);
+
+/*
+ * Read what is available on fd into the reader. Returns the number of bytes
+ * read, 0 at end of file, or -1 on error (including EAGAIN on a
+ * non-blocking fd).
+ */
+ssize_t frame_read(FRAME_READER * reader, int fd);
+
+/*
+ * Take the next complete message from the reader. Returns 1 and points
+ * *msg at the NUL terminated text (valid until the next frame_read() or
+ * frame_next()), 0 if no whole frame has arrived yet, or -1 if the frame is
+ * longer than FRAME_MAX.
+ */
+int frame_next(FRAME_READER * reader, char ** msg, size_t * len);
+
+/*
+ * Write the header of a len byte frame to header[FRAME_HEADER].
+ */
+void frame_header(char * header, size_t len);
+
+/*
+ * Write len bytes, continuing after partial writes. On a non-blocking fd,
+ * waits for it to become writable. Returns 0, or -1 on error.
+ */
+int write_all(int fd, const char * buf, size_t len);
+
+/*
+ * Write one message as a frame. Returns 0, or -1 on error.
+ */
+int frame_write(int fd, const char * msg, size_t len);
+
+#endif
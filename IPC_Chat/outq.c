@@ -0,0 +1,126 @@
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/uio.h>
+#include "frame.h"
+#include "outq.h"
+
+// Messages handed to a single writev()
+#define OUTQ_IOV 64
+
+MSG_BUF * msg_buf_new(const char * prefix, const char * text) {
+  size_t prefix_len = prefix ? strlen(prefix) : 0;
+  size_t text_len = strlen(text);
+  MSG_BUF * msg = malloc(sizeof(MSG_BUF) + FRAME_HEADER + prefix_len + text_len);
+  if (msg == NULL) {
+    return NULL;
+  }
+  msg->m_refs = 1;
+  msg->m_len = FRAME_HEADER + prefix_len + text_len;
+  frame_header(msg->m_data, prefix_len + text_len);
+  memcpy(msg->m_data + FRAME_HEADER, prefix, prefix_len);
+  memcpy(msg->m_data + FRAME_HEADER + prefix_len, text, text_len);
+  return msg;
+}
+
+MSG_BUF * msg_buf_ref(MSG_BUF * msg) {
+  msg->m_refs++;
+  return msg;
+}
+
+void msg_buf_unref(MSG_BUF * msg) {
+  if (msg != NULL && --msg->m_refs == 0) {
+    free(msg);
+  }
+}
+
+void outq_init(OUT_QUEUE * queue) {
+  memset(queue, 0, sizeof(*queue));
+}
+
+void outq_clear(OUT_QUEUE * queue) {
+  int i;
+  for (i = 0; i < queue->m_count; i++) {
+    msg_buf_unref(queue->m_msgs[(queue->m_head + i) % queue->m_cap]);
+  }
+  free(queue->m_msgs);
+  outq_init(queue);
+}
+
+int outq_push(OUT_QUEUE * queue, MSG_BUF * msg) {
+  if (queue->m_count == OUTQ_MAX) {
+    queue->m_dropped++;
+    return -1;
+  }
+  if (queue->m_count == queue->m_cap) {
+    // Grow the ring, unwrapping it into the new array
+    int i, cap = queue->m_cap ? 2 * queue->m_cap : 8;
+    MSG_BUF ** msgs = malloc(cap * sizeof(MSG_BUF *));
+    if (msgs == NULL) {
+      queue->m_dropped++;
+      return -1;
+    }
+    for (i = 0; i < queue->m_count; i++) {
+      msgs[i] = queue->m_msgs[(queue->m_head + i) % queue->m_cap];
+    }
+    free(queue->m_msgs);
+    queue->m_msgs = msgs;
+    queue->m_head = 0;
+    queue->m_cap = cap;
+  }
+  queue->m_msgs[(queue->m_head + queue->m_count) % queue->m_cap] = msg_buf_ref(msg);
+  queue->m_count++;
+  return 0;
+}
+
+int outq_flush(OUT_QUEUE * queue, int fd) {
+  struct iovec iov[OUTQ_IOV];
+  int i, n;
+  ssize_t nbytes;
+
+  while (queue->m_count > 0) {
+    // Gather the queued frames, skipping what was written of the first one
+    n = queue->m_count < OUTQ_IOV ? queue->m_count : OUTQ_IOV;
+    for (i = 0; i < n; i++) {
+      MSG_BUF * msg = queue->m_msgs[(queue->m_head + i) % queue->m_cap];
+      iov[i].iov_base = msg->m_data;
+      iov[i].iov_len = msg->m_len;
+    }
+    iov[0].iov_base = (char *)iov[0].iov_base + queue->m_offset;
+    iov[0].iov_len -= queue->m_offset;
+
+    nbytes = writev(fd, iov, n);
+    if (nbytes == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
+    }
+    // Release the messages written completely
+    for (i = 0; i < n && (size_t)nbytes >= iov[i].iov_len; i++) {
+      nbytes -= iov[i].iov_len;
+      msg_buf_unref(queue->m_msgs[queue->m_head]);
+      queue->m_head = (queue->m_head + 1) % queue->m_cap;
+      queue->m_count--;
+      queue->m_offset = 0;
+    }
+    if (i < n) {
+      queue->m_offset += nbytes;
+      return 0;
+    }
+  }
+  return 1;
+}
+
+MSG_BUF * outq_peek(OUT_QUEUE * queue) {
+  return queue->m_count > 0 ? queue->m_msgs[queue->m_head] : NULL;
+}
+
+void outq_pop(OUT_QUEUE * queue) {
+  if (queue->m_count > 0) {
+    msg_buf_unref(queue->m_msgs[queue->m_head]);
+    queue->m_head = (queue->m_head + 1) % queue->m_cap;
+    queue->m_count--;
+    queue->m_offset = 0;
+  }
+}
@@ -0,0 +1,67 @@
+#ifndef OUTQ_H
+#define OUTQ_H
+
+#include <stddef.h>
+
+/*
+ * Messages waiting to be written to a user's pipe.
+ *
+ * A message is formatted into a frame once, in a reference counted MSG_BUF,
+ * and the same buffer is queued for every recipient. Each OUT_QUEUE holds
+ * at most OUTQ_MAX messages: a user that stops reading loses messages
+ * instead of holding up the server.
+ */
+
+#define OUTQ_MAX 1024
+
+typedef struct _msgBuf {
+  int m_refs;
+  size_t m_len;     // bytes in m_data
+  char m_data[];    // the whole frame: header, then text
+} MSG_BUF;
+
+/*
+ * A new buffer holding the frame for prefix followed by text (prefix may be
+ * NULL), with one reference. Returns NULL if out of memory.
+ */
+MSG_BUF * msg_buf_new(const char * prefix, const char * text);
+MSG_BUF * msg_buf_ref(MSG_BUF * msg);
+void msg_buf_unref(MSG_BUF * msg);
+
+typedef struct _outQueue {
+  MSG_BUF ** m_msgs;  // ring of m_cap entries
+  int m_head;
+  int m_count;
+  int m_cap;
+  size_t m_offset;    // bytes of the head message already written
+  int m_dropped;      // messages refused because the queue was full
+} OUT_QUEUE;
+
+void outq_init(OUT_QUEUE * queue);
+
+/*
+ * Drop every queued message and free the queue.
+ */
+void outq_clear(OUT_QUEUE * queue);
+
+/*
+ * Queue a reference to msg. Returns 0, or -1 if the queue is full (or out
+ * of memory) and the message was dropped.
+ */
+int outq_push(OUT_QUEUE * queue, MSG_BUF * msg);
+
+/*
+ * Write as much of the queue as fd will take without blocking, several
+ * messages per writev(). Returns 1 once the queue is empty, 0 if fd is full
+ * and messages remain, or -1 on error.
+ */
+int outq_flush(OUT_QUEUE * queue, int fd);
+
+/*
+ * The oldest queued message, or NULL if the queue is empty, for a caller
+ * that delivers messages some other way; outq_pop() then removes it.
+ */
+MSG_BUF * outq_peek(OUT_QUEUE * queue);
+void outq_pop(OUT_QUEUE * queue);
+
+#endif
@@ -0,0 +1,154 @@
+#include <errno.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "poller.h"
+
+#ifdef USE_EPOLL
+#include <sys/epoll.h>
+
+static unsigned int to_epoll(int events) {
+  return ((events & POLLER_IN) ? EPOLLIN : 0) | ((events & POLLER_OUT) ? EPOLLOUT : 0);
+}
+#else
+/*
+ * Index of fd in the poll() set, or -1
+ */
+static int find_fd(POLLER * poller, int fd) {
+  int i;
+  for (i = 0; i < poller->m_nfds; i++) {
+    if (poller->m_fds[i].fd == fd) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+static short to_poll(int events) {
+  return ((events & POLLER_IN) ? POLLIN : 0) | ((events & POLLER_OUT) ? POLLOUT : 0);
+}
+#endif
+
+int poller_init(POLLER * poller) {
+  memset(poller, 0, sizeof(*poller));
+  poller->m_epfd = -1;
+#ifdef USE_EPOLL
+  poller->m_epfd = epoll_create1(EPOLL_CLOEXEC);
+  if (poller->m_epfd == -1) {
+    return -1;
+  }
+#endif
+  return 0;
+}
+
+int poller_add(POLLER * poller, int fd, int events) {
+#ifdef USE_EPOLL
+  struct epoll_event ev;
+  memset(&ev, 0, sizeof(ev));
+  ev.events = to_epoll(events);
+  ev.data.fd = fd;
+  return epoll_ctl(poller->m_epfd, EPOLL_CTL_ADD, fd, &ev);
+#else
+  if (poller->m_nfds == poller->m_cap) {
+    int cap = poller->m_cap ? poller->m_cap * 2 : 16;
+    struct pollfd * fds = realloc(poller->m_fds, cap * sizeof(*fds));
+    if (fds == NULL) {
+      return -1;
+    }
+    poller->m_fds = fds;
+    poller->m_cap = cap;
+  }
+  poller->m_fds[poller->m_nfds].fd = fd;
+  poller->m_fds[poller->m_nfds].events = to_poll(events);
+  poller->m_fds[poller->m_nfds].revents = 0;
+  poller->m_nfds++;
+  return 0;
+#endif
+}
+
+int poller_mod(POLLER * poller, int fd, int events) {
+#ifdef USE_EPOLL
+  struct epoll_event ev;
+  memset(&ev, 0, sizeof(ev));
+  ev.events = to_epoll(events);
+  ev.data.fd = fd;
+  return epoll_ctl(poller->m_epfd, EPOLL_CTL_MOD, fd, &ev);
+#else
+  int i = find_fd(poller, fd);
+  if (i == -1) {
+    errno = ENOENT;
+    return -1;
+  }
+  poller->m_fds[i].events = to_poll(events);
+  return 0;
+#endif
+}
+
+int poller_del(POLLER * poller, int fd) {
+#ifdef USE_EPOLL
+  struct epoll_event ev;
+  return epoll_ctl(poller->m_epfd, EPOLL_CTL_DEL, fd, &ev);
+#else
+  // Move the last entry into the hole
+  int i = find_fd(poller, fd);
+  if (i == -1) {
+    errno = ENOENT;
+    return -1;
+  }
+  poller->m_fds[i] = poller->m_fds[--poller->m_nfds];
+  return 0;
+#endif
+}
+
+int poller_wait(POLLER * poller, POLLER_EVENT * events, int max_events, int timeout_ms) {
+  int i, n = 0;
+#ifdef USE_EPOLL
+  struct epoll_event ready[64];
+  int nready = epoll_wait(poller->m_epfd, ready,
+                          max_events < 64 ? max_events : 64, timeout_ms);
+  if (nready == -1) {
+    return -1;
+  }
+  for (i = 0; i < nready; i++) {
+    events[n].m_fd = ready[i].data.fd;
+    events[n].m_events = 0;
+    if (ready[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+      events[n].m_events |= POLLER_IN;
+    }
+    if (ready[i].events & EPOLLOUT) {
+      events[n].m_events |= POLLER_OUT;
+    }
+    n++;
+  }
+#else
+  if (poll(poller->m_fds, poller->m_nfds, timeout_ms) == -1) {
+    return -1;
+  }
+  for (i = 0; i < poller->m_nfds && n < max_events; i++) {
+    short revents = poller->m_fds[i].revents;
+    if (revents == 0) {
+      continue;
+    }
+    events[n].m_fd = poller->m_fds[i].fd;
+    events[n].m_events = 0;
+    if (revents & (POLLIN | POLLHUP | POLLERR)) {
+      events[n].m_events |= POLLER_IN;
+    }
+    if (revents & POLLOUT) {
+      events[n].m_events |= POLLER_OUT;
+    }
+    n++;
+  }
+#endif
+  return n;
+}
+
+void poller_close(POLLER * poller) {
+  if (poller->m_epfd != -1) {
+    close(poller->m_epfd);
+  }
+  free(poller->m_fds);
+  memset(poller, 0, sizeof(*poller));
+  poller->m_epfd = -1;
+}
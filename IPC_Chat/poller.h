@@ -0,0 +1,47 @@
+#ifndef POLLER_H
+#define POLLER_H
+
+/*
+ * Waits until any of a set of file descriptors is ready, using epoll where it
+ * is available and poll() otherwise (or when built with -DNO_EPOLL).
+ */
+
+#if defined(__linux__) && !defined(NO_EPOLL)
+#define USE_EPOLL
+#endif
+
+// Interest/readiness flags
+#define POLLER_IN  0x1
+#define POLLER_OUT 0x2
+
+typedef struct _pollerEvent {
+  int m_fd;
+  int m_events; // POLLER_IN and/or POLLER_OUT. A hangup or error is reported
+                // as POLLER_IN, so that the next read() sees it.
+} POLLER_EVENT;
+
+typedef struct _poller {
+  int m_epfd;             // epoll instance, or -1 with poll()
+  struct pollfd * m_fds;  // watched descriptors with poll()
+  int m_nfds;
+  int m_cap;
+} POLLER;
+
+/*
+ * All functions return 0 (or the number of events for poller_wait) on
+ * success, and -1 with errno set on failure.
+ */
+int poller_init(POLLER * poller);
+int poller_add(POLLER * poller, int fd, int events);
+int poller_mod(POLLER * poller, int fd, int events);
+int poller_del(POLLER * poller, int fd);
+
+/*
+ * Block until at least one descriptor is ready or timeout_ms has passed
+ * (-1 waits forever). Fills up to max_events events and returns how many.
+ */
+int poller_wait(POLLER * poller, POLLER_EVENT * events, int max_events, int timeout_ms);
+
+void poller_close(POLLER * poller);
+
+#endif
@@ -3,94 +3,429 @@
 #include <errno.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/resource.h>
 #include <sys/wait.h>
 #include "comm.h"
+#include "frame.h"
+#include "outq.h"
+#include "poller.h"
+#include "shmring.h"
 #include "util.h"
 
+// How often (in ms) the idle server checks the connection point for new users
+#define CONNECT_POLL_MS 100
+
+// Watches the server shell and the pipes from every user
+POLLER server_poller;
+
+/*
+ * Whether the server talks to the users' pipes itself (-s), rather than
+ * through a relay process forked for each user.
+ */
+int single_process = 0;
+
+/*
+ * A user that asked to talk through shared memory (see shmring.h)
+ */
+typedef struct _shmLink {
+  SHM_CHANNEL * m_channel;  // NULL while the user only uses pipes
+  int m_sending;            // messages to the user go through the ring
+  int m_receiving;          // messages from the user come through the ring
+  OUT_QUEUE m_queue;        // messages waiting for room in the ring
+} SHM_LINK;
+
+/*
+ * The user table. It starts with MAX_USER slots and doubles whenever it is
+ * full, so the number of users is only limited by file descriptors.
+ *
+ * Users are found by name through a hash index, empty slots are kept on a
+ * stack and full ones in a dense list, so that joining, leaving and looking
+ * a user up take constant time however big the table is.
+ */
+typedef struct _userTable {
+  USER * m_list;
+  int m_size;       // number of slots in m_list
+  FRAME_READER * m_readers; // partly received frames from each slot
+  OUT_QUEUE * m_queues;     // messages waiting for room in each slot's pipe
+  SHM_LINK * m_shm;         // shared memory transport of each slot
+  int * m_fd_slot;  // slot of the user each of the server's fds belongs to, or -1
+  int m_fd_size;
+  int * m_index;    // open addressing hash of user id to slot, -1 where unused
+  int m_index_size; // a power of two, at least twice m_size
+  int * m_free;     // stack of the empty slots
+  int m_nfree;
+  int * m_active;   // the full slots, in no particular order
+  int * m_active_pos; // where each full slot is in m_active
+  int m_nactive;
+} USER_TABLE;
+
 /* -----------Functions that implement server functionality -------------------------*/
 
+/*
+ * FNV-1a hash of a user id
+ */
+unsigned int hash_user_id(const char * user_id)
+{
+	unsigned int hash = 2166136261u;
+	for (; *user_id != '\0'; user_id++) {
+		hash ^= (unsigned char)*user_id;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+/*
+ * Add the user in slot idx to the hash index
+ */
+void index_insert(USER_TABLE * users, int idx)
+{
+	unsigned int mask = users->m_index_size - 1;
+	unsigned int i = hash_user_id(users->m_list[idx].m_user_id) & mask;
+	while (users->m_index[i] != -1)
+		i = (i + 1) & mask;
+	users->m_index[i] = idx;
+}
+
+/*
+ * Remove the user in slot idx from the hash index. The entries after it that
+ * had probed past it are shifted back, so lookups never need tombstones.
+ */
+void index_remove(USER_TABLE * users, int idx)
+{
+	unsigned int mask = users->m_index_size - 1;
+	unsigned int i = hash_user_id(users->m_list[idx].m_user_id) & mask;
+	unsigned int j, home;
+
+	while (users->m_index[i] != idx) {
+		if (users->m_index[i] == -1)
+			return;
+		i = (i + 1) & mask;
+	}
+	for (j = (i + 1) & mask; users->m_index[j] != -1; j = (j + 1) & mask) {
+		home = hash_user_id(users->m_list[users->m_index[j]].m_user_id) & mask;
+		// Move the entry into the hole if the hole lies between its home and j
+		if (((j - home) & mask) >= ((j - i) & mask)) {
+			users->m_index[i] = users->m_index[j];
+			i = j;
+		}
+	}
+	users->m_index[i] = -1;
+}
+
+/*
+ * Grow the table to size slots (from m_size, which may be 0), marking the
+ * new slots empty and rebuilding the hash index. Returns 0, or -1 on failure.
+ */
+int resize_user_table(USER_TABLE * users, int size)
+{
+	int i, index_size = 1;
+	while (index_size < 2 * size)
+		index_size *= 2;
+
+	USER * list = realloc(users->m_list, size * sizeof(USER));
+	if (list != NULL)
+		users->m_list = list;
+	FRAME_READER * readers = realloc(users->m_readers, size * sizeof(FRAME_READER));
+	if (readers != NULL)
+		users->m_readers = readers;
+	OUT_QUEUE * queues = realloc(users->m_queues, size * sizeof(OUT_QUEUE));
+	if (queues != NULL)
+		users->m_queues = queues;
+	SHM_LINK * shm = realloc(users->m_shm, size * sizeof(SHM_LINK));
+	if (shm != NULL)
+		users->m_shm = shm;
+	int * free_slots = realloc(users->m_free, size * sizeof(int));
+	if (free_slots != NULL)
+		users->m_free = free_slots;
+	int * active = realloc(users->m_active, size * sizeof(int));
+	if (active != NULL)
+		users->m_active = active;
+	int * active_pos = realloc(users->m_active_pos, size * sizeof(int));
+	if (active_pos != NULL)
+		users->m_active_pos = active_pos;
+	int * index = malloc(index_size * sizeof(int));
+	if (list == NULL || readers == NULL || queues == NULL || shm == NULL || free_slots == NULL ||
+	    active == NULL || active_pos == NULL || index == NULL) {
+		free(index);
+		return -1;
+	}
+
+	for (i = users->m_size; i < size; i++) {
+		users->m_list[i].m_pid = -1;
+		memset(users->m_list[i].m_user_id, '\0', MAX_USER_ID);
+		users->m_list[i].m_fd_to_user = -1;
+		users->m_list[i].m_fd_to_server = -1;
+		users->m_list[i].m_status = SLOT_EMPTY;
+		frame_reader_init(&users->m_readers[i]);
+		outq_init(&users->m_queues[i]);
+		memset(&users->m_shm[i], 0, sizeof(SHM_LINK));
+	}
+	// Stack the new slots so the lowest is handed out first
+	for (i = size - 1; i >= users->m_size; i--)
+		users->m_free[users->m_nfree++] = i;
+	users->m_size = size;
+
+	free(users->m_index);
+	users->m_index = index;
+	users->m_index_size = index_size;
+	for (i = 0; i < index_size; i++)
+		users->m_index[i] = -1;
+	for (i = 0; i < users->m_nactive; i++)
+		index_insert(users, users->m_active[i]);
+	return 0;
+}
+
 /*
  * Returns the empty slot on success, or -1 on failure
  */
-int find_empty_slot(USER * user_list) {
+int find_empty_slot(USER_TABLE * users) {
 	/*
-   * Iterate through the user_list and check m_status to see if any slot is EMPTY
-	 * Return the index of the empty slot
+	 * Return the empty slot on top of the free stack; add_user() takes it off
+	 * If every slot is full, double the table
    */
-    int i = 0;
-	for(i=0;i<MAX_USER;i++) {
-    	if(user_list[i].m_status == SLOT_EMPTY) {
-			return i;
-		}
+	if (users->m_nfree == 0 && resize_user_table(users, 2 * users->m_size) == -1) {
+		perror("\nCouldn't grow user table\n");
+		return -1;
 	}
-	return -1;
+	return users->m_free[users->m_nfree - 1];
+}
+
+/*
+ * Append str to the growable buffer *buf holding *len characters in *cap
+ * bytes, keeping it NUL terminated. Returns 0, or -1 if out of memory.
+ */
+int append_str(char ** buf, size_t * len, size_t * cap, const char * str)
+{
+	size_t str_len = strlen(str);
+	if (*len + str_len + 1 > *cap) {
+		size_t new_cap = *cap ? *cap : MAX_MSG;
+		while (*len + str_len + 1 > new_cap)
+			new_cap *= 2;
+		char * new_buf = realloc(*buf, new_cap);
+		if (new_buf == NULL)
+			return -1;
+		*buf = new_buf;
+		*cap = new_cap;
+	}
+	memcpy(*buf + *len, str, str_len + 1);
+	*len += str_len;
+	return 0;
+}
+
+/*
+ * Write what is queued for the user in slot idx without blocking. While
+ * messages remain, the pipe is watched for room; the pipe is watched exactly
+ * when the queue is not empty.
+ */
+void flush_user(int idx, USER_TABLE * users)
+{
+  USER * user_list = users->m_list;
+  OUT_QUEUE * queue = &users->m_queues[idx];
+  int ret = outq_flush(queue, user_list[idx].m_fd_to_user);
+
+  if (ret == 0)
+    return;
+  if (ret == -1) {
+    // The read side notices a user that has gone away and kicks them
+    perror("\nCouldn't write to pipe\n");
+    outq_clear(queue);
+  }
+  poller_del(&server_poller, user_list[idx].m_fd_to_user);
+  if (queue->m_dropped > 0) {
+    printf("\nThe user: %s missed %d messages\n", user_list[idx].m_user_id, queue->m_dropped);
+    print_prompt("admin");
+    queue->m_dropped = 0;
+  }
+}
+
+/*
+ * Wake the user in slot idx, asleep waiting for its ring. Not needed while
+ * messages are queued for its pipe, which will wake it anyway; the doorbell
+ * must not land in the middle of one of them either.
+ */
+void ring_doorbell(int idx, USER_TABLE * users)
+{
+  if (users->m_queues[idx].m_count == 0)
+    shm_doorbell(users->m_list[idx].m_fd_to_user);
+}
+
+/*
+ * Move what is queued for the ring of the user in slot idx into it, as far
+ * as there is room. The user rings back once it has made more.
+ */
+void flush_ring(int idx, USER_TABLE * users)
+{
+  SHM_LINK * link = &users->m_shm[idx];
+  SHM_RING * ring = &link->m_channel->m_to_user;
+  MSG_BUF * msg;
+  int sent = 0;
+
+  while ((msg = outq_peek(&link->m_queue)) != NULL &&
+         shm_ring_put(ring, msg->m_data + FRAME_HEADER, msg->m_len - FRAME_HEADER) == 0) {
+    outq_pop(&link->m_queue);
+    sent = 1;
+  }
+  if (sent && shm_ring_wake_reader(ring))
+    ring_doorbell(idx, users);
+  if (link->m_queue.m_count == 0 && link->m_queue.m_dropped > 0) {
+    printf("\nThe user: %s missed %d messages\n", users->m_list[idx].m_user_id, link->m_queue.m_dropped);
+    print_prompt("admin");
+    link->m_queue.m_dropped = 0;
+  }
+}
+
+/*
+ * Send a formatted message through the ring of the user in slot idx,
+ * queueing it if the ring is full
+ */
+void send_ring(int idx, USER_TABLE * users, MSG_BUF * msg)
+{
+  SHM_LINK * link = &users->m_shm[idx];
+  SHM_RING * ring = &link->m_channel->m_to_user;
+
+  if (link->m_queue.m_count == 0 &&
+      shm_ring_put(ring, msg->m_data + FRAME_HEADER, msg->m_len - FRAME_HEADER) == 0) {
+    if (shm_ring_wake_reader(ring))
+      ring_doorbell(idx, users);
+    return;
+  }
+  // A message the ring can never hold would hold up the queue for good
+  if (msg->m_len > SHM_RING_SIZE / 2) {
+    link->m_queue.m_dropped++;
+    return;
+  }
+  outq_push(&link->m_queue, msg);
+}
+
+/*
+ * Send a formatted message to the user in slot idx. A user whose pipe is
+ * full gets the message queued instead of holding up the server, and misses
+ * it if OUTQ_MAX messages are already waiting.
+ */
+void send_msg(int idx, USER_TABLE * users, MSG_BUF * msg)
+{
+  OUT_QUEUE * queue = &users->m_queues[idx];
+  int fd = users->m_list[idx].m_fd_to_user;
+  int ret;
+
+  if (users->m_shm[idx].m_sending) {
+    send_ring(idx, users, msg);
+    return;
+  }
+
+  if (queue->m_count > 0) {
+    // Already waiting for room; keep the messages in order
+    outq_push(queue, msg);
+    return;
+  }
+  if (outq_push(queue, msg) == -1)
+    return;
+  ret = outq_flush(queue, fd);
+  if (ret == 0) {
+    if (poller_add(&server_poller, fd, POLLER_OUT) == -1)
+      perror("\nCouldn't watch user pipe\n");
+  } else if (ret == -1) {
+    perror("\nCouldn't write to pipe\n");
+    outq_clear(queue);
+  }
+}
+
+/*
+ * Send text to the user in slot idx
+ */
+void send_text(int idx, USER_TABLE * users, const char * text)
+{
+  MSG_BUF * msg = msg_buf_new(NULL, text);
+  if (msg == NULL) {
+    perror("\nCouldn't allocate message\n");
+    return;
+  }
+  send_msg(idx, users, msg);
+  msg_buf_unref(msg);
 }
 
 /*
  * List the existing users on the server shell
  */
-int list_users(int idx, USER * user_list)
+int list_users(int idx, USER_TABLE * users)
 {
 	/*
-   * Iterate through the user list
-	 * If you find any slot which is not empty, print that m_user_id
-	 * If every slot is empty, print "<no users>""
+   * Go through the full slots, appending each m_user_id to the list
+	 * If there are none, the list is "<no users>"
 	 * If the function is called by the server (that is, idx is -1), then printf the list
-	 * If the function is called by the user, then send the list to the user using write() and passing m_fd_to_user
-	 * Return 0 on success
+	 * If the function is called by the user, then send the list to the user
+	 * Return 0 on success, or -1 if the list couldn't be built
    */
-	int i, flag = 0;
-	char buf[MAX_MSG] = {}, *s = NULL;
-
-	// Construct a list of user names
-	s = buf;
-	strncpy(s, "---connected user list---\n", strlen("---connected user list---\n"));
-	s += strlen("---connected user list---\n");
-	for (i = 0; i < MAX_USER; i++) {
-		if (user_list[i].m_status == SLOT_EMPTY)
-			continue;
-		flag = 1;
-		strncpy(s, user_list[i].m_user_id, strlen(user_list[i].m_user_id));
-		s = s + strlen(user_list[i].m_user_id);
-		strncpy(s, "\n", 1);
-		s++;
-	}
+	int i, err = 0;
+	char * buf = NULL;
+	size_t len = 0, cap = 0;
+	USER * user_list = users->m_list;
 
-  // Test whether any users were found
-	if (flag == 0) {
-		strcpy(buf, "<no users>\n");
+	// Construct a list of user names, one per line
+	if (users->m_nactive == 0) {
+		err = append_str(&buf, &len, &cap, "<no users>\n");
 	} else {
-		s--;
-		strncpy(s, "\0", 1);
+		err = append_str(&buf, &len, &cap, "---connected user list---");
+		for (i = 0; i < users->m_nactive && err == 0; i++) {
+			err = append_str(&buf, &len, &cap, "\n");
+			if (err == 0)
+				err = append_str(&buf, &len, &cap, user_list[users->m_active[i]].m_user_id);
+		}
+	}
+	if (err == -1) {
+		free(buf);
+		return -1;
 	}
 
   // Check if the index passed was out of bounds, otherwise pass the user list
 	if(idx < 0) {
     printf("%s\n",buf);
 	} else {
-		// Write to the given pipe fd
-		if (write(user_list[idx].m_fd_to_user, buf, strlen(buf) + 1) < 0)
-			perror("writing to server shell");
+		// Queue for the given user
+		send_text(idx, users, buf);
 	}
 
+	free(buf);
 	return 0;
 }
 
 /*
  * Add a new user
  */
-int add_user(int idx, USER * user_list, int pid, char * user_id, int pipe_to_child, int pipe_to_parent)
+int add_user(int idx, USER_TABLE * users, int pid, char * user_id, int pipe_to_child, int pipe_to_parent)
 {
   /*
    * Populate the user_list structure with the arguments passed to this function
    * Return the index of user added
    */
+  USER * user_list = users->m_list;
+  // Map both of the user's fds back to the slot
+  int max_fd = pipe_to_parent > pipe_to_child ? pipe_to_parent : pipe_to_child;
+  if (max_fd >= users->m_fd_size) {
+    int size = users->m_fd_size, new_size = 2 * max_fd + 1;
+    int * fd_slot = realloc(users->m_fd_slot, new_size * sizeof(int));
+    if (fd_slot == NULL) {
+      perror("\nCouldn't grow user table\n");
+      return -1;
+    }
+    for (; size < new_size; size++)
+      fd_slot[size] = -1;
+    users->m_fd_slot = fd_slot;
+    users->m_fd_size = new_size;
+  }
+  users->m_fd_slot[pipe_to_parent] = idx;
+  users->m_fd_slot[pipe_to_child] = idx;
   user_list[idx].m_pid = pid;
   strncpy(user_list[idx].m_user_id,user_id, strlen(user_id));
   user_list[idx].m_fd_to_user = pipe_to_child;
   user_list[idx].m_fd_to_server = pipe_to_parent;
   user_list[idx].m_status = SLOT_FULL;
   user_list[idx].m_pid = pid;
+  // idx came from the top of the free stack (find_empty_slot)
+  users->m_nfree--;
+  users->m_active_pos[idx] = users->m_nactive;
+  users->m_active[users->m_nactive++] = idx;
+  index_insert(users, idx);
 
 
 	return idx;
@@ -99,11 +434,16 @@ int add_user(int idx, USER * user_list, int pid, char * user_id, int pipe_to_chi
 /*
  * Kill a user
  */
-void kill_user(int idx, USER * user_list) {
+void kill_user(int idx, USER_TABLE * users) {
 	/*
    * Kill a user (specified by idx) by using the systemcall kill()
 	 * Wait until the process has been terminated
+	 * Users served directly have no relay process: closing their pipes in
+	 * cleanup_user() is what disconnects them
    */
+  USER * user_list = users->m_list;
+  if (user_list[idx].m_pid <= 0)
+    return;
   kill(user_list[idx].m_pid,SIGKILL);
   waitpid(user_list[idx].m_pid,NULL,0);
 }
@@ -111,7 +451,7 @@ void kill_user(int idx, USER * user_list) {
 /*
  * Perform cleanup actions after the used has been killed
  */
-void cleanup_user(int idx, USER * user_list)
+void cleanup_user(int idx, USER_TABLE * users)
 {
 	/*
    * m_pid should be set back to -1
@@ -120,8 +460,27 @@ void cleanup_user(int idx, USER * user_list)
    * Set the value of all fd back to -1
    * Set the status back to empty
    */
+	USER * user_list = users->m_list;
+	int last = users->m_active[--users->m_nactive];
+	// The index is keyed by name, so remove the user before clearing it
+	index_remove(users, idx);
+	users->m_active[users->m_active_pos[idx]] = last;
+	users->m_active_pos[last] = users->m_active_pos[idx];
+	users->m_free[users->m_nfree++] = idx;
+	users->m_fd_slot[user_list[idx].m_fd_to_server] = -1;
+	users->m_fd_slot[user_list[idx].m_fd_to_user] = -1;
 	user_list[idx].m_pid = -1;
 	memset(user_list[idx].m_user_id, '\0', MAX_USER_ID);
+	poller_del(&server_poller, user_list[idx].m_fd_to_server);
+	if (users->m_queues[idx].m_count > 0)
+		poller_del(&server_poller, user_list[idx].m_fd_to_user);
+	frame_reader_free(&users->m_readers[idx]);
+	outq_clear(&users->m_queues[idx]);
+	shm_channel_close(users->m_shm[idx].m_channel);
+	outq_clear(&users->m_shm[idx].m_queue);
+	memset(&users->m_shm[idx], 0, sizeof(SHM_LINK));
+	close(user_list[idx].m_fd_to_user);
+	close(user_list[idx].m_fd_to_server);
 	user_list[idx].m_fd_to_user = -1;
 	user_list[idx].m_fd_to_server = -1;
 	user_list[idx].m_status = SLOT_EMPTY;
@@ -130,75 +489,85 @@ void cleanup_user(int idx, USER * user_list)
 /*
  * Kills the user and performs cleanup
  */
-void kick_user(int idx, USER * user_list) {
+void kick_user(int idx, USER_TABLE * users) {
 	/*
    * Kill_user to end the process
    * Clean up the slot (user_list[idx]) for further use
    */
-  kill_user(idx,user_list);
-  cleanup_user(idx,user_list);
+  kill_user(idx,users);
+  cleanup_user(idx,users);
 }
 
 /*
  * broadcast message to all users
  */
-int broadcast_msg(USER * user_list, char *buf, char *sender)
+int broadcast_msg(USER_TABLE * users, char *buf, int sender)
 {
 	/*
    * Iterate over the user_list and if a slot is full, and the user is not the sender itself,
-   * then send the message to that user
+   * then send the message to that user. sender is the sender's slot, or -1 for the server.
+   * The frame is built once and shared by every recipient's queue.
    * Return zero on success
    */
 
-  int i = 0;
-  char buf_tmp[MAX_MSG];
-  char *serv = "SERVER";
+  USER * user_list = users->m_list;
+  char prefix[MAX_USER_ID + 3] = "";
+  MSG_BUF * msg;
   // If sender is not the server then add their name to the prompt
-  if (strcmp(sender, serv) != 0) {
-    strcpy(buf_tmp, "\n");
-    strcat(buf_tmp, sender);
-    strcat(buf_tmp, ":");
-  }
-  // Concatenate the original intended message
-  strcat(buf_tmp, buf);
-  for (int i = 0;i<MAX_USER;i++) {
+  if (sender >= 0) {
+    snprintf(prefix, sizeof(prefix), "\n%s:", user_list[sender].m_user_id);
+  }
+  msg = msg_buf_new(prefix, buf);
+  if (msg == NULL) {
+    perror("\nCouldn't allocate message\n");
+    return -1;
+  }
+  for (int i = 0;i<users->m_nactive;i++) {
     // Send message to everyone who isn't the sender
-    if (strcmp(user_list[i].m_user_id,sender)!=0 && user_list[i].m_status==SLOT_FULL) {
-      // Attempt to write, return error message if failed
-      if (write(user_list[i].m_fd_to_user,buf_tmp,sizeof(buf_tmp)) == -1){
-	       perror("\nCouldn't write to pipe\n");
-      }
+    if (users->m_active[i] != sender) {
+      send_msg(users->m_active[i], users, msg);
     }
   }
+  msg_buf_unref(msg);
 	return 0;
 }
 
 /*
  * Find user index for given user name
  */
-int find_user_index(USER * user_list, char * user_id)
+int find_user_index(USER_TABLE * users, char * user_id)
 {
 	/*
-   * Go over the  user list to return the index of the user which matches the argument user_id
+   * Probe the hash index to return the index of the user which matches the argument user_id
 	 * Return -1 if not found
    */
-	int i, user_idx = -1;
+	int slot, user_idx = -1;
+	unsigned int i, mask = users->m_index_size - 1;
+	USER * user_list = users->m_list;
 
 	if (user_id == NULL) {
 		fprintf(stderr, "NULL name passed.\n");
 		return user_idx;
 	}
-	for (i=0;i<MAX_USER;i++) {
-		if (user_list[i].m_status == SLOT_EMPTY)
-			continue;
-		if (strcmp(user_list[i].m_user_id, user_id) == 0) {
-			return i;
+	for (i = hash_user_id(user_id) & mask; (slot = users->m_index[i]) != -1; i = (i + 1) & mask) {
+		if (strcmp(user_list[slot].m_user_id, user_id) == 0) {
+			return slot;
 		}
 	}
 
 	return -1;
 }
 
+/*
+ * Find the index of the user whose messages arrive on fd
+ */
+int find_user_by_fd(USER_TABLE * users, int fd)
+{
+	if (fd < 0 || fd >= users->m_fd_size)
+		return -1;
+	return users->m_fd_slot[fd];
+}
+
 /*
  * Given a command's input buffer, extract name
  */
@@ -209,7 +578,8 @@ int extract_name(char * buf, char * user_name)
     strcpy(inbuf, buf);
     int token_cnt = parse_line(inbuf, tokens, " ");
     if(token_cnt >= 2) {
-        strcpy(user_name, tokens[1]);
+        // Callers pass MAX_USER_ID sized names
+        snprintf(user_name, MAX_USER_ID, "%s", tokens[1]);
         return 0;
     }
 
@@ -240,7 +610,7 @@ int extract_text(char *buf, char * text)
 /*
  * Send personal message
  */
-void send_p2p_msg(int idx, USER * user_list, char *buf)
+void send_p2p_msg(int idx, USER_TABLE * users, char *buf)
 {
   /*
    * Get the target user by name using extract_name() function
@@ -248,10 +618,11 @@ void send_p2p_msg(int idx, USER * user_list, char *buf)
 	 * If user not found, write back to the original user "User not found", using the write()function on pipes.
 	 * If the user is found then write the message that the user wants to send to that user.
    */
-  char user_name[MAX_USER_ID];
+  char user_name[MAX_USER_ID] = "";
   int user_index;
-  char msg[MAX_MSG];
+  char msg[MAX_MSG] = "";
   char inbuf[MAX_MSG];
+  USER * user_list = users->m_list;
 
   // Test user input
   int j = extract_name(buf,user_name);
@@ -264,45 +635,35 @@ void send_p2p_msg(int idx, USER * user_list, char *buf)
   }
 
   // Handles formatting of the message
-  strcpy(inbuf, "\n");
-  strcat(inbuf, user_list[idx].m_user_id);
-  strcat(inbuf, " : ");
-  strcat(inbuf,msg);
+  snprintf(inbuf, sizeof(inbuf), "\n%s : %s", user_list[idx].m_user_id, msg);
 
-  user_index = find_user_index(user_list,user_name);
+  user_index = find_user_index(users,user_name);
   if (user_index == -1 || user_list[user_index].m_status!=SLOT_FULL) {
     // Error handling for user existence
-    if (write(user_list[idx].m_fd_to_user,"User not found",strlen("User not found")) == -1){
-	     perror("\nCouldn't write to pipe\n");
-     }
+    send_text(idx, users, "User not found");
   } else {
     // Print msg in server
     printf("\nmsg : %s : %s\n", user_list[idx].m_user_id, msg);
     print_prompt("admin");
-    // Attempt to write message to user
-    if (write(user_list[user_index].m_fd_to_user,inbuf,sizeof(msg)) == -1){
-	     perror("\nCouldn't write to pipe\n");
-    }
+    // Queue the message for the user
+    send_text(user_index, users, inbuf);
   }
 }
 
 /*
  * Populates the user list initially
  */
-void init_user_list(USER * user_list) {
+void init_user_list(USER_TABLE * users) {
 	/*
-   * Iterate over the MAX_USER
+   * Allocate MAX_USER slots to start with
 	 * Memset() all m_user_id to zero
 	 * Set all fd to -1
 	 * Set the status to be EMPTY
    */
-	int i=0;
-	for(i=0;i<MAX_USER;i++) {
-		user_list[i].m_pid = -1;
-		memset(user_list[i].m_user_id, '\0', MAX_USER_ID);
-		user_list[i].m_fd_to_user = -1;
-		user_list[i].m_fd_to_server = -1;
-		user_list[i].m_status = SLOT_EMPTY;
+	memset(users, 0, sizeof(*users));
+	if (resize_user_table(users, MAX_USER) == -1) {
+		perror("\nCouldn't allocate user table\n");
+		exit(-1);
 	}
 }
 
@@ -311,203 +672,457 @@ void init_user_list(USER * user_list) {
 
 
 /* ---------------------Start of the Main function ----------------------------------------------*/
+
+// Bytes a relay copies per read()
+#define RELAY_CHUNK 4096
+
+/*
+ * Relay between one user and the server, run by the child forked for that
+ * user. Blocks until either side has something to send, and exits once
+ * either side has gone away. Never returns.
+ */
+void relay_user(int fd_from_user, int fd_to_user, int fd_from_server, int fd_to_server)
+{
+  POLLER relay_poller;
+  POLLER_EVENT events[2];
+  char msg[RELAY_CHUNK];
+  int i, n, nbytes;
+
+  // The server's poller was inherited from the parent; this process has its own
+  poller_close(&server_poller);
+  if (poller_init(&relay_poller) == -1 ||
+      poller_add(&relay_poller, fd_from_server, POLLER_IN) == -1 ||
+      poller_add(&relay_poller, fd_from_user, POLLER_IN) == -1) {
+    perror("\nCouldn't watch relay pipes\n");
+    exit(-1);
+  }
+  while (1) {
+    n = poller_wait(&relay_poller, events, 2, -1);
+    if (n == -1) {
+      if (errno == EINTR)
+        continue;
+      perror("\nCouldn't wait on relay pipes\n");
+      exit(-1);
+    }
+    for (i = 0; i < n; i++) {
+      int from = events[i].m_fd;
+      int to = (from == fd_from_server) ? fd_to_user : fd_to_server;
+      nbytes = read(from, msg, sizeof(msg));
+      if (nbytes == 0) {
+        // The user or the server closed its end
+        exit(0);
+      } else if (nbytes < 0) {
+        if (errno != EAGAIN && errno != EINTR)
+          perror("\nCouldn't read from pipe\n");
+        continue;
+      }
+      // Frames pass through as they are; only the bytes read are copied
+      if (write_all(to, msg, nbytes) == -1) {
+        if (errno == EPIPE)
+          exit(0); // The other side has gone away
+        perror("\nCouldn't write to pipe\n");
+      }
+    }
+  }
+}
+
+/*
+ * Kick every user, before the server exits
+ */
+void kick_all_users(USER_TABLE * users)
+{
+  // Kicking a user takes them off the end of the full slot list
+  while (users->m_nactive > 0) {
+    kick_user(users->m_active[users->m_nactive - 1], users);
+  }
+}
+
+/*
+ * Handle a command typed on the server shell
+ */
+void handle_admin_input(USER_TABLE * users, char * buf)
+{
+  char user_name[MAX_USER_ID];
+  // Predefined buffer in case of admin message
+  char admin_buf[MAX_MSG] = "\nadmin-notice: ";
+  int user_index = 0;
+
+  switch (get_command_type(buf)) {
+    case 0: // List all users
+      if (list_users(-1,users) == -1){
+        perror("Error with listing users");
+      }
+      break;
+    case 1: // Kick: Calls kick_user with the user_index and user_list
+      if (extract_name(buf,user_name) == -1){
+        perror("Error extracting name");
+      }
+      user_index = find_user_index(users,user_name); // grab username out of buf
+      if (user_index == -1){
+        printf("Cannot find user: %s \n", user_name);
+      } else {
+        kick_user(user_index,users);
+      }
+      break;
+    case 4: // Exit: Call kick_user on all users before exiting server process
+      kick_all_users(users);
+      exit(0);
+      break;
+    case 5: // Broadcast msg: Sends message to all users
+      strncat(admin_buf, buf, MAX_MSG - strlen(admin_buf) - 1);
+      broadcast_msg(users,admin_buf,-1);
+      break;
+    default:
+      break;
+  }
+  print_prompt("admin");
+}
+
+/*
+ * Set up shared memory with the user in slot i, who sent buf (see shmring.h)
+ */
+void handle_shm_request(int i, USER_TABLE * users, char * buf)
+{
+  SHM_LINK * link = &users->m_shm[i];
+
+  if (strcmp(buf, SHM_START) == 0) {
+    // Everything the user sent through the pipe before this has been handled
+    if (link->m_channel != NULL)
+      link->m_receiving = 1;
+    return;
+  }
+  if (link->m_channel != NULL)
+    return;
+  link->m_channel = shm_channel_open(buf + strlen(SHM_COMMAND));
+  if (link->m_channel == NULL) {
+    perror("\nCouldn't map shared memory\n");
+    send_text(i, users, SHM_REFUSE);
+    return;
+  }
+  // The answer is the last message through the pipe
+  send_text(i, users, SHM_ACCEPT);
+  link->m_sending = 1;
+}
+
+/*
+ * Handle a message or command sent by the user in slot i
+ */
+void handle_user_msg(int i, USER_TABLE * users, char * buf)
+{
+  if (strncmp(buf, SHM_COMMAND, strlen(SHM_COMMAND)) == 0) {
+    handle_shm_request(i, users, buf);
+    return;
+  }
+  switch (get_command_type(buf)) {
+    case 0: // List
+      if(list_users(i,users) == -1) {
+        perror("Unable to list users");
+      }
+      break;
+    case 4: // Exit
+      printf("\nThe user: %s seems to be terminated\n", users->m_list[i].m_user_id);
+      kick_user(i,users);
+      print_prompt("admin");
+      break;
+    case 2: // P2P
+      send_p2p_msg(i,users,buf); // tokens[2] is the msg to send
+      break;
+    case 5: // Broadcast Message (any other text)
+      broadcast_msg(users,buf,i);
+      break;
+    default:
+      break;
+  }
+}
+
+/*
+ * Read from the server shell and handle every complete line
+ */
+void read_admin_input(USER_TABLE * users)
+{
+  // A line typed on the shell may arrive over several reads
+  static char buf[MAX_MSG];
+  static size_t len = 0;
+  char * line, * newline;
+  ssize_t nbytes;
+
+  nbytes = read(0, buf + len, sizeof(buf) - 1 - len);
+  if (nbytes == 0) {
+    // Stop watching a closed shell
+    poller_del(&server_poller, 0);
+    return;
+  } else if (nbytes < 0) {
+    return;
+  }
+  len += nbytes;
+  buf[len] = '\0';
+  line = buf;
+  while ((newline = strchr(line, '\n')) != NULL) {
+    *newline = '\0';
+    if (*line != '\0')
+      handle_admin_input(users, line);
+    else
+      print_prompt("admin");
+    line = newline + 1;
+  }
+  // Keep the start of an unfinished line, unless it already fills the buffer
+  len = strlen(line);
+  if (len == sizeof(buf) - 1) {
+    handle_admin_input(users, line);
+    len = 0;
+  }
+  memmove(buf, line, len);
+}
+
+/*
+ * Handle every message in the ring from the user in slot idx, then mark the
+ * server asleep on it so the user rings the doorbell for the next one
+ */
+void read_ring_msgs(int idx, USER_TABLE * users)
+{
+  SHM_RING * ring = &users->m_shm[idx].m_channel->m_to_server;
+  int fd = users->m_list[idx].m_fd_to_server;
+  char buf[MAX_MSG];
+  char * msg;
+  size_t len;
+
+  do {
+    while (shm_ring_get(ring, &msg, &len) == 1) {
+      // The text is handled where it lies, but it needs a terminator
+      size_t copy = len < MAX_MSG ? len : MAX_MSG - 1;
+      memcpy(buf, msg, copy);
+      buf[copy] = '\0';
+      shm_ring_done(ring, len);
+      if (copy == 0)
+        continue;
+      handle_user_msg(idx, users, buf);
+      // Stop if the message made the user leave
+      if (find_user_by_fd(users, fd) != idx)
+        return;
+    }
+    if (shm_ring_wake_writer(ring))
+      ring_doorbell(idx, users);
+  } while (shm_ring_sleep(ring) == 0);
+}
+
+/*
+ * Read what the user in slot idx has sent and handle every complete message
+ */
+void read_user_msgs(int idx, USER_TABLE * users)
+{
+  char buf[MAX_MSG];
+  char * msg;
+  size_t len;
+  int fd = users->m_list[idx].m_fd_to_server;
+  int ret;
+  ssize_t nbytes = frame_read(&users->m_readers[idx], fd);
+
+  if (nbytes == 0) {
+    printf("\nThe user: %s seems to be terminated\n", users->m_list[idx].m_user_id);
+    kick_user(idx, users);
+    print_prompt("admin");
+    return;
+  } else if (nbytes < 0) {
+    if (errno != EAGAIN && errno != EINTR)
+      perror("\nCouldn't read from pipe\n");
+    return;
+  }
+  while ((ret = frame_next(&users->m_readers[idx], &msg, &len)) == 1) {
+    // An empty frame is a doorbell for the rings, handled below
+    if (len == 0)
+      continue;
+    // Commands and chat lines are at most MAX_MSG - 1 characters
+    if (len >= MAX_MSG)
+      len = MAX_MSG - 1;
+    memcpy(buf, msg, len);
+    buf[len] = '\0';
+    handle_user_msg(idx, users, buf);
+    // Stop if the message made the user leave
+    if (find_user_by_fd(users, fd) != idx)
+      return;
+  }
+  if (ret == -1) {
+    printf("\nThe user: %s sent a malformed message\n", users->m_list[idx].m_user_id);
+    kick_user(idx, users);
+    print_prompt("admin");
+    return;
+  }
+  if (users->m_shm[idx].m_receiving)
+    read_ring_msgs(idx, users);
+  // The user may have made room in its ring
+  if (find_user_by_fd(users, fd) == idx && users->m_shm[idx].m_queue.m_count > 0)
+    flush_ring(idx, users);
+}
+
+/*
+ * Accept a user waiting on the connection point, if any. Returns 0 if a user
+ * was accepted, -1 otherwise.
+ *
+ * In single process mode the server keeps the user's pipes; otherwise it
+ * forks a relay for the user and talks to the relay.
+ */
+int accept_user(USER_TABLE * users)
+{
+  int pipe_SERVER_reading_from_child[2];
+  int pipe_SERVER_writing_to_child[2];
+  char user_id[MAX_USER_ID];
+
+  int pipe_child_writing_to_user[2];
+  int pipe_child_reading_from_user[2];
+  int idx_tmp;
+  pid_t pid = -1;
+
+  if (get_connection(user_id,pipe_child_writing_to_user,pipe_child_reading_from_user) != 0)
+    return -1;
+
+  idx_tmp = find_empty_slot(users);
+  if (idx_tmp == -1) {
+    printf("\nServer full, rejecting user: %s\n", user_id);
+    close(pipe_child_writing_to_user[0]);
+    close(pipe_child_writing_to_user[1]);
+    close(pipe_child_reading_from_user[0]);
+    close(pipe_child_reading_from_user[1]);
+    print_prompt("admin");
+    return -1;
+  }
+
+  if (single_process) {
+    // Keep the write end to the user and the read end from the user
+    close(pipe_child_writing_to_user[0]);
+    close(pipe_child_reading_from_user[1]);
+    pipe_SERVER_writing_to_child[1] = pipe_child_writing_to_user[1];
+    pipe_SERVER_reading_from_child[0] = pipe_child_reading_from_user[0];
+  } else {
+    if (pipe(pipe_SERVER_writing_to_child) == -1 || pipe(pipe_SERVER_reading_from_child) == -1) {
+      perror("\nCouldn't create pipes\n");
+      return -1;
+    }
+    pid = fork();
+
+    if (pid == 0) {
+      // Child needs to close off its ends of the pipes while error handling
+      if (close(pipe_child_writing_to_user[0]) == -1) {
+        perror("\n Couldn't close file");
+      }
+      if (close(pipe_child_reading_from_user[1]) == -1) {
+        perror("\n Couldn't close file");
+      }
+      if (close(pipe_SERVER_writing_to_child[1]) == -1) {
+        perror("\n Couldn't close file");
+      }
+      if (close(pipe_SERVER_reading_from_child[0]) == -1) {
+        perror("\n Couldn't close file");
+      }
+      relay_user(pipe_child_reading_from_user[0], pipe_child_writing_to_user[1],
+                 pipe_SERVER_writing_to_child[0], pipe_SERVER_reading_from_child[1]);
+    } else if (pid == -1) {
+      perror("\nCouldn't fork relay\n");
+      return -1;
+    }
+
+    // The user's pipes now belong to the relay
+    close(pipe_child_writing_to_user[0]);
+    close(pipe_child_writing_to_user[1]);
+    close(pipe_child_reading_from_user[0]);
+    close(pipe_child_reading_from_user[1]);
+    // Pipe the pipes connecting server and child if there is a connection
+    if (close(pipe_SERVER_writing_to_child[0]) == -1) { // Error handle while closing reading end of writing pipes
+      perror("\n Couldn't close file");
+    }
+    if (close(pipe_SERVER_reading_from_child[1]) == -1) { // Error handle while closing writing end of reading pipes
+      perror("\n Couldn't close file");
+    }
+  }
+  fcntl(pipe_SERVER_reading_from_child[0], F_SETFL, fcntl(pipe_SERVER_reading_from_child[0], F_GETFL)| O_NONBLOCK);
+  // Writes to the user never block; send_msg() queues what doesn't fit
+  fcntl(pipe_SERVER_writing_to_child[1], F_SETFL, fcntl(pipe_SERVER_writing_to_child[1], F_GETFL)| O_NONBLOCK);
+  printf("\nA new user: %s connected. slot:%d\n",user_id, idx_tmp);
+  add_user(idx_tmp, users, pid,user_id,pipe_SERVER_writing_to_child[1], pipe_SERVER_reading_from_child[0]);
+  if (poller_add(&server_poller, pipe_SERVER_reading_from_child[0], POLLER_IN) == -1) {
+    perror("\nCouldn't watch user pipe\n");
+  }
+  print_prompt("admin");
+  return 0;
+}
+
+/*
+ * Each user served directly costs the server two descriptors, so allow as
+ * many as the hard limit permits.
+ */
+void raise_fd_limit(void)
+{
+  struct rlimit limit;
+  if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+    limit.rlim_cur = limit.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &limit);
+  }
+}
+
 int main(int argc, char * argv[])
 {
+	// -s: serve every user from this process, without relay processes
+	if (argc > 1 && strcmp(argv[1], "-s") == 0) {
+		single_process = 1;
+		raise_fd_limit();
+	}
 
-	int nbytes = 0;
 	setup_connection("500"); // Specifies the connection point as argument.
 
-	USER user_list[MAX_USER];
-	init_user_list(user_list);   // Initialize user list
+	USER_TABLE users;
+	init_user_list(&users);   // Initialize user list
+
+	POLLER_EVENT events[64];
+	int i, n;
 
-	char buf[MAX_MSG];
 	fcntl(0, F_SETFL, fcntl(0, F_GETFL)| O_NONBLOCK);
+	if (poller_init(&server_poller) == -1) {
+		perror("\nCouldn't create poller\n");
+		exit(-1);
+	}
+	// Fails when stdin is a regular file or /dev/null; run without a shell then
+	if (poller_add(&server_poller, 0, POLLER_IN) == -1) {
+		perror("\nCouldn't watch server shell\n");
+	}
+	// A user that has gone away must not kill the server
+	signal(SIGPIPE, SIG_IGN);
 	print_prompt("admin");
-	int idx_tmp;
-  int idx_pipe;
-  int usr_count;
-  pid_t pid = 5;
   // Signal handler for server
   void handle_interrupt(int sig) {
     printf("%s\n","Server interrupt");
-    for (int s = 0; s<MAX_USER; s++) {
-      if (user_list[s].m_status == SLOT_FULL) {
-        kick_user(s, user_list);
-      }
-    }
+    kick_all_users(&users);
     exit(0);
   }
   signal(SIGINT,handle_interrupt);
 
 	while(1) {
-		/* ------------------------YOUR CODE FOR MAIN--------------------------------*/
-    int pipe_SERVER_reading_from_child[2];
-    int pipe_SERVER_writing_to_child[2];
-    char user_id[MAX_USER_ID];
-
-    int pipe_child_writing_to_user[2];
-    int pipe_child_reading_from_user[2];
-    if (get_connection(user_id,pipe_child_writing_to_user,pipe_child_reading_from_user)==0) { // if a user connects then create
-      pipe(pipe_SERVER_writing_to_child);
-      pipe(pipe_SERVER_reading_from_child);
-
-      fcntl(pipe_SERVER_reading_from_child[0], F_SETFL, fcntl(pipe_SERVER_reading_from_child[0], F_GETFL)| O_NONBLOCK); // make read ends of all pipes non blocking
-      fcntl(pipe_SERVER_writing_to_child[0], F_SETFL, fcntl(pipe_SERVER_writing_to_child[0], F_GETFL)| O_NONBLOCK);
-      fcntl(pipe_child_writing_to_user[0], F_SETFL, fcntl(pipe_child_writing_to_user[0], F_GETFL)| O_NONBLOCK);
-      fcntl(pipe_child_reading_from_user[0], F_SETFL, fcntl(pipe_child_reading_from_user[0], F_GETFL)| O_NONBLOCK);
-      pid = fork();
-
-      if (pid!=0) {
-        // Pipe the pipes connecting server and child if there is a connection
-        if (close(pipe_SERVER_writing_to_child[0]) == -1) { // Error handle while closing reading end of writing pipes
-          perror("\n Couldn't close file");
-	      }
-        if (close(pipe_SERVER_reading_from_child[1]) == -1) { // Error handle while closing writing end of reading pipes
-          perror("\n Couldn't close file");
-	      }
-        idx_tmp = find_empty_slot(user_list);
-        printf("\nA new user: %s connected. slot:%d\n",user_id, idx_tmp);
-        add_user(idx_tmp, user_list, pid-1,user_id,pipe_SERVER_writing_to_child[1], pipe_SERVER_reading_from_child[0]);
-        usr_count++;
-        print_prompt("admin");
-      }
-      else {
-        // Child needs to close off its ends of the pipes while error handling
-        if (close(pipe_child_writing_to_user[0]) == -1) {
-          perror("\n Couldn't close file");
-        }
-        if (close(pipe_child_reading_from_user[1]) == -1) {
-          perror("\n Couldn't close file");
-        }
-        if (close(pipe_SERVER_writing_to_child[1]) == -1) {
-          perror("\n Couldn't close file");
-        }
-        if (close(pipe_SERVER_reading_from_child[0]) == -1) {
-          perror("\n Couldn't close file");
-        }
-      }
-    }
+    // Handling new connections using get_connection
+    while (accept_user(&users) == 0)
+      ;
 
-		// Handling a new connection using get_connection
-    if (pid!=0) {
-      char buf2[MAX_MSG];
-      // Poll std in
-      int nbytesfromstin = read(0,buf,sizeof(buf));
-      usleep(50);
-      strtok(buf, "\n");
-      char user_name[MAX_USER_ID];
-      // Predefined buffer in case of admin message
-      char admin_buf[MAX_MSG] = "\nadmin-notice: ";
-      int user_index = 0;
-      if (nbytesfromstin > 0) { // READ FROM STANDARD IN
-        switch (get_command_type(buf)) {
-          case 0: // List all users
-            if (list_users(-1,user_list) == -1){
-              perror("Error with listing users");
-            }
-            break;
-          case 1: // Kick: Calls kick_user with the user_index and user_list
-            if (extract_name(buf,user_name) == -1){
-              perror("Error extracting name");
-            }
-            user_index = find_user_index(user_list,user_name); // grab username out of buf
-      	    if (user_index == -1){
-              printf("Cannot find user: %s \n", user_name);
-      	    } else {
-      	    	kick_user(user_index,user_list); // tokens[2] is the msg to send
-              usr_count--;
-      	    }
-            break;
-          case 4: // Exit: Call kick_user on all users before exiting server process
-            for (int s = 0; s<MAX_USER; s++) {
-              if (user_list[s].m_status == SLOT_FULL) {
-                kick_user(s, user_list);
-              }
-            }
-            exit(0);
-            break;
-          case 5: // Broadcast msg: Sends message to all users
-            strcat(admin_buf, buf);
-            broadcast_msg(user_list,admin_buf,"SERVER");
-            break;
-          default:
-            break;
-        }
-        print_prompt("admin");
-        memset(buf,'\0',MAX_MSG);
-      } else if(nbytesfromstin == 0) {
-        perror("Pipe broken.");
-      }
-
-      int nbytes = 0;
-      for (int i = 0;i<MAX_USER;i++) {
-        // Read input from all active pipes in the user_list
-        if (user_list[i].m_status == SLOT_FULL) {
-          nbytes = read(user_list[i].m_fd_to_server,buf2,sizeof(buf2));
-          usleep(50);
-          if (nbytes > 0) {
-            switch (get_command_type(buf2)) {
-              case 0: // List
-                if(list_users(i,user_list) == -1) {
-                  perror("Unable to list users");
-                }
-                break;
-              case 4: // Exit
-                printf("\nThe user: %s seems to be terminated\n", user_list[i].m_user_id);
-                kick_user(i,user_list);
-                usr_count--;
-		            print_prompt("admin");
-                break;
-              case 2: // P2P
-                send_p2p_msg(i,user_list,buf2); // tokens[2] is the msg to send
-                break;
-              case 5: // Broadcast Message (any other text)
-                broadcast_msg(user_list,buf2,user_list[i].m_user_id);
-                break;
-              default:
-                break;
-            }
-            memset(buf2,'\0',MAX_MSG);
-          } else if(nbytes == 0){
-            perror("Pipe broken.");
-          }
-        }
-      }
-    } else {
-      // Child polls its fd from user and server and sends info if necessary
-      char msg_from_server[MAX_MSG];
-      char msg_from_user[MAX_MSG];
-      int nbytes_from_server = 0;
-      int nbytes_from_user = 0;
-      fcntl(pipe_SERVER_writing_to_child[0], F_SETFL, fcntl(pipe_SERVER_writing_to_child[0], F_GETFL)| O_NONBLOCK);
-      fcntl(pipe_child_writing_to_user[0], F_SETFL, fcntl(pipe_child_writing_to_user[0], F_GETFL)| O_NONBLOCK);
-      while (1) {
-
-        nbytes_from_server = read(pipe_SERVER_writing_to_child[0],msg_from_server,sizeof(msg_from_server));
-
-        nbytes_from_user = read(pipe_child_reading_from_user[0],msg_from_user,sizeof(msg_from_user));
-
-        if (nbytes_from_server > 0) {
-          // Received a message from the server so now we need to write it to the user
-          if (write(pipe_child_writing_to_user[1],msg_from_server,sizeof(msg_from_server)) == -1){
-            perror("\nCouldn't write to pipe\n");
-          }
-          memset(msg_from_server,'\0',MAX_MSG);
-        }
-        if (nbytes_from_user > 0) {
-          /*
-           * Received a message from a user so now we have to write it to the server
-           */
-          if (write(pipe_SERVER_reading_from_child[1],msg_from_user,sizeof(msg_from_user)) == -1){
-            perror("\nCouldn't write to pipe\n");
-          }
-          memset(msg_from_user,'\0',MAX_MSG);
-        }
-        usleep(300);
+    /*
+     * Sleep until the shell or a user has something to say. The connection
+     * point has no descriptor to wait on, so wake up every CONNECT_POLL_MS to
+     * check for new users.
+     */
+    n = poller_wait(&server_poller, events, 64, CONNECT_POLL_MS);
+    if (n == -1) {
+      if (errno != EINTR)
+        perror("\nCouldn't wait on pipes\n");
+      continue;
+    }
+    for (i = 0; i < n; i++) {
+      if (events[i].m_fd == 0) { // READ FROM STANDARD IN
+        read_admin_input(&users);
+        continue;
       }
+      int idx = find_user_by_fd(&users, events[i].m_fd);
+      if (idx == -1)
+        continue;
+      if (events[i].m_fd == users.m_list[idx].m_fd_to_user)
+        flush_user(idx, &users); // Room in a backlogged pipe
+      else
+        read_user_msgs(idx, &users);
     }
-		/* ------------------------YOUR CODE FOR MAIN--------------------------------*/
-    usleep(500);
 	}
 }
 
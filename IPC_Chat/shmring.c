@@ -0,0 +1,168 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "frame.h"
+#include "shmring.h"
+
+#define SHM_RING_MASK (SHM_RING_SIZE - 1)
+// Header of the filler the writer leaves when a frame won't fit before the end
+#define SHM_RING_SKIP 0xffffffffu
+
+SHM_CHANNEL * shm_channel_create(char * name) {
+  static int count = 0;
+  SHM_CHANNEL * channel;
+  int fd;
+
+  snprintf(name, SHM_NAME_MAX, "/ipcchat-%d-%d", (int)getpid(), count++);
+  fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+  if (fd == -1) {
+    return NULL;
+  }
+  // The new pages are zero, which is an empty ring
+  if (ftruncate(fd, sizeof(SHM_CHANNEL)) == -1) {
+    close(fd);
+    shm_unlink(name);
+    return NULL;
+  }
+  channel = mmap(NULL, sizeof(SHM_CHANNEL), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (channel == MAP_FAILED) {
+    shm_unlink(name);
+    return NULL;
+  }
+  return channel;
+}
+
+SHM_CHANNEL * shm_channel_open(const char * name) {
+  SHM_CHANNEL * channel;
+  struct stat st;
+  int fd;
+
+  // Only names shm_channel_create() could have made
+  if (name[0] != '/' || strchr(name + 1, '/') != NULL || strlen(name) >= SHM_NAME_MAX) {
+    errno = EINVAL;
+    return NULL;
+  }
+  fd = shm_open(name, O_RDWR, 0);
+  if (fd == -1) {
+    return NULL;
+  }
+  if (fstat(fd, &st) == -1 || st.st_size != sizeof(SHM_CHANNEL)) {
+    close(fd);
+    errno = EINVAL;
+    return NULL;
+  }
+  channel = mmap(NULL, sizeof(SHM_CHANNEL), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (channel == MAP_FAILED) {
+    return NULL;
+  }
+  shm_unlink(name);
+  return channel;
+}
+
+void shm_channel_close(SHM_CHANNEL * channel) {
+  if (channel != NULL) {
+    munmap(channel, sizeof(SHM_CHANNEL));
+  }
+}
+
+void shm_channel_unlink(const char * name) {
+  shm_unlink(name);
+}
+
+int shm_ring_put(SHM_RING * ring, const char * msg, size_t len) {
+  unsigned int head = atomic_load_explicit(&ring->m_head, memory_order_relaxed);
+  unsigned int tail, off = head & SHM_RING_MASK;
+  size_t need = FRAME_HEADER + len, skip = 0;
+
+  // Leaves room for the filler in front of it in an empty ring
+  if (need > SHM_RING_SIZE / 2) {
+    return -1;
+  }
+  if (SHM_RING_SIZE - off < need) {
+    skip = SHM_RING_SIZE - off;
+  }
+  tail = atomic_load_explicit(&ring->m_tail, memory_order_acquire);
+  if (SHM_RING_SIZE - (head - tail) < skip + need) {
+    // Ask for a doorbell, then look again in case the reader missed the request
+    atomic_store(&ring->m_writer_waiting, 1);
+    tail = atomic_load(&ring->m_tail);
+    if (SHM_RING_SIZE - (head - tail) < skip + need) {
+      return -1;
+    }
+    atomic_store_explicit(&ring->m_writer_waiting, 0, memory_order_relaxed);
+  }
+  if (skip >= FRAME_HEADER) {
+    memset(ring->m_data + off, 0xff, FRAME_HEADER);
+  }
+  off = (head + skip) & SHM_RING_MASK;
+  frame_header(ring->m_data + off, len);
+  memcpy(ring->m_data + off + FRAME_HEADER, msg, len);
+  // Sequentially consistent, so shm_ring_wake_reader() can't miss a sleeper
+  atomic_store(&ring->m_head, head + skip + need);
+  return 0;
+}
+
+int shm_ring_get(SHM_RING * ring, char ** msg, size_t * len) {
+  unsigned int tail = atomic_load_explicit(&ring->m_tail, memory_order_relaxed);
+  unsigned int head = atomic_load_explicit(&ring->m_head, memory_order_acquire);
+  unsigned int off;
+
+  // Awake after all, so the writer need not ring
+  if (atomic_load_explicit(&ring->m_reader_asleep, memory_order_relaxed)) {
+    atomic_store_explicit(&ring->m_reader_asleep, 0, memory_order_relaxed);
+  }
+  while (tail != head) {
+    off = tail & SHM_RING_MASK;
+    if (SHM_RING_SIZE - off >= FRAME_HEADER) {
+      unsigned char * header = (unsigned char *)ring->m_data + off;
+      unsigned int length = ((unsigned int)header[0] << 24) | ((unsigned int)header[1] << 16) |
+                            ((unsigned int)header[2] << 8) | (unsigned int)header[3];
+      if (length != SHM_RING_SKIP) {
+        *msg = ring->m_data + off + FRAME_HEADER;
+        *len = length;
+        return 1;
+      }
+    }
+    // The next frame starts back at the beginning
+    tail += SHM_RING_SIZE - off;
+    atomic_store_explicit(&ring->m_tail, tail, memory_order_release);
+  }
+  return 0;
+}
+
+void shm_ring_done(SHM_RING * ring, size_t len) {
+  unsigned int tail = atomic_load_explicit(&ring->m_tail, memory_order_relaxed);
+  // Sequentially consistent, so shm_ring_wake_writer() can't miss a waiter
+  atomic_store(&ring->m_tail, tail + FRAME_HEADER + len);
+}
+
+int shm_ring_sleep(SHM_RING * ring) {
+  atomic_store(&ring->m_reader_asleep, 1);
+  if (atomic_load(&ring->m_head) != atomic_load_explicit(&ring->m_tail, memory_order_relaxed)) {
+    atomic_store_explicit(&ring->m_reader_asleep, 0, memory_order_relaxed);
+    return 0;
+  }
+  return 1;
+}
+
+int shm_ring_wake_reader(SHM_RING * ring) {
+  return atomic_load(&ring->m_reader_asleep) && atomic_exchange(&ring->m_reader_asleep, 0);
+}
+
+int shm_ring_wake_writer(SHM_RING * ring) {
+  return atomic_load(&ring->m_writer_waiting) && atomic_exchange(&ring->m_writer_waiting, 0);
+}
+
+void shm_doorbell(int fd) {
+  static const char empty[FRAME_HEADER] = {0, 0, 0, 0};
+  ssize_t nbytes;
+  do {
+    nbytes = write(fd, empty, FRAME_HEADER);
+  } while (nbytes == -1 && errno == EINTR);
+}
@@ -0,0 +1,116 @@
+#ifndef SHMRING_H
+#define SHMRING_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+
+/*
+ * Shared memory transport between a user and the server.
+ *
+ * The user creates a segment holding one ring for each direction and sends
+ * its name to the server, which maps it too. Each ring has one writer and
+ * one reader. Messages are stored as frames (see frame.h), each in one
+ * contiguous piece, so the writer copies a message in once and the reader
+ * handles it where it lies.
+ *
+ * While both sides are busy no system call is made. A reader that has
+ * nothing left to do marks itself asleep (shm_ring_sleep()) and waits on its
+ * pipe; the writer that finds it asleep (shm_ring_wake_reader()) rings the
+ * doorbell, an empty frame on the pipe. Likewise a writer that finds the
+ * ring full is woken by the reader once there is room.
+ */
+
+/*
+ * Negotiated over the pipes: the user sends "\shm <name>" and the server
+ * answers SHM_ACCEPT, or SHM_REFUSE and the pipes stay in use. The user then
+ * sends SHM_START before its first message through the ring. Each side reads
+ * its ring only after the other's last message through the pipe, so
+ * messages stay in order even through a relay.
+ */
+#define SHM_COMMAND "\\shm "
+#define SHM_ACCEPT "\\shm ok"
+#define SHM_REFUSE "\\shm no"
+#define SHM_START "\\shm on"
+
+// Bytes of frames each ring holds, a power of two
+#define SHM_RING_SIZE (1 << 17)
+// Longest segment name
+#define SHM_NAME_MAX 64
+
+typedef struct _shmRing {
+  // Bytes ever written and read; they only grow, and wrap around together
+  _Alignas(64) atomic_uint m_head;
+  _Alignas(64) atomic_uint m_tail;
+  _Alignas(64) atomic_int m_reader_asleep;
+  atomic_int m_writer_waiting;
+  char m_data[SHM_RING_SIZE];
+} SHM_RING;
+
+// Layout of the segment
+typedef struct _shmChannel {
+  SHM_RING m_to_server;
+  SHM_RING m_to_user;
+} SHM_CHANNEL;
+
+/*
+ * Create and map a new segment, putting its name in name[SHM_NAME_MAX].
+ * Returns NULL on failure.
+ */
+SHM_CHANNEL * shm_channel_create(char * name);
+
+/*
+ * Map the segment another process created, and remove its name so it goes
+ * away once both sides unmap it. Returns NULL on failure.
+ */
+SHM_CHANNEL * shm_channel_open(const char * name);
+
+void shm_channel_close(SHM_CHANNEL * channel);
+
+/*
+ * Remove the name of a segment shm_channel_create() made, for when the server
+ * never opened it.
+ */
+void shm_channel_unlink(const char * name);
+
+/*
+ * Write msg as one frame. Returns 0, or -1 if there is no room (the reader
+ * will ring the doorbell once it has made some) or msg can never fit.
+ */
+int shm_ring_put(SHM_RING * ring, const char * msg, size_t len);
+
+/*
+ * Point *msg at the next message in the ring, without removing it. Returns
+ * 1, or 0 if the ring is empty. The text is not NUL terminated.
+ */
+int shm_ring_get(SHM_RING * ring, char ** msg, size_t * len);
+
+/*
+ * Remove the len byte message shm_ring_get() returned
+ */
+void shm_ring_done(SHM_RING * ring, size_t len);
+
+/*
+ * Reader: mark itself asleep before waiting on its pipe. Returns 1 if it
+ * may sleep, or 0 if a message arrived meanwhile and it should carry on.
+ */
+int shm_ring_sleep(SHM_RING * ring);
+
+/*
+ * Writer, after shm_ring_put(): returns 1 if the reader was asleep and must
+ * be sent a doorbell.
+ */
+int shm_ring_wake_reader(SHM_RING * ring);
+
+/*
+ * Reader, after shm_ring_done(): returns 1 if the writer was waiting for
+ * room and must be sent a doorbell.
+ */
+int shm_ring_wake_writer(SHM_RING * ring);
+
+/*
+ * Ring the doorbell: send an empty frame on fd. A full pipe already has
+ * something for the other side to read, so that is not an error.
+ */
+void shm_doorbell(int fd);
+
+#endif
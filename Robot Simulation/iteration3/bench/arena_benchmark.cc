@@ -0,0 +1,166 @@
+// Google Benchmark Framework
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+// Project code from the ../src directory
+#include "../src/arena.h"
+#include "../src/arena_params.h"
+#include "../src/kinematics_kernel.h"
+#include "../src/light_sensor.h"
+#include "../src/motion_behavior_differential.h"
+#include "../src/params.h"
+#include "../src/pose.h"
+#include "../src/robot.h"
+
+/************************************************************************
+* SETUP
+*************************************************************************/
+
+// Area given to each entity of the scene, so that large scenes are as
+// crowded as a full default arena rather than piled on top of each other.
+static const double kAreaPerEntity = 100.0 * 100.0;
+
+// An arena with range(0) robots, range(1) lights and range(2) foods, set up
+// like the headless driver does, with every entity scattered uniformly over
+// an arena scaled to the number of entities. (EntityFactory only places
+// entities on a coarse lattice of the default arena.)
+static std::unique_ptr<csci3081::Arena> MakeArena(
+    const benchmark::State &state) {
+  size_t n_entities = state.range(0) + state.range(1) + state.range(2);
+  double scale = std::max(1.0, std::sqrt(n_entities * kAreaPerEntity /
+                                         (ARENA_X_DIM * ARENA_Y_DIM)));
+  csci3081::arena_params aparams;
+  aparams.x_dim = static_cast<uint>(ARENA_X_DIM * scale);
+  aparams.y_dim = static_cast<uint>(ARENA_Y_DIM * scale);
+
+  aparams.seed = 42;
+  srandom(42);
+  std::unique_ptr<csci3081::Arena> arena(new csci3081::Arena(&aparams));
+  arena->AddRobot(static_cast<int>(state.range(0)) / 2, csci3081::kCoward);
+  arena->AddRobot(static_cast<int>(state.range(0) - state.range(0) / 2),
+                  csci3081::kExplore);
+  arena->AddLight(static_cast<int>(state.range(1)));
+  arena->AddFood(static_cast<int>(state.range(2)));
+  for (auto ent : arena->get_entities()) {
+    ent->set_position(random() % aparams.x_dim, random() % aparams.y_dim);
+  }
+  arena->AcceptCommand(state.range(2) ? csci3081::kFoodOn
+                                      : csci3081::kFoodOff);
+  arena->AcceptCommand(csci3081::kPlay);
+  return arena;
+}
+
+static void SetCounters(benchmark::State &state) {
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.counters["robots"] = state.range(0);
+  state.counters["lights"] = state.range(1);
+  state.counters["foods"] = state.range(2);
+}
+
+// Each count from 10 to 100k, with the other two at their defaults.
+static void RobotArgs(benchmark::internal::Benchmark *bench) {
+  for (int n = 10; n <= 100000; n *= 10) {
+    bench->Args({n, N_LIGHTS, N_FOODS});
+  }
+}
+
+static void SceneArgs(benchmark::internal::Benchmark *bench) {
+  RobotArgs(bench);
+  for (int n = 10; n <= 100000; n *= 10) {
+    bench->Args({N_ROBOTS, n, N_FOODS});
+  }
+  for (int n = 10; n <= 100000; n *= 10) {
+    bench->Args({N_ROBOTS, N_LIGHTS, n});
+  }
+}
+
+/*******************************************************************************
+ * Benchmarks
+ ******************************************************************************/
+// A whole timestep; ns per iteration is ns per step.
+static void BM_ArenaStep(benchmark::State &state) {
+  auto arena = MakeArena(state);
+  for (auto _ : state) {
+    arena->UpdateEntitiesTimestep();
+  }
+  SetCounters(state);
+}
+BENCHMARK(BM_ArenaStep)->Apply(SceneArgs)->Unit(benchmark::kMicrosecond);
+
+// One phase of the timestep. The other phases are not run, so the entities
+// stand still; the work per phase does not depend on where they are.
+static void BM_ArenaPhase(benchmark::State &state,
+                          void (csci3081::Arena::*phase)()) {
+  auto arena = MakeArena(state);
+  for (auto _ : state) {
+    ((*arena).*phase)();
+  }
+  SetCounters(state);
+}
+BENCHMARK_CAPTURE(BM_ArenaPhase, poses, &csci3081::Arena::UpdatePoses)
+  ->Apply(RobotArgs)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ArenaPhase, hunger, &csci3081::Arena::UpdateHunger)
+  ->Apply(SceneArgs)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ArenaPhase, sensors, &csci3081::Arena::UpdateSensors)
+  ->Apply(SceneArgs)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_ArenaPhase, collisions,
+                  &csci3081::Arena::UpdateCollisions)
+  ->Apply(RobotArgs)->Unit(benchmark::kMicrosecond);
+
+// MotionBehaviorDifferential::UpdatePose() on its own, for both the turning
+// and the straight line case.
+static void BM_UpdatePose(benchmark::State &state) {
+  csci3081::Robot robot;
+  csci3081::MotionBehaviorDifferential behavior(&robot);
+  csci3081::WheelVelocity vel(5, state.range(0) ? 8 : 5);
+  for (auto _ : state) {
+    robot.set_position(ARENA_X_DIM / 2, ARENA_Y_DIM / 2);
+    behavior.UpdatePose(1, vel);
+    benchmark::DoNotOptimize(robot.get_pose());
+  }
+  state.SetLabel(state.range(0) ? "turning" : "straight");
+}
+BENCHMARK(BM_UpdatePose)->Arg(0)->Arg(1);
+
+// IntegrateDifferentialDrive() over range(0) entities, a quarter of them
+// driving straight, per entity for comparison with BM_UpdatePose.
+static void BM_KinematicsKernel(benchmark::State &state) {
+  size_t n = state.range(0);
+  std::vector<double> x(n), y(n), theta(n), left(n), right(n);
+  for (size_t i = 0; i < n; ++i) {
+    left[i] = 5;
+    right[i] = i % 4 ? 5 + (i % 7) : 5;
+  }
+  for (auto _ : state) {
+    for (size_t i = 0; i < n; ++i) {
+      x[i] = ARENA_X_DIM / 2;
+      y[i] = ARENA_Y_DIM / 2;
+      theta[i] = 7.0 * i;
+    }
+    csci3081::IntegrateDifferentialDrive(x.data(), y.data(), theta.data(),
+                                         left.data(), right.data(), n, 1);
+    benchmark::DoNotOptimize(x.data());
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+  state.SetLabel(csci3081::KinematicsKernelIsa());
+}
+BENCHMARK(BM_KinematicsKernel)->Arg(16)->Arg(256)->Arg(4096)->Arg(65536);
+
+// A single Sensor::CalculateReading(); see sensor_benchmark.cc for the
+// batched comparison.
+static void BM_CalculateReading(benchmark::State &state) {
+  csci3081::LightSensor sensor(csci3081::Pose(300, 200));
+  csci3081::Pose light(450, 320);
+  for (auto _ : state) {
+    // Keep the compiler from hoisting the reading out of the loop
+    benchmark::DoNotOptimize(light);
+    sensor.ZeroReading();
+    sensor.CalculateReading(light);
+    benchmark::DoNotOptimize(sensor.GetReading());
+  }
+}
+BENCHMARK(BM_CalculateReading);
@@ -0,0 +1,85 @@
+// Google Benchmark Framework
+#include <benchmark/benchmark.h>
+#include <cstdlib>
+#include <vector>
+
+// Project code from the ../src directory
+#include "../src/light_sensor.h"
+#include "../src/params.h"
+#include "../src/pose.h"
+#include "../src/sensor_kernel.h"
+
+/************************************************************************
+* SETUP
+*************************************************************************/
+
+// Sensors and sources scattered over the arena. range(0) is the number of
+// sensors (two per robot), range(1) the number of lights or foods.
+struct SensorScene {
+  explicit SensorScene(const benchmark::State &state) {
+    srand(42);
+    for (int i = 0; i < state.range(0); ++i) {
+      sensor_x.push_back(rand() % ARENA_X_DIM);
+      sensor_y.push_back(rand() % ARENA_Y_DIM);
+      gain.push_back(2000);
+      reading.push_back(0);
+    }
+    for (int j = 0; j < state.range(1); ++j) {
+      source_x.push_back(rand() % ARENA_X_DIM);
+      source_y.push_back(rand() % ARENA_Y_DIM);
+    }
+  }
+  std::vector<double> sensor_x, sensor_y, gain, reading;
+  std::vector<double> source_x, source_y;
+};
+
+static void SensorArgs(benchmark::internal::Benchmark *bench) {
+  for (int sensors : {16, 256, 4096, 65536}) {
+    for (int sources : {6, 64}) {
+      bench->Args({sensors, sources});
+    }
+  }
+}
+
+/*******************************************************************************
+ * Benchmarks
+ ******************************************************************************/
+// The per-call path: one LightSensor::CalculateReading() per sensor/source
+// pair, as Robot::NotifyLights() does.
+static void BM_SensorPerCall(benchmark::State &state) {
+  SensorScene scene(state);
+  std::vector<csci3081::LightSensor> sensors;
+  for (size_t i = 0; i < scene.sensor_x.size(); ++i) {
+    sensors.emplace_back(csci3081::Pose(scene.sensor_x[i], scene.sensor_y[i]));
+  }
+  for (auto _ : state) {
+    for (auto &sensor : sensors) {
+      sensor.ZeroReading();
+      for (size_t j = 0; j < scene.source_x.size(); ++j) {
+        sensor.CalculateReading(
+          csci3081::Pose(scene.source_x[j], scene.source_y[j]));
+      }
+      benchmark::DoNotOptimize(sensor.GetReading());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0) *
+                          state.range(1));
+}
+BENCHMARK(BM_SensorPerCall)->Apply(SensorArgs);
+
+// The batched kernel over contiguous arrays.
+static void BM_SensorKernel(benchmark::State &state) {
+  SensorScene scene(state);
+  for (auto _ : state) {
+    std::fill(scene.reading.begin(), scene.reading.end(), 0);
+    csci3081::AccumulateSensorReadings(
+      scene.sensor_x.data(), scene.sensor_y.data(), scene.gain.data(),
+      scene.sensor_x.size(), scene.source_x.data(), scene.source_y.data(),
+      scene.source_x.size(), scene.reading.data());
+    benchmark::DoNotOptimize(scene.reading.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0) *
+                          state.range(1));
+  state.SetLabel(csci3081::SensorKernelIsa());
+}
+BENCHMARK(BM_SensorKernel)->Apply(SensorArgs);
@@ -9,34 +9,79 @@
  ******************************************************************************/
 #include <algorithm>
 #include <iostream>
+#include <random>
 
 #include "src/arena.h"
 #include "src/arena_params.h"
+#include "src/kinematics_kernel.h"
+#include "src/sensor_kernel.h"
 
 /*******************************************************************************
  * Namespaces
  ******************************************************************************/
 NAMESPACE_BEGIN(csci3081);
 
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+// The seed used when arena_params::seed is 0.
+static uint64_t RandomSeed() {
+  std::random_device device;
+  return (static_cast<uint64_t>(device()) << 32) | device();
+} /* RandomSeed() */
+
 /*******************************************************************************
  * Constructors/Destructor
  ******************************************************************************/
 Arena::Arena(const struct arena_params *const params)
     : x_dim_(params->x_dim),
       y_dim_(params->y_dim),
-      factory_(new EntityFactory),
       entities_(),
-      mobile_entities_(),
-      robot_entities_(),
-      light_entities_(),
-      food_entities_(),
-      game_status_(PAUSED) {
+      rng_(params->seed ? params->seed : RandomSeed()),
+      factory_(new EntityFactory(&entities_, &rng_)),
+      store_(),
+      robots_(),
+      lights_(),
+      foods_(),
+      game_status_(PAUSED),
+      robot_grid_(),
+      food_grid_(),
+      field_resolution_(params->field_resolution),
+      light_field_(),
+      food_field_(),
+      grid_candidates_(std::max<size_t>(params->n_threads, 1)),
+      events_(),
+      thread_events_(grid_candidates_.size()),
+      collision_dx_(),
+      collision_dy_(),
+      collided_(),
+      light_x_(),
+      light_y_(),
+      food_x_(),
+      food_y_(),
+      sensor_x_(),
+      sensor_y_(),
+      light_gain_(),
+      food_gain_(),
+      light_reading_(),
+      food_reading_(),
+      drive_x_(),
+      drive_y_(),
+      drive_theta_(),
+      drive_left_(),
+      drive_right_(),
+#ifdef ARENA_PROFILE
+      profiler_(),
+#endif
+      pool_(params->n_threads) {
+  if (field_resolution_ > 0) {
+    light_field_.Resize(x_dim_, y_dim_, field_resolution_);
+    food_field_.Resize(x_dim_, y_dim_, field_resolution_);
+  }
 } /* Arena() */
 
 Arena::~Arena() {
-  for (auto ent : entities_) {
-    delete ent;
-  } /* for(ent..) */
+  delete factory_;
 } /* ~Arena() */
 
 /*******************************************************************************
@@ -44,135 +89,437 @@ Arena::~Arena() {
  ******************************************************************************/
 void Arena::AddRobot(int quantity, RobotType rtype) {
   for (int i = 0; i < quantity; i++) {
-    robot_ = dynamic_cast<Robot *>(factory_->CreateEntity(kRobot));
+    robot_ = factory_->CreateRobot();
     robot_->set_robot_type(rtype);
     robot_->set_light_sensitivity(light_sensitivity_);
-    entities_.push_back(robot_);
-    mobile_entities_.push_back(robot_);
-    robot_entities_.push_back(robot_);
+    store_.Add(robot_);
   }
+  RefreshSlots();
 } /* AddRobot() */
 
 void Arena::AddLight(int quantity) {
   for (int i = 0; i < quantity; i++) {
-    light_ = dynamic_cast<Light *>(factory_->CreateEntity(kLight));
-    entities_.push_back(light_);
-    mobile_entities_.push_back(light_);
-    light_entities_.push_back(light_);
+    light_ = factory_->CreateLight();
+    store_.Add(light_);
   }
+  RefreshSlots();
 } /* AddLight() */
 
 void Arena::AddFood(int quantity) {
   for (int i = 0; i < quantity; i++) {
-    food_ = dynamic_cast<Food *>(factory_->CreateEntity(kFood));
-    entities_.push_back(food_);
-    food_entities_.push_back(food_);
+    food_ = factory_->CreateFood();
+    store_.Add(food_);
   }
+  RefreshSlots();
 } /* AddFood() */
 
 void Arena::AddEntity(EntityType type, int quantity) {
   for (int i = 0; i < quantity; i++) {
-    entities_.push_back(factory_->CreateEntity(type));
+    store_.Add(factory_->CreateEntity(type));
   }
+  RefreshSlots();
 } /* AddEntity() */
 
+void Arena::RefreshSlots() {
+  robots_.Refresh(store_, kRobot);
+  lights_.Refresh(store_, kLight);
+  foods_.Refresh(store_, kFood);
+  food_grid_stale_ = food_field_stale_ = true;
+} /* RefreshSlots() */
+
 // The primary driver of simulation movement. Called from the Controller
 // but originated from the graphics viewer.
-void Arena::AdvanceTime(double dt) {
-  if (!(dt > 0) && game_status_ != 2) {
-    return;
-  }
-  for (size_t i = 0; i < 1; ++i) {
+void Arena::AdvanceTime(int steps) {
+  for (int i = 0; i < steps; ++i) {
+    if (i > 0 && game_status_ != PLAYING) {
+      break;
+    }
     UpdateEntitiesTimestep();
   } /* for(i..) */
 } /* AdvanceTime() */
 
 void Arena::UpdateEntitiesTimestep() {
-  /*
-   * Update the position of all entities, according to their current
-   * velocities.
-   */
-  for (auto ent : entities_) {
-    ent->TimestepUpdate(1);
-  }
-
+  PROFILE_PHASE(&profiler_, kPhaseStep);
+  UpdatePoses();
   UpdateHunger();
   UpdateSensors();
   UpdateCollisions();
   } /* UpdateEntitiesTimestep() */
 
+void Arena::UpdatePoses() {
+  PROFILE_PHASE(&profiler_, kPhaseTimestep);
+  /*
+   * Update the state and wheel velocities of all entities, then move them
+   * with one batched kinematics pass over contiguous copies of their poses.
+   * Robots come first, then lights; food never moves, so it is skipped. Each
+   * batch has a static type, so the calls are not virtual.
+   */
+  size_t n_robots = robots_.size();
+  size_t n_movers = n_robots + lights_.size();
+  drive_x_.resize(n_movers);
+  drive_y_.resize(n_movers);
+  drive_theta_.resize(n_movers);
+  drive_left_.resize(n_movers);
+  drive_right_.resize(n_movers);
+  pool_.ParallelFor(n_movers,
+                    [this, n_robots](size_t begin, size_t end, size_t) {
+    auto slot = [this, n_robots](size_t i) {
+      return i < n_robots ? robots_.slot(i) : lights_.slot(i - n_robots);
+    };
+    for (size_t i = begin; i < end; ++i) {
+      bool moves = i < n_robots ? robots_.entity(i)->UpdateControl() :
+                                  lights_.entity(i - n_robots)->UpdateControl();
+      int s = slot(i);
+      drive_x_[i] = store_.x[s];
+      drive_y_[i] = store_.y[s];
+      drive_theta_[i] = store_.theta[s];
+      // Zero wheel velocities leave the pose of an entity that is not moving
+      // exactly as it is.
+      drive_left_[i] = moves ? store_.vel_left[s] : 0;
+      drive_right_[i] = moves ? store_.vel_right[s] : 0;
+    }
+    IntegrateDifferentialDrive(&drive_x_[begin], &drive_y_[begin],
+                               &drive_theta_[begin], &drive_left_[begin],
+                               &drive_right_[begin], end - begin, 1);
+    for (size_t i = begin; i < end; ++i) {
+      int s = slot(i);
+      store_.x[s] = drive_x_[i];
+      store_.y[s] = drive_y_[i];
+      store_.theta[s] = drive_theta_[i];
+    }
+  });
+} /* UpdatePoses() */
+
 void Arena::UpdateHunger() {
+  PROFILE_PHASE(&profiler_, kPhaseHunger);
   // First, check if any robot has starved.
-  for (auto robot : robot_entities_) {
-    robot_ = dynamic_cast<Robot *>(robot);
-    if (robot_->CheckStarvation()) {
+  for (int r : robots_.slots()) {
+    if (store_.starved[r]) {
      game_status_ = LOST;
-     robot_->set_color(ROBOT_COLOR_LOST);
+     if (record_events_ &&
+         store_.entity[r]->get_color() != RgbColor(ROBOT_COLOR_LOST)) {
+       events_.push_back({kEventStarved, store_.entity[r]->get_id(), -1});
+     }
+     store_.entity[r]->set_color(ROBOT_COLOR_LOST);
     }
   }
-  // Next, determine if a robot has captured food
-  for (auto &ent1 : robot_entities_) {
-    for (auto &ent2 : food_entities_) {
-      if (IsFoodCaptured(ent1, ent2)) {
-        robot_ = dynamic_cast<Robot *>(ent1);
-        robot_->ResetHunger();
+  if (foods_.empty()) {
+    return;
+  }
+  // Next, determine if a robot has captured food. Only the food in the
+  // neighboring cells of the food grid can be close enough.
+  double max_radius = 0;
+  for (int r : robots_.slots()) {
+    max_radius = std::max(max_radius, store_.radius[r]);
+  }
+  RebuildFoodGrid(max_radius);
+  pool_.ParallelFor(robots_.size(),
+                    [this](size_t begin, size_t end, size_t thread) {
+    std::vector<int> *candidates = &grid_candidates_[thread];
+    for (size_t i = begin; i < end; ++i) {
+      int r = robots_.slot(i);
+      food_grid_.Query(store_.x[r], store_.y[r], candidates);
+      for (int j : *candidates) {
+        int f = foods_.slot(j);
+        double delta_x = store_.x[f] - store_.x[r];
+        double delta_y = store_.y[f] - store_.y[r];
+        double reach = store_.radius[r] + store_.radius[f] + 5;
+        if (delta_x*delta_x + delta_y*delta_y <= reach*reach) {
+          robots_.entity(i)->ResetHunger();
+          RecordEvent(thread, kEventFoodCaptured, robots_.entity(i)->get_id(),
+                      foods_.entity(j)->get_id());
+          break;
+        }
       }
     }
-  }
+  });
+  MergeEvents();
 } /* UpdateHunger() */
 
+void Arena::RebuildFoodGrid(double max_robot_radius) {
+  // Food never moves, so the grid only changes with the set of food, or when
+  // a bigger Robot needs larger cells.
+  if (!food_grid_stale_ &&
+      food_grid_.get_cell_size() >= max_robot_radius + max_food_radius_ + 5) {
+    return;
+  }
+  max_food_radius_ = 0;
+  for (int f : foods_.slots()) {
+    max_food_radius_ = std::max(max_food_radius_, store_.radius[f]);
+  }
+  food_grid_.Resize(x_dim_, y_dim_, max_robot_radius + max_food_radius_ + 5);
+  for (size_t i = 0; i < foods_.size(); ++i) {
+    food_grid_.Insert(static_cast<int>(i), store_.x[foods_.slot(i)],
+                      store_.y[foods_.slot(i)]);
+  }
+  food_grid_stale_ = false;
+} /* RebuildFoodGrid() */
+
 void Arena::UpdateSensors() {
+  PROFILE_PHASE(&profiler_, kPhaseSensors);
+  bool use_fields = field_resolution_ > 0;
+  if (use_fields) {
+    RebuildIntensityFields();
+  } else {
+    // Gather the light and food positions once for all robots.
+    GatherPositions(lights_.slots(), &light_x_, &light_y_);
+    GatherPositions(foods_.slots(), &food_x_, &food_y_);
+  }
+
+  // Robot i owns sensors 2i (left) and 2i+1 (right) of the batch arrays.
+  size_t n_sensors = 2 * robots_.size();
+  sensor_x_.resize(n_sensors);
+  sensor_y_.resize(n_sensors);
+  light_gain_.resize(n_sensors);
+  food_gain_.assign(n_sensors, 2000);
+  light_reading_.resize(n_sensors);
+  food_reading_.resize(n_sensors);
+
   // Update readings for all sensors and robots actions accordingly
-  for (auto robot : robot_entities_) {
-    robot_ = dynamic_cast<Robot *>(robot);
-    for (auto ent : light_entities_) {
-      // Update robots light sensors based on reading
-      robot_->NotifyLights(ent->get_pose());
+  pool_.ParallelFor(robots_.size(),
+                    [this, use_fields](size_t begin, size_t end, size_t) {
+    for (size_t i = begin; i < end; ++i) {
+      int r = robots_.slot(i);
+      Robot *robot = robots_.entity(i);
+      sensor_x_[2*i] = store_.left_sensor_x[r];
+      sensor_y_[2*i] = store_.left_sensor_y[r];
+      sensor_x_[2*i+1] = store_.right_sensor_x[r];
+      sensor_y_[2*i+1] = store_.right_sensor_y[r];
+      light_gain_[2*i] = light_gain_[2*i+1] =
+        2000 * robot->get_light_sensitivity();
+      light_reading_[2*i] = robot->get_left_light_sensor()->GetReading();
+      light_reading_[2*i+1] = robot->get_right_light_sensor()->GetReading();
+      food_reading_[2*i] = robot->get_left_food_sensor()->GetReading();
+      food_reading_[2*i+1] = robot->get_right_food_sensor()->GetReading();
     }
-    for (auto ent : food_entities_) {
-      // Update robots food sensors based on reading
-      robot_->NotifyFood(ent->get_pose());
+    size_t first = 2 * begin;
+    size_t count = 2 * (end - begin);
+    if (use_fields) {
+      for (size_t s = first; s < first + count; ++s) {
+        light_reading_[s] = std::min(1000.0, light_reading_[s] +
+          light_gain_[s] * light_field_.Sample(sensor_x_[s], sensor_y_[s]));
+        food_reading_[s] = std::min(1000.0, food_reading_[s] +
+          food_gain_[s] * food_field_.Sample(sensor_x_[s], sensor_y_[s]));
+      }
+    } else {
+      AccumulateSensorReadings(&sensor_x_[first], &sensor_y_[first],
+                               &light_gain_[first], count, light_x_.data(),
+                               light_y_.data(), light_x_.size(),
+                               &light_reading_[first]);
+      AccumulateSensorReadings(&sensor_x_[first], &sensor_y_[first],
+                               &food_gain_[first], count, food_x_.data(),
+                               food_y_.data(), food_x_.size(),
+                               &food_reading_[first]);
     }
-  }
+    for (size_t i = begin; i < end; ++i) {
+      Robot *robot = robots_.entity(i);
+      robot->get_left_light_sensor()->set_reading(light_reading_[2*i]);
+      robot->get_right_light_sensor()->set_reading(light_reading_[2*i+1]);
+      robot->get_left_food_sensor()->set_reading(food_reading_[2*i]);
+      robot->get_right_food_sensor()->set_reading(food_reading_[2*i+1]);
+    }
+  });
 } /* UpdateSensors() */
 
+void Arena::RebuildIntensityFields() {
+  GatherPositions(lights_.slots(), &light_x_, &light_y_);
+  pool_.ParallelFor(light_field_.size(),
+                    [this](size_t begin, size_t end, size_t) {
+    light_field_.Compute(begin, end, light_x_.data(), light_y_.data(),
+                         light_x_.size());
+  });
+  if (!food_field_stale_) {
+    return;
+  }
+  GatherPositions(foods_.slots(), &food_x_, &food_y_);
+  pool_.ParallelFor(food_field_.size(),
+                    [this](size_t begin, size_t end, size_t) {
+    food_field_.Compute(begin, end, food_x_.data(), food_y_.data(),
+                        food_x_.size());
+  });
+  food_field_stale_ = false;
+} /* RebuildIntensityFields() */
+
+void Arena::GatherPositions(const std::vector<int> &slots,
+                            std::vector<double> *x,
+                            std::vector<double> *y) const {
+  x->resize(slots.size());
+  y->resize(slots.size());
+  for (size_t i = 0; i < slots.size(); ++i) {
+    (*x)[i] = store_.x[slots[i]];
+    (*y)[i] = store_.y[slots[i]];
+  }
+} /* GatherPositions() */
+
 void Arena::UpdateCollisions() {
-  /* Determine if any mobile entity is colliding with wall.
-  * Adjust the position accordingly so it doesn't overlap.
+  PROFILE_PHASE(&profiler_, kPhaseCollisions);
+  /* Determine if any light is colliding with wall.
+  * Lights hover above everything else, so walls are all they can hit.
   */
-  for (auto &ent1 : mobile_entities_) {
-  EntityType wall = GetCollisionWall(ent1);
-    if (kUndefined != wall) {
-     AdjustWallOverlap(ent1, wall);
-     if (ent1->get_type() == kLight) {
-       light_ = dynamic_cast<Light *>(ent1);
-       light_->HandleCollision();
-     } else {
-       robot_ = dynamic_cast<Robot *>(ent1);
-       robot_->HandleCollision();
-     }
+  pool_.ParallelFor(lights_.size(),
+                    [this](size_t begin, size_t end, size_t thread) {
+    for (size_t i = begin; i < end; ++i) {
+      int l = lights_.slot(i);
+      EntityType wall = SlotCollisionWall(l);
+      if (kUndefined != wall) {
+        AdjustSlotWallOverlap(l, wall);
+        lights_.entity(i)->HandleCollision();
+        RecordEvent(thread, kEventLightHitWall, lights_.entity(i)->get_id(),
+                    wall);
+      }
     }
+  });
+  MergeEvents();
 
-     /* Determine if that mobile entity is colliding with any other entity.
-     * Adjust the position accordingly so they don't overlap.
-     */
-    for (auto &ent2 : entities_) {
-      if (ent2 == ent1) { continue; }
-      if (IsColliding(ent1, ent2)) {
-       if (ent1->get_type() == kRobot) {
-         if (ent2->get_type() == kRobot) {
-           AdjustEntityOverlap(ent1, ent2);
-           robot_ = dynamic_cast<Robot *>(ent1);
-           robot_->HandleCollision();
-           robot_ = dynamic_cast<Robot *>(ent2);
-           robot_->HandleCollision();
-         }
-       }
+  // Back robots off the walls before looking at robot overlaps.
+  pool_.ParallelFor(robots_.size(),
+                    [this](size_t begin, size_t end, size_t thread) {
+    for (size_t i = begin; i < end; ++i) {
+      int r = robots_.slot(i);
+      EntityType wall = SlotCollisionWall(r);
+      if (kUndefined != wall) {
+        AdjustSlotWallOverlap(r, wall);
+        robots_.entity(i)->HandleCollision();
+        RecordEvent(thread, kEventRobotHitWall, robots_.entity(i)->get_id(),
+                    wall);
       }
     }
-  }
+  });
+  MergeEvents();
+
+  /* Determine if each robot is colliding with any other robot. All of the
+  * displacements are computed before any robot moves.
+  */
+  RebuildRobotGrid();
+  collision_dx_.assign(robots_.size(), 0);
+  collision_dy_.assign(robots_.size(), 0);
+  collided_.assign(robots_.size(), 0);
+  pool_.ParallelFor(robots_.size(),
+                    [this](size_t begin, size_t end, size_t thread) {
+    ComputeRobotOverlaps(begin, end, thread);
+  });
+  MergeEvents();
+  pool_.ParallelFor(robots_.size(),
+                    [this](size_t begin, size_t end, size_t) {
+    for (size_t i = begin; i < end; ++i) {
+      if (collided_[i]) {
+        int r = robots_.slot(i);
+        store_.x[r] += collision_dx_[i];
+        store_.y[r] += collision_dy_[i];
+        robots_.entity(i)->HandleCollision();
+      }
+    }
+  });
 } /* UpdateCollisions() */
 
+void Arena::ComputeRobotOverlaps(size_t begin, size_t end, size_t thread) {
+  std::vector<int> *candidates = &grid_candidates_[thread];
+  for (size_t i = begin; i < end; ++i) {
+    int r1 = robots_.slot(i);
+    robot_grid_.Query(store_.x[r1], store_.y[r1], candidates);
+    // Sum in a fixed order so the floating point result is reproducible.
+    std::sort(candidates->begin(), candidates->end());
+    for (int j : *candidates) {
+      if (static_cast<size_t>(j) == i) { continue; }
+      int r2 = robots_.slot(j);
+      if (!SlotsColliding(r1, r2)) { continue; }
+      double delta_x = store_.x[r1] - store_.x[r2];
+      double delta_y = store_.y[r1] - store_.y[r2];
+      double distance_between = sqrt(delta_x*delta_x + delta_y*delta_y);
+      double distance_to_move =
+        (store_.radius[r1] + store_.radius[r2] - distance_between + 5) / 2;
+      double angle = atan2(delta_y, delta_x);
+      // Robots on top of one another are pushed apart along the x axis.
+      if (!(distance_between > 0) && static_cast<size_t>(j) > i) {
+        angle = M_PI;
+      }
+      collision_dx_[i] += cos(angle)*distance_to_move;
+      collision_dy_[i] += sin(angle)*distance_to_move;
+      collided_[i] = 1;
+      // Each pair is seen from both sides; report it once.
+      if (static_cast<size_t>(j) > i) {
+        RecordEvent(thread, kEventRobotCollision, robots_.entity(i)->get_id(),
+                    robots_.entity(j)->get_id());
+      }
+    }
+  }
+} /* ComputeRobotOverlaps() */
+
+void Arena::MergeEvents() {
+  if (!record_events_) {
+    return;
+  }
+  for (std::vector<ArenaEvent> &events : thread_events_) {
+    events_.insert(events_.end(), events.begin(), events.end());
+    events.clear();
+  }
+} /* MergeEvents() */
+
+void Arena::RebuildRobotGrid() {
+  double max_radius = 0;
+  for (int r : robots_.slots()) {
+    max_radius = std::max(max_radius, store_.radius[r]);
+  }
+  double cell_size = std::max(2 * max_radius, 1.0);
+  // Only reallocate the cells when the largest robot changes size.
+  if (robot_grid_.get_cell_size() < cell_size ||
+      robot_grid_.get_cell_size() > cell_size) {
+    robot_grid_.Resize(x_dim_, y_dim_, cell_size);
+  } else {
+    robot_grid_.Clear();
+  }
+  for (size_t i = 0; i < robots_.size(); ++i) {
+    robot_grid_.Insert(static_cast<int>(i), store_.x[robots_.slot(i)],
+                       store_.y[robots_.slot(i)]);
+  }
+} /* RebuildRobotGrid() */
+
+EntityType Arena::SlotCollisionWall(int slot) const {
+  double x = store_.x[slot];
+  double y = store_.y[slot];
+  double radius = store_.radius[slot];
+  if (x + radius >= x_dim_) {
+    return kRightWall;
+  }
+  if (x - radius <= 0) {
+    return kLeftWall;
+  }
+  if (y + radius >= y_dim_) {
+    return kBottomWall;
+  }
+  if (y - radius <= 0) {
+    return kTopWall;
+  }
+  return kUndefined;
+} /* SlotCollisionWall() */
+
+void Arena::AdjustSlotWallOverlap(int slot, EntityType wall) {
+  double radius = store_.radius[slot];
+  switch (wall) {
+    case (kRightWall):
+    store_.x[slot] = x_dim_-(radius+5);
+    break;
+    case (kLeftWall):
+    store_.x[slot] = radius+5;
+    break;
+    case (kTopWall):
+    store_.y[slot] = radius+5;
+    break;
+    case (kBottomWall):
+    store_.y[slot] = y_dim_-(radius+5);
+    break;
+    default:
+    {}
+  }
+} /* AdjustSlotWallOverlap() */
+
+bool Arena::SlotsColliding(int mobile, int other) const {
+  double delta_x = store_.x[other] - store_.x[mobile];
+  double delta_y = store_.y[other] - store_.y[mobile];
+  double distance_between = sqrt(delta_x*delta_x + delta_y*delta_y);
+  return (distance_between <= (store_.radius[mobile] + store_.radius[other]));
+} /* SlotsColliding() */
+
 // Determine if the entity is colliding with a wall.
 // Always returns an entity type. If not collision, returns kUndefined.
 EntityType Arena::GetCollisionWall(ArenaMobileEntity *const ent) {
@@ -267,17 +614,15 @@ void Arena::AcceptCommand(Communication com) {
       set_game_status(PAUSED);
       break;
     case (kFoodOn) :
-      for (auto robot : robot_entities_) {
-        robot_ = dynamic_cast<Robot *>(robot);
-        robot_->SetHunger(true);
+      for (Robot *robot : robots_.entities()) {
+        robot->SetHunger(true);
       }
       break;
     case (kFoodOff) :
       EmptyFoodEntities();
-      for (auto robot : robot_entities_) {
-        robot_ = dynamic_cast<Robot *>(robot);
-        robot_->SetHunger(false);
-        robot_->ResetHunger();
+      for (Robot *robot : robots_.entities()) {
+        robot->SetHunger(false);
+        robot->ResetHunger();
       }
       break;
     case (kNone):
@@ -285,36 +630,159 @@ void Arena::AcceptCommand(Communication com) {
   }
 } /* AcceptCommand() */
 
-// Removes all entities from the arena.
-void Arena::EmptyEntities() {
-  while (!entities_.empty()) {
-    entities_.pop_back();
+void Arena::FillSnapshot(RenderSnapshot *snapshot) const {
+  snapshot->entities.resize(store_.size());
+  for (size_t i = 0; i < store_.size(); ++i) {
+    RenderEntity &out = snapshot->entities[i];
+    out.type = store_.type[i];
+    out.id = store_.entity[i]->get_id();
+    out.x = store_.x[i];
+    out.y = store_.y[i];
+    out.radius = store_.radius[i];
+    out.color = store_.entity[i]->get_color();
   }
-  while (!mobile_entities_.empty()) {
-    mobile_entities_.pop_back();
+  for (int r : robots_.slots()) {
+    RenderEntity &out = snapshot->entities[r];
+    out.left_sensor_x = store_.left_sensor_x[r];
+    out.left_sensor_y = store_.left_sensor_y[r];
+    out.right_sensor_x = store_.right_sensor_x[r];
+    out.right_sensor_y = store_.right_sensor_y[r];
   }
-  while (!robot_entities_.empty()) {
-    robot_entities_.pop_back();
+  snapshot->x_dim = x_dim_;
+  snapshot->y_dim = y_dim_;
+  snapshot->game_status = game_status_;
+#ifdef ARENA_PROFILE
+  for (int p = 0; p < kPhaseCount; ++p) {
+    snapshot->phase_stats[p] = profiler_.Stats(static_cast<ProfilePhase>(p));
   }
-  while (!light_entities_.empty()) {
-    light_entities_.pop_back();
+#endif
+} /* FillSnapshot() */
+
+bool Arena::SaveCheckpoint(const std::string &path) {
+  CheckpointFile file;
+  if (!file.Create(path, store_.size())) {
+    return false;
+  }
+  CheckpointHeader *header = file.header();
+  header->rng_seed = rng_.get_seed();
+  rng_.get_state(header->rng_state);
+  header->x_dim = x_dim_;
+  header->y_dim = y_dim_;
+  header->light_sensitivity = light_sensitivity_;
+  header->game_status = game_status_;
+  factory_->SaveCounts(header);
+
+  // Each record is written by one thread only: the fields every entity has
+  // by store slot, then the rest by type.
+  CheckpointEntity *records = file.entities();
+  pool_.ParallelFor(store_.size(),
+                    [this, records](size_t begin, size_t end, size_t) {
+    for (size_t i = begin; i < end; ++i) {
+      const ArenaEntity *ent = store_.entity[i];
+      CheckpointEntity *record = &records[i];
+      record->type = store_.type[i];
+      record->id = ent->get_id();
+      record->color[0] = ent->get_color().r;
+      record->color[1] = ent->get_color().g;
+      record->color[2] = ent->get_color().b;
+      record->x = store_.x[i];
+      record->y = store_.y[i];
+      record->theta = store_.theta[i];
+      record->radius = store_.radius[i];
+    }
+  });
+  size_t n_robots = robots_.size();
+  pool_.ParallelFor(n_robots + lights_.size(),
+                    [this, records, n_robots](size_t begin, size_t end,
+                                              size_t) {
+    for (size_t i = begin; i < std::min(end, n_robots); ++i) {
+      robots_.entity(i)->SaveState(&records[robots_.slot(i)]);
+    }
+    for (size_t i = std::max(begin, n_robots); i < end; ++i) {
+      size_t l = i - n_robots;
+      lights_.entity(l)->SaveState(&records[lights_.slot(l)]);
+    }
+  });
+  return file.Commit();
+} /* SaveCheckpoint() */
+
+bool Arena::LoadCheckpoint(const std::string &path) {
+  CheckpointFile file;
+  if (!file.Open(path)) {
+    return false;
   }
-  while (!food_entities_.empty()) {
-    food_entities_.pop_back();
+  const CheckpointHeader &header = *file.header();
+  const CheckpointEntity *records = file.entities();
+  size_t n = static_cast<size_t>(header.n_entities);
+  for (size_t i = 0; i < n; ++i) {
+    if (records[i].type != kRobot && records[i].type != kLight &&
+        records[i].type != kFood) {
+      return false;
+    }
   }
-} /* EmptyEntities() */
 
-// Removes all food entities from the arena.
-void Arena::EmptyFoodEntities() {
-  for (unsigned int i = 0; i < entities_.size(); i++) {
-    if (entities_[i]->get_type() == kFood) {
-      entities_.erase(entities_.begin() + i);
-      i--;  // Maintains succeeding vector iterations.
+  EmptyEntities();
+  x_dim_ = header.x_dim;
+  y_dim_ = header.y_dim;
+  light_sensitivity_ = header.light_sensitivity;
+  game_status_ = header.game_status;
+  rng_.set_state(header.rng_seed, header.rng_state);
+  factory_->LoadCounts(header);
+
+  // Entities are constructed directly in the pools, not by the factory,
+  // which would draw random positions and advance the ids.
+  for (size_t i = 0; i < n; ++i) {
+    const CheckpointEntity &record = records[i];
+    ArenaEntity *ent;
+    switch (record.type) {
+      case kRobot: ent = robot_ = entities_.robots.Create(); break;
+      case kLight: ent = light_ = entities_.lights.Create(); break;
+      default: ent = food_ = entities_.foods.Create(); break;
     }
+    ent->set_type(static_cast<EntityType>(record.type));
+    ent->set_id(record.id);
+    ent->set_color(RgbColor(record.color[0], record.color[1],
+                            record.color[2]));
+    ent->set_pose(Pose(record.x, record.y, record.theta));
+    ent->set_radius(record.radius);
+    store_.Add(ent);
   }
-  while (!food_entities_.empty()) {
-    food_entities_.pop_back();
+  RefreshSlots();
+  size_t n_robots = robots_.size();
+  pool_.ParallelFor(n_robots + lights_.size(),
+                    [this, records, n_robots](size_t begin, size_t end,
+                                              size_t) {
+    for (size_t i = begin; i < std::min(end, n_robots); ++i) {
+      robots_.entity(i)->LoadState(records[robots_.slot(i)]);
+    }
+    for (size_t i = std::max(begin, n_robots); i < end; ++i) {
+      size_t l = i - n_robots;
+      lights_.entity(l)->LoadState(records[lights_.slot(l)]);
+    }
+  });
+  if (field_resolution_ > 0) {
+    light_field_.Resize(x_dim_, y_dim_, field_resolution_);
+    food_field_.Resize(x_dim_, y_dim_, field_resolution_);
   }
+  return true;
+} /* LoadCheckpoint() */
+
+// Removes all entities from the arena.
+void Arena::EmptyEntities() {
+  store_.Release();
+  RefreshSlots();
+  entities_.Clear();
+  robot_ = nullptr;
+  light_ = nullptr;
+  food_ = nullptr;
+} /* EmptyEntities() */
+
+// Removes all food entities from the arena.
+void Arena::EmptyFoodEntities() {
+  store_.RemoveType(kFood);
+  RefreshSlots();
+  entities_.foods.Clear();
+  food_ = nullptr;
 } /* EmptyFoodEntities() */
 
 NAMESPACE_END(csci3081);
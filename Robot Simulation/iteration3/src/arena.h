@@ -12,14 +12,24 @@
  ******************************************************************************/
 #include <cmath>
 #include <iostream>
+#include <string>
 #include <vector>
 
+#include "src/arena_event.h"
+#include "src/checkpoint.h"
 #include "src/common.h"
 #include "src/food.h"
 #include "src/entity_factory.h"
+#include "src/entity_batch.h"
 #include "src/robot.h"
 #include "src/communication.h"
+#include "src/entity_store.h"
+#include "src/intensity_field.h"
 #include "src/params.h"
+#include "src/phase_profiler.h"
+#include "src/render_snapshot.h"
+#include "src/spatial_grid.h"
+#include "src/thread_pool.h"
 
 /*******************************************************************************
  * Namespaces
@@ -39,6 +49,14 @@ struct arena_params;
  * data and all the entities (it is the model of MVC). It manages the
  * interaction among the entities in the Arena.
  *
+ * The state touched every timestep (poses, radii, velocities, hunger, sensor
+ * positions) lives in an EntityStore, and the per-step loops walk its arrays.
+ * Entity objects remain the owners of everything else and act as views onto
+ * their slot of the store.
+ *
+ * Each phase of a timestep is split across a ThreadPool (arena_params::
+ * n_threads). Every phase only writes the state of the entity it is working
+ * on, so the result does not depend on the number of threads.
  */
 
 class Arena {
@@ -54,21 +72,21 @@ class Arena {
   explicit Arena(const struct arena_params *const params);
 
   /**
-   * @brief Arena's destructor. `delete` all entities created.
+   * @brief Arena's destructor. All entities are destroyed with the pool.
    */
   ~Arena();
 
   /**
    * @brief Advance the simulation by the specified # of steps.
    *
-   * @param[in] dt The # of steps to increment by. This is
-   * practically unused because the arena state is advanced
-   * incrementally at a fixed rate.
+   * @param[in] steps The # of timesteps to take. Each calls
+   * Arena::UpdateEntitiesTimestep() once. The Controller converts wall clock
+   * time into steps (see StepAccumulator).
    *
-   * If `dt == 0`, `return` immediately. Otherwise calls
-   * Arena::UpdateEntitiesTimestep() once.
+   * At least one step is always taken when `steps > 0`; after that, stepping
+   * stops early if the game is no longer being played (e.g. a Robot starved).
    */
-  void AdvanceTime(double dt);
+  void AdvanceTime(int steps);
 
   /**
    * @brief Adds the specified number of robot types to the arena.
@@ -194,46 +212,150 @@ class Arena {
    *
    * First calls each entity's TimestepUpdate method to update their speed,
    * heading angle, and position. Then check for collisions between entities
-   * or between an entity and a wall.
+   * or between an entity and a wall. Each step is run in parallel when the
+   * Arena has more than one thread.
    */
   void UpdateEntitiesTimestep();
 
+  /**
+   * @brief Does what each moving entity's TimestepUpdate method does: calls
+   * its UpdateControl method, then moves all of them with one call to
+   * IntegrateDifferentialDrive().
+   */
+  void UpdatePoses();
+
   /**
    * @brief Checks for starvation level in each Robot.
    *
    * Checks if Robots have captured food and updates hunger levels accordingly.
+   * Food is binned into a grid, so each Robot is only tested against the food
+   * in neighboring cells.
    */
   void UpdateHunger();
 
   /**
    * @brief Updates the Robots' sensors with the latest Food & Light locations.
    *
-   * From these locations, sensor readings are calculated.
+   * From these locations, sensor readings are calculated. All of the sensors
+   * (two per Robot) are evaluated in a batch by AccumulateSensorReadings(),
+   * or, when arena_params::field_resolution is set, sampled from the
+   * IntensityField of the lights and of the food.
    */
   void UpdateSensors();
 
   /**
    * @brief Checks for collision between Robots.
    *
-   * Checks for collision between any mobile entitiy and any wall.
+   * Checks for collision between any mobile entitiy and any wall. Robots are
+   * binned into a uniform grid first so that each Robot is only tested
+   * against the Robots in neighboring cells rather than every entity.
+   *
+   * Robot overlaps are resolved simultaneously: every Robot computes how far
+   * to move from the positions at the start of the pass, and then all of
+   * them move. Each Robot in an overlapping pair moves half the distance, so
+   * the pair ends up separated as if one of them had moved all the way. This
+   * makes the result independent of the order Robots are visited in.
    */
   void UpdateCollisions();
 
   /**
-   * @brief Removes all entities from the arena.
+   * @brief Removes and destroys all entities in the arena.
    *
-   * Removes entities until all vectors (entities_, etc.) are empty.
+   * Empties the store and the slot lists, and rewinds the entity pool, so
+   * the memory is reused by the next entities.
    */
   void EmptyEntities();
 
   /**
    * @brief Removes all food entities from the arena.
    *
-   * Removes food entities until the vector food_entities_ is empty.
+   * Removes the food slots from the store (the remaining entities keep
+   * their order) and destroys the food entities.
    */
   void EmptyFoodEntities();
 
-  std::vector<class ArenaEntity *> get_entities() const { return entities_; }
+  /**
+   * @brief Tell the Arena that food has been repositioned.
+   *
+   * Food is immobile, so the grid used to find captured food and the food
+   * intensity field are only rebuilt when food is added or removed. Call
+   * this after moving food through its set_position() once the Arena has
+   * started stepping.
+   */
+  void FoodMoved() { food_grid_stale_ = food_field_stale_ = true; }
+
+  /**
+   * @brief Copy everything needed to draw the Arena into `snapshot`,
+   * overwriting what it held.
+   */
+  void FillSnapshot(RenderSnapshot *snapshot) const;
+
+  /**
+   * @brief Write the complete state of the Arena to a checkpoint file at
+   * `path` (see CheckpointFile). The records are filled in parallel, in
+   * the Arena's thread pool.
+   *
+   * @return false, leaving any file at `path` unchanged, on failure.
+   */
+  bool SaveCheckpoint(const std::string &path);
+
+  /**
+   * @brief Replace the entities and state of the Arena with those saved by
+   * SaveCheckpoint(). Stepping the restored Arena gives exactly what
+   * stepping the saved one would have.
+   *
+   * @return false, leaving the Arena unchanged, if the file cannot be read
+   * or was not written by this version of the simulation.
+   */
+  bool LoadCheckpoint(const std::string &path);
+
+  /**
+   * @brief Collect an ArenaEvent for each food capture, starvation and
+   * collision from now on (off by default, as it costs time). Events are
+   * kept, in the order they happened, until ClearEvents().
+   */
+  void set_record_events(bool record) { record_events_ = record; }
+  const std::vector<ArenaEvent> &get_events() const { return events_; }
+  void ClearEvents() { events_.clear(); }
+
+  std::vector<class ArenaEntity *> get_entities() const {
+    return store_.entity;
+  }
+
+  const EntityStore &get_store() const { return store_; }
+  const EntityBatch<Robot> &get_robots() const { return robots_; }
+
+  size_t get_n_robots() const { return robots_.size(); }
+  size_t get_n_lights() const { return lights_.size(); }
+  size_t get_n_foods() const { return foods_.size(); }
+
+  size_t get_n_threads() const { return pool_.get_n_threads(); }
+
+  /**
+   * @brief The seed of the Arena's Rng: arena_params::seed, or the one picked
+   * at random if that was 0. Building an Arena with it reproduces this one.
+   */
+  uint64_t get_seed() const { return rng_.get_seed(); }
+
+#ifdef ARENA_PROFILE
+  /**
+   * @brief Timing statistics of a phase of UpdateEntitiesTimestep() over the
+   * last PROFILE_WINDOW timesteps. Only built with -DARENA_PROFILE.
+   */
+  PhaseStats get_phase_stats(ProfilePhase phase) const {
+    return profiler_.Stats(phase);
+  }
+#endif
+
+  /**
+   * @brief Write the statistics of every phase as CSV. Writes nothing unless
+   * built with -DARENA_PROFILE.
+   */
+#ifdef ARENA_PROFILE
+  void WriteProfileCsv(std::ostream &out) const { profiler_.WriteCsv(out); }
+#else
+  void WriteProfileCsv(std::ostream &) const {}
+#endif
 
   double get_x_dim() { return x_dim_; }
   double get_y_dim() { return y_dim_; }
@@ -245,10 +367,85 @@ class Arena {
   void set_light_sensitivity(double sens) { light_sensitivity_ = sens; }
 
  private:
+  /**
+   * @brief Re-bin every Robot into robot_grid_ at its current position.
+   *
+   * The cell size is the diameter of the largest Robot, which is the largest
+   * distance at which two Robots can collide.
+   */
+  void RebuildRobotGrid();
+
+  /**
+   * @brief Bin every Food into food_grid_, if the food has changed since the
+   * last time or the cells are too small.
+   *
+   * The cell size is the largest distance at which a Robot captures food:
+   * the radii of the largest Robot and Food plus 5.
+   *
+   * @param[in] max_robot_radius Radius of the largest Robot.
+   */
+  void RebuildFoodGrid(double max_robot_radius);
+
+  /**
+   * @brief Recompute light_field_ from the current light positions, and
+   * food_field_ if the food has changed since the last time.
+   */
+  void RebuildIntensityFields();
+
+  /**
+   * @brief Recompute the robots_, lights_ and foods_ batches after entities
+   * are added to or removed from the store.
+   */
+  void RefreshSlots();
+
+  /**
+   * @brief Store-based versions of GetCollisionWall(), AdjustWallOverlap(),
+   * IsColliding() and AdjustEntityOverlap(), operating on slots. The
+   * arithmetic is identical to the pointer-based versions.
+   */
+  EntityType SlotCollisionWall(int slot) const;
+  void AdjustSlotWallOverlap(int slot, EntityType wall);
+  bool SlotsColliding(int mobile, int other) const;
+
+  /**
+   * @brief Compute the displacement of the Robots in robots_[begin, end)
+   * that resolves their overlap with other Robots, into collision_dx_ and
+   * collision_dy_. Positions are not modified.
+   *
+   * @param[in] thread The thread running the loop, whose scratch list and
+   * events are used.
+   */
+  void ComputeRobotOverlaps(size_t begin, size_t end, size_t thread);
+
+  /**
+   * @brief Note an event seen by a thread of a parallel loop, if events are
+   * being recorded. MergeEvents() then appends every thread's events to
+   * events_; threads work on ascending ranges, so the order is the same
+   * whatever the number of threads.
+   */
+  void RecordEvent(size_t thread, ArenaEventType type, int id, int other) {
+    if (record_events_) {
+      thread_events_[thread].push_back({type, id, other});
+    }
+  }
+  void MergeEvents();
+
+  /**
+   * @brief Copy the positions of the entities in `slots` into x and y.
+   */
+  void GatherPositions(const std::vector<int> &slots, std::vector<double> *x,
+                       std::vector<double> *y) const;
+
   // Dimensions of graphics window inside which entities must operate
   double x_dim_;
   double y_dim_;
 
+  // Memory holding all entities within the arena
+  EntityPool entities_;
+
+  // Source of every random choice made for this arena
+  Rng rng_;
+
   // Used to create all entities within the arena
   EntityFactory *factory_;
 
@@ -264,23 +461,81 @@ class Arena {
   // Used to determine the sensitivity of robots to light
   double light_sensitivity_{0};
 
-  // All entities mobile and immobile.
-  std::vector<class ArenaEntity *> entities_;
+  // All entities mobile and immobile, and their per-step state.
+  EntityStore store_;
 
-  // A subset of the entities -- only those that can move (only Robot for now).
-  std::vector<class ArenaMobileEntity *> mobile_entities_;
-
-  // Represents all robots in the arena
-  std::vector<class ArenaMobileEntity *> robot_entities_;
-
-  // Another subset of the entities -- the collection of sensors.
-  std::vector<class Light *> light_entities_;
-
-  // Another subset of the entitiest -- the collection of foods.
-  std::vector<class Food *> food_entities_;
+  // The robots, lights and foods in store order, as slots and as typed
+  // pointers.
+  EntityBatch<Robot> robots_;
+  EntityBatch<Light> lights_;
+  EntityBatch<Food> foods_;
 
   // win/lose/playing state
   int game_status_;
+
+  // Broad phase for Robot vs. Robot collisions. Ids are indices into
+  // robots_, so sorting ids recovers the order of the store.
+  SpatialGrid robot_grid_;
+
+  // Broad phase for Robot vs. Food capture. Ids are indices into
+  // foods_. Rebuilt by RebuildFoodGrid() only when stale.
+  SpatialGrid food_grid_;
+  bool food_grid_stale_{true};
+  double max_food_radius_{0};
+
+  // Cached sensor intensities, used instead of summing every source when
+  // field_resolution_ (arena_params::field_resolution) is above zero. The
+  // light field is recomputed every step; the food field only when stale.
+  double field_resolution_;
+  IntensityField light_field_;
+  IntensityField food_field_;
+  bool food_field_stale_{true};
+
+  // Scratch lists of grid query results, one per thread, kept to avoid
+  // reallocating.
+  std::vector<std::vector<int>> grid_candidates_;
+
+  // See set_record_events(). Events found in parallel loops are first
+  // collected per thread.
+  bool record_events_{false};
+  std::vector<ArenaEvent> events_;
+  std::vector<std::vector<ArenaEvent>> thread_events_;
+
+  // Per-robot (indexed like robots_) displacement computed by
+  // ComputeRobotOverlaps(), and whether the robot overlapped any other.
+  std::vector<double> collision_dx_;
+  std::vector<double> collision_dy_;
+  std::vector<uint8_t> collided_;
+
+  // Contiguous inputs and outputs of the batched sensor update. Sensor
+  // arrays hold two entries (left, right) per robot, in robots_ order.
+  std::vector<double> light_x_;
+  std::vector<double> light_y_;
+  std::vector<double> food_x_;
+  std::vector<double> food_y_;
+  std::vector<double> sensor_x_;
+  std::vector<double> sensor_y_;
+  std::vector<double> light_gain_;
+  std::vector<double> food_gain_;
+  std::vector<double> light_reading_;
+  std::vector<double> food_reading_;
+
+  // Contiguous poses and wheel velocities of the robots and then the lights,
+  // moved by the batched kinematics update.
+  std::vector<double> drive_x_;
+  std::vector<double> drive_y_;
+  std::vector<double> drive_theta_;
+  std::vector<double> drive_left_;
+  std::vector<double> drive_right_;
+
+#ifdef ARENA_PROFILE
+  // Per-phase timings of UpdateEntitiesTimestep()
+  PhaseProfiler profiler_;
+#endif
+
+  // Workers used to step the arena. Declared last so that it is destroyed
+  // (and its threads joined) first.
+  ThreadPool pool_;
 };
 
 NAMESPACE_END(csci3081);
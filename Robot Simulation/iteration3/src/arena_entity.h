@@ -13,10 +13,12 @@
 #include <string>
 
 #include "src/common.h"
+#include "src/entity_store.h"
 #include "src/entity_type.h"
 #include "src/params.h"
 #include "src/pose.h"
 #include "src/rgb_color.h"
+#include "src/rng.h"
 
 /*******************************************************************************
  * Namespaces
@@ -43,6 +45,9 @@ NAMESPACE_BEGIN(csci3081);
  *
  * All arena entities are circular.
  *
+ * Once added to an Arena, an entity is bound to a slot of the Arena's
+ * EntityStore and its pose and radius accessors read and write that slot.
+ * Unbound entities (e.g. in unit tests) keep their own copy.
  */
 class ArenaEntity {
  public:
@@ -56,6 +61,13 @@ class ArenaEntity {
    */
   virtual ~ArenaEntity() = default;
 
+  /**
+   * @brief Entities are bound to a single store slot, so they cannot be
+   * copied.
+   */
+  ArenaEntity(const ArenaEntity &other) = delete;
+  ArenaEntity &operator=(const ArenaEntity &other) = delete;
+
   /**
    * @brief Perform whatever updates needed for a particular entity after 1
    * timestep (updating position, changing color, etc.).
@@ -66,8 +78,10 @@ class ArenaEntity {
 
   /**
    * @brief Reset entity to a newly constructed state.
+   *
+   * @param[in] rng The Arena's generator, for the new random position.
    */
-  virtual void Reset() {}
+  virtual void Reset(__unused Rng *rng) {}
 
   /**
    * @brief Get the name of the entity for visualization and for debugging.
@@ -77,32 +91,86 @@ class ArenaEntity {
    */
   virtual std::string get_name() const = 0;
 
+  /**
+   * @brief Bind the entity to a slot of an EntityStore. The entity's pose,
+   * radius and type are copied into the slot, after which the store holds
+   * the authoritative values.
+   */
+  void BindStore(EntityStore *store, int slot) {
+    store->set_pose(slot, pose_);
+    store->radius[slot] = radius_;
+    store->type[slot] = type_;
+    store_ = store;
+    slot_ = slot;
+    SyncStore();
+  }
+
+  /**
+   * @brief Copy the state held by the store back into the entity and detach
+   * from it.
+   */
+  void UnbindStore() {
+    if (store_) {
+      pose_ = store_->get_pose(slot_);
+      radius_ = store_->radius[slot_];
+      store_ = nullptr;
+      slot_ = -1;
+    }
+  }
 
-  const Pose &get_pose() const { return pose_; }
-  void set_pose(const Pose &pose) { pose_ = pose; }
-  Pose set_pose_randomly() {
+  /**
+   * @brief Mirror any entity-owned state (velocities, hunger, ...) into the
+   * bound store slot. Called after that state changes. No-op by default.
+   */
+  virtual void SyncStore() {}
+
+  EntityStore *get_store() const { return store_; }
+  int get_slot() const { return slot_; }
+
+  Pose get_pose() const {
+    return store_ ? store_->get_pose(slot_) : pose_;
+  }
+  void set_pose(const Pose &pose) {
+    if (store_) {
+      store_->set_pose(slot_, pose);
+    } else {
+      pose_ = pose;
+    }
+  }
+  Pose set_pose_randomly(Rng *rng) {
     // Dividing arena into 19x14 grid. Each grid square is 50x50
-    return {static_cast<double>((30 + (random() % 19) * 50)),
-          static_cast<double>((30 + (random() % 14) * 50))};
+    return {static_cast<double>((30 + rng->Below(19) * 50)),
+          static_cast<double>((30 + rng->Below(14) * 50))};
   }
 
   /**
    * @brief Setter method for position within entity pose variable.
    */
   void set_position(const double inx, const double iny) {
-    pose_.x = inx;
-    pose_.y = iny;
+    if (store_) {
+      store_->x[slot_] = inx;
+      store_->y[slot_] = iny;
+    } else {
+      pose_.x = inx;
+      pose_.y = iny;
+    }
   }
 
   /**
    * @brief Setter method for heading within entity pose variable.
    */
-  void set_heading(const double t) { pose_.theta = t; }
+  void set_heading(const double t) {
+    if (store_) {
+      store_->theta[slot_] = t;
+    } else {
+      pose_.theta = t;
+    }
+  }
 
   /**
    * @brief Getter method which returns heading.
    */
-  double get_heading() { return pose_.theta; }
+  double get_heading() { return store_ ? store_->theta[slot_] : pose_.theta; }
 
   /**
    * @brief Setter for heading within pose, but change is relative to current
@@ -112,17 +180,26 @@ class ArenaEntity {
    * or negative.
    */
   void RelativeChangeHeading(const double delta) {
-    pose_.theta += delta;
+    set_heading(get_heading() + delta);
   }
 
   const RgbColor &get_color() const { return color_; }
   void set_color(const RgbColor &color) { color_ = color; }
 
-  double get_radius() const { return radius_; }
-  void set_radius(double radius) { radius_ = radius; }
+  double get_radius() const { return store_ ? store_->radius[slot_] : radius_; }
+  void set_radius(double radius) {
+    if (store_) {
+      store_->radius[slot_] = radius;
+    } else {
+      radius_ = radius;
+    }
+  }
 
   EntityType get_type() const { return type_; }
-  void set_type(EntityType et) { type_ = et; }
+  void set_type(EntityType et) {
+    type_ = et;
+    if (store_) { store_->type[slot_] = et; }
+  }
 
   int get_id() const { return id_; }
   void set_id(int id) { id_ = id; }
@@ -138,9 +215,13 @@ class ArenaEntity {
   void set_mobility(bool value) { is_mobile_ = value; }
 
  private:
-  // Radius of an arena entity.
+  // The store compacts slots when entities are removed.
+  friend struct EntityStore;
+
+  // Radius of an arena entity (while unbound).
   double radius_{DEFAULT_RADIUS};
-  // Pose which determines the position and heading of an entity.
+  // Pose which determines the position and heading of an entity (while
+  // unbound).
   Pose pose_;
   // Color of entity.
   RgbColor color_;
@@ -150,6 +231,9 @@ class ArenaEntity {
   int id_{-1};
   // Determines mobility of an entity.
   bool is_mobile_{false};
+  // The store and slot this entity is bound to, if any.
+  EntityStore *store_{nullptr};
+  int slot_{-1};
 };
 
 NAMESPACE_END(csci3081);
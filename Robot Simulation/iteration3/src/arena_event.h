@@ -0,0 +1,46 @@
+/**
+ * @file arena_event.h
+ *
+ * @copyright 2018 Nate Samuelson, All rights reserved.
+ */
+
+#ifndef SRC_ARENA_EVENT_H_
+#define SRC_ARENA_EVENT_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "src/common.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+enum ArenaEventType {
+  // A Robot (id) reached a Food (other) and is no longer hungry.
+  kEventFoodCaptured,
+  // A Robot (id) starved.
+  kEventStarved,
+  // A Robot (id) hit a wall (other, an EntityType).
+  kEventRobotHitWall,
+  // A Light (id) hit a wall (other, an EntityType).
+  kEventLightHitWall,
+  // Two Robots (id and other) overlapped. Reported once per pair.
+  kEventRobotCollision
+};
+
+/**
+ * @brief Something that happened to an entity during a timestep, as
+ * collected by the Arena for a TrajectoryWriter. Entities are given by id,
+ * which is only unique within a type.
+ */
+struct ArenaEvent {
+  ArenaEventType type;
+  int id;
+  int other;
+};
+
+NAMESPACE_END(csci3081);
+
+#endif  // SRC_ARENA_EVENT_H_
@@ -41,7 +41,7 @@ class ArenaMobileEntity : public ArenaEntity {
    */
   ArenaMobileEntity()
     : ArenaEntity(),
-      sensor_touch_(new SensorTouch) {
+      sensor_touch_() {
         set_mobility(true);
   }
 
@@ -61,12 +61,13 @@ class ArenaMobileEntity : public ArenaEntity {
   /**
    * @brief Get a pointer to the ArenaMobileEntity's touch sensor.
   */
-  SensorTouch * get_touch_sensor() { return sensor_touch_; }
+  SensorTouch * get_touch_sensor() { return &sensor_touch_; }
 
  protected:
   // Using protected allows for direct access to sensor within entity.
   // It was awkward to have get_touch_sensor()->get_output() .
-  SensorTouch * sensor_touch_;
+  // Held by value so it is allocated (and freed) with the entity.
+  SensorTouch sensor_touch_;
 };
 
 NAMESPACE_END(csci3081);
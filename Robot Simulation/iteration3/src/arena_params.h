@@ -35,6 +35,13 @@ struct arena_params {
   size_t n_foods{0};
   uint x_dim{ARENA_X_DIM};
   uint y_dim{ARENA_Y_DIM};
+  size_t n_threads{N_THREADS};
+  // Seed of the Arena's Rng. Arenas with the same seed and parameters are
+  // built and step identically; 0 picks a random seed (see Arena::get_seed()).
+  uint64_t seed{ARENA_SEED};
+  // Node spacing of the cached sensor intensity fields (see IntensityField);
+  // 0 sums every light and food for every sensor instead.
+  double field_resolution{FIELD_RESOLUTION};
 };
 
 NAMESPACE_END(csci3081);
@@ -0,0 +1,140 @@
+/**
+ * @file checkpoint.cc
+ *
+ * @copyright 2018 Nate Samuelson, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstring>
+
+#include "src/checkpoint.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Constructors/Destructor
+ ******************************************************************************/
+CheckpointFile::~CheckpointFile() {
+  Close();
+} /* ~CheckpointFile() */
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+bool CheckpointFile::Create(const std::string &path, size_t n_entities) {
+  Close();
+  path_ = path;
+  temp_path_ = path + ".tmp";
+  size_ = sizeof(CheckpointHeader) + n_entities * sizeof(CheckpointEntity);
+  int fd = open(temp_path_.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd == -1) {
+    temp_path_.clear();
+    return false;
+  }
+  // A new file reads as zeros, so unused fields need not be cleared.
+  if (ftruncate(fd, static_cast<off_t>(size_)) == 0) {
+    data_ = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  }
+  int saved_errno = errno;
+  close(fd);
+  if (data_ == MAP_FAILED || data_ == nullptr) {
+    data_ = nullptr;
+    Close();
+    errno = saved_errno;
+    return false;
+  }
+  CheckpointHeader *h = header();
+  memcpy(h->magic, kCheckpointMagic, sizeof(h->magic));
+  h->version = kCheckpointVersion;
+  h->byte_order = kCheckpointByteOrder;
+  h->header_size = sizeof(CheckpointHeader);
+  h->entity_size = sizeof(CheckpointEntity);
+  h->n_entities = n_entities;
+  return true;
+} /* Create() */
+
+bool CheckpointFile::Commit() {
+  if (!data_ || temp_path_.empty()) {
+    errno = EINVAL;
+    return false;
+  }
+  if (msync(data_, size_, MS_SYNC) != 0 ||
+      rename(temp_path_.c_str(), path_.c_str()) != 0) {
+    int saved_errno = errno;
+    Close();
+    errno = saved_errno;
+    return false;
+  }
+  temp_path_.clear();
+  Close();
+  return true;
+} /* Commit() */
+
+bool CheckpointFile::Open(const std::string &path) {
+  Close();
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd == -1) {
+    return false;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    int saved_errno = errno;
+    close(fd);
+    errno = saved_errno;
+    return false;
+  }
+  size_ = static_cast<size_t>(st.st_size);
+  if (size_ < sizeof(CheckpointHeader)) {
+    close(fd);
+    errno = EINVAL;
+    return false;
+  }
+  data_ = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+  int saved_errno = errno;
+  close(fd);
+  if (data_ == MAP_FAILED) {
+    data_ = nullptr;
+    errno = saved_errno;
+    return false;
+  }
+  path_ = path;
+  const CheckpointHeader *h = header();
+  if (memcmp(h->magic, kCheckpointMagic, sizeof(h->magic)) != 0 ||
+      h->version != kCheckpointVersion ||
+      h->byte_order != kCheckpointByteOrder ||
+      h->header_size != sizeof(CheckpointHeader) ||
+      h->entity_size != sizeof(CheckpointEntity) ||
+      h->n_entities > (size_ - sizeof(CheckpointHeader)) /
+                      sizeof(CheckpointEntity)) {
+    Close();
+    errno = EINVAL;
+    return false;
+  }
+  return true;
+} /* Open() */
+
+void CheckpointFile::Close() {
+  if (data_) {
+    munmap(data_, size_);
+    data_ = nullptr;
+  }
+  if (!temp_path_.empty()) {
+    unlink(temp_path_.c_str());
+    temp_path_.clear();
+  }
+  size_ = 0;
+} /* Close() */
+
+NAMESPACE_END(csci3081);
@@ -0,0 +1,177 @@
+/**
+ * @file checkpoint.h
+ *
+ * @copyright 2018 Nate Samuelson, All rights reserved.
+ */
+
+#ifndef SRC_CHECKPOINT_H_
+#define SRC_CHECKPOINT_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+#include "src/common.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Constants
+ ******************************************************************************/
+// First bytes of every checkpoint file.
+const char kCheckpointMagic[8] = {'A', 'R', 'E', 'N', 'A', 'C', 'K', 'P'};
+// Bumped whenever the layout of CheckpointHeader or CheckpointEntity changes.
+const uint32_t kCheckpointVersion = 1;
+// Written as a native integer, so a file from a machine with the other byte
+// order is recognized and rejected.
+const uint32_t kCheckpointByteOrder = 0x01020304;
+
+/*******************************************************************************
+ * Struct Definitions
+ ******************************************************************************/
+/**
+ * @brief The start of a checkpoint file: the state of the Arena itself.
+ *
+ * A checkpoint is this header followed by one CheckpointEntity per entity,
+ * in store order. Both are plain fixed-size structures in the byte order of
+ * the machine, so a file is written by filling them in place in a mapping of
+ * the file and read the same way, without converting any field.
+ */
+struct CheckpointHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t byte_order;
+  // sizeof() of both structures, as a further layout check.
+  uint32_t header_size;
+  uint32_t entity_size;
+  uint64_t n_entities;
+
+  // The Arena's Rng.
+  uint64_t rng_seed;
+  uint64_t rng_state[4];
+
+  double x_dim;
+  double y_dim;
+  double light_sensitivity;
+  int32_t game_status;
+
+  // EntityFactory counters, so new entities continue the ids.
+  int32_t entity_count;
+  int32_t robot_count;
+  int32_t light_count;
+  int32_t food_count;
+  int32_t unused;
+};
+
+/**
+ * @brief The state of one entity. Fields that do not apply to the entity's
+ * type are zero.
+ */
+struct CheckpointEntity {
+  // Every entity
+  int32_t type;
+  int32_t id;
+  int32_t color[3];
+  int32_t touch_output;
+  double x;
+  double y;
+  double theta;
+  double radius;
+
+  // Robots and Lights: MotionHandler and avoidance state
+  double vel_left;
+  double vel_right;
+  double max_speed;
+  double max_angle;
+  double speed_delta;
+  double angle_delta;
+  int32_t avoiding;
+  int32_t avoid_time;
+
+  // Robots only
+  int32_t robot_type;
+  int32_t hunger;
+  double light_sensitivity;
+  double hunger_time;
+  double hunger_level;
+  double starvation_time;
+  // Left light, right light, left food and right food sensors
+  double sensor_x[4];
+  double sensor_y[4];
+  double sensor_reading[4];
+};
+
+static_assert(std::is_trivially_copyable<CheckpointHeader>::value &&
+              std::is_trivially_copyable<CheckpointEntity>::value,
+              "Checkpoint structures are copied as raw bytes");
+static_assert(sizeof(CheckpointHeader) % alignof(CheckpointEntity) == 0,
+              "Entities must be aligned in the mapping");
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief A checkpoint file mapped into memory.
+ *
+ * Create() makes a zeroed file of the right size next to `path` and maps it;
+ * once the header and entities have been filled in, Commit() flushes the
+ * mapping with a single msync() and renames the file to `path`. A crash or a
+ * failure before that leaves any previous checkpoint at `path` untouched.
+ *
+ * Open() maps an existing checkpoint read-only, after checking that its
+ * header matches this build and that the file holds every entity.
+ *
+ * Functions return false on failure, with errno describing the problem.
+ */
+class CheckpointFile {
+ public:
+  CheckpointFile() : path_(), temp_path_() {}
+  ~CheckpointFile();
+
+  CheckpointFile(const CheckpointFile &other) = delete;
+  CheckpointFile &operator=(const CheckpointFile &other) = delete;
+
+  /**
+   * @brief Start writing a checkpoint of `n_entities` entities to `path`.
+   * The header's layout fields are filled in.
+   */
+  bool Create(const std::string &path, size_t n_entities);
+
+  /**
+   * @brief Finish the checkpoint started by Create().
+   */
+  bool Commit();
+
+  /**
+   * @brief Map the checkpoint at `path` for reading.
+   */
+  bool Open(const std::string &path);
+
+  CheckpointHeader *header() { return static_cast<CheckpointHeader *>(data_); }
+  CheckpointEntity *entities() {
+    return reinterpret_cast<CheckpointEntity *>(header() + 1);
+  }
+
+ private:
+  /**
+   * @brief Unmap the file, and remove it if it was never committed.
+   */
+  void Close();
+
+  std::string path_;
+  // Where Create() writes until Commit(). Empty when reading.
+  std::string temp_path_;
+  void *data_{nullptr};
+  size_t size_{0};
+};
+
+NAMESPACE_END(csci3081);
+
+#endif  // SRC_CHECKPOINT_H_
@@ -22,6 +22,8 @@ enum Communication {
   kPlay,
   kPause,
   kNewGame,
+  kFastForward,
+  kNormalSpeed,
 
   // communications from Arena to Controller
   kWon,
@@ -8,6 +8,7 @@
  * Includes
  ******************************************************************************/
 #include <nanogui/nanogui.h>
+#include <fstream>
 #include <string>
 
 #include "src/arena_params.h"
@@ -19,7 +20,7 @@
  ******************************************************************************/
 NAMESPACE_BEGIN(csci3081);
 
-Controller::Controller() : last_dt(0) {
+Controller::Controller(const char *replay) {
   // Initialize default properties for various arena entities
   arena_params aparams;
   aparams.n_robots = N_ROBOTS;
@@ -32,22 +33,26 @@ Controller::Controller() : last_dt(0) {
 
   // Start up the graphics (which creates the arena).
   // Run() will enter the nanogui::mainloop().
-  viewer_ = new GraphicsArenaViewer(&aparams, arena_, this);
+  viewer_ = new GraphicsArenaViewer(&aparams, arena_, this, replay);
+  sim_ = new SimulationThread(arena_);
 } /* Controller() */
 
-void Controller::Run() { viewer_->Run(); }  /* Run() */
-
-void Controller::AdvanceTime(double dt) {
-  if ((last_dt + dt) <= .05) {
-    last_dt += dt;
-    return;
+void Controller::Run() {
+  // A replay does not need the simulation.
+  if (!viewer_->is_replaying()) {
+    sim_->Start();
+  }
+  viewer_->Run();
+  // The viewer owns the Arena, so stop stepping it first.
+  sim_->Stop();
+  if (PhaseProfiler::kEnabled) {
+    std::ofstream csv(PROFILE_CSV_FILE);
+    arena_->WriteProfileCsv(csv);
   }
-  last_dt = 0;
-  arena_->AdvanceTime(dt);
-} /* AdvanceTime() */
+} /* Run() */
 
 void Controller::AcceptCommunication(Communication com) {
-  arena_->AcceptCommand(ConvertComm(com));
+  sim_->Command([this, com]() { arena_->AcceptCommand(ConvertComm(com)); });
 } /* AcceptCommunication() */
 
 /**
@@ -81,7 +86,14 @@ Communication Controller::ConvertComm(Communication com) {
     case (kPause) :
       return kPause;
     case (kNewGame) :
+      sim_->clock()->Reset();
       return kNewGame;
+    case (kFastForward) :
+      sim_->clock()->set_speed(SIM_FAST_FORWARD);
+      return kNone;
+    case (kNormalSpeed) :
+      sim_->clock()->set_speed(1);
+      return kNone;
     default: return kNone;
   }
 } /* ConvertComm() */
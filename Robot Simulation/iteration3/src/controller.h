@@ -18,6 +18,8 @@
 #include "src/communication.h"
 #include "src/graphics_arena_viewer.h"
 #include "src/params.h"
+#include "src/render_snapshot.h"
+#include "src/simulation_thread.h"
 
 /*******************************************************************************
  * Namespaces
@@ -33,8 +35,10 @@ class GraphicsArenaViewer;
  * @brief Controller that mediates Arena and GraphicsArenaViewer communication.
  *
  * The Controller instantiates the Arena and the GraphicsArenaViewer. The
- * viewer contains the main loop that keeps it live, but at each update, the
- * viewer sends a message to the controller to update its time.
+ * viewer contains the main loop that keeps it live, while the Arena is
+ * stepped by a SimulationThread. The viewer draws the snapshots that thread
+ * publishes, and every communication reaches the Arena through the thread's
+ * Command(), between timesteps.
  *
  * Other types of communication between Arena and Viewer include:
  * - keypresses intercepted by the Viewer.
@@ -45,8 +49,11 @@ class Controller {
  public:
   /**
    * @brief Controller's constructor that will create Arena and Viewer.
+   *
+   * @param replay A trajectory file for the viewer to play back instead of
+   * running the simulation, or nullptr.
    */
-  Controller();
+  explicit Controller(const char *replay = nullptr);
 
 
   /**
@@ -55,10 +62,9 @@ class Controller {
   void Run();
 
   /**
-   * @brief AdvanceTime is communication from the Viewer to advance the
-   * simulation.
+   * @brief The latest snapshot of the Arena, for the viewer to draw.
    */
-  void AdvanceTime(double dt);
+  const RenderSnapshot &get_snapshot() { return sim_->Latest(); }
 
   /**
    * @brief AcceptCommunication from either the viewer or the Arena
@@ -69,14 +75,16 @@ class Controller {
   * @brief Converts the communication from one to send to the other.
   *
   * Used primarily for testing purposes to insure communication is being
-  * correctly received, interpreted, and relayed.
+  * correctly received, interpreted, and relayed. Changes the Arena, so it
+  * must run inside SimulationThread::Command(), as in AcceptCommunication().
   */
   Communication ConvertComm(Communication com);
 
  private:
-  double last_dt{0};
   Arena* arena_{nullptr};
   GraphicsArenaViewer* viewer_{nullptr};
+  // Steps arena_ in real time.
+  SimulationThread* sim_{nullptr};
 };
 
 NAMESPACE_END(csci3081);
@@ -0,0 +1,68 @@
+/**
+ * @file entity_batch.h
+ *
+ * @copyright 2018 Nate Samuelson, All rights reserved.
+ */
+
+#ifndef SRC_ENTITY_BATCH_H_
+#define SRC_ENTITY_BATCH_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <vector>
+
+#include "src/common.h"
+#include "src/entity_store.h"
+#include "src/entity_type.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief The entities of one type in an EntityStore, with their static type.
+ *
+ * Entry i is the i-th entity of the type in store order: its slot in the
+ * store and a pointer to it as a T. The entity classes are final, so calls
+ * through these pointers are resolved at compile time, and loops over a
+ * batch never test types or cast.
+ */
+template <class T>
+class EntityBatch {
+ public:
+  EntityBatch() : slots_(), entities_() {}
+
+  /**
+   * @brief Collect the entities of type `etype` from the store. Must be
+   * called again after entities are added to or removed from the store.
+   */
+  void Refresh(const EntityStore &store, EntityType etype) {
+    store.SlotsOfType(etype, &slots_);
+    entities_.resize(slots_.size());
+    for (size_t i = 0; i < slots_.size(); ++i) {
+      entities_[i] = static_cast<T *>(store.entity[slots_[i]]);
+    }
+  }
+
+  size_t size() const { return slots_.size(); }
+  bool empty() const { return slots_.empty(); }
+
+  int slot(size_t i) const { return slots_[i]; }
+  T *entity(size_t i) const { return entities_[i]; }
+
+  const std::vector<int> &slots() const { return slots_; }
+  const std::vector<T *> &entities() const { return entities_; }
+
+ private:
+  std::vector<int> slots_;
+  std::vector<T *> entities_;
+};
+
+NAMESPACE_END(csci3081);
+
+#endif  // SRC_ENTITY_BATCH_H_
@@ -8,7 +8,6 @@
  * Includes
  ******************************************************************************/
 #include <string>
-#include <ctime>
 #include <iostream>
 
 #include "src/common.h"
@@ -27,8 +26,8 @@ NAMESPACE_BEGIN(csci3081);
  * Class Definitions
  ******************************************************************************/
 
-EntityFactory::EntityFactory() {
-  srand(time(nullptr));
+EntityFactory::EntityFactory(EntityPool *pool, Rng *rng)
+    : pool_(pool), rng_(rng) {
 } /* EntityFactory() */
 
 ArenaEntity* EntityFactory::CreateEntity(EntityType etype) {
@@ -50,11 +49,11 @@ ArenaEntity* EntityFactory::CreateEntity(EntityType etype) {
 } /* CreateEntity() */
 
 Robot* EntityFactory::CreateRobot() {
-  auto* robot = new Robot;
+  auto* robot = pool_->robots.Create();
   robot->set_type(kRobot);
   robot->set_color(ROBOT_COLOR);
   robot->set_pose(SetPoseRandomly());
-  robot->set_radius(ROBOT_RADIUS);
+  robot->set_radius(ROBOT_RADIUS(rng_));
   ++entity_count_;
   ++robot_count_;
   robot->set_id(robot_count_);
@@ -62,12 +61,12 @@ Robot* EntityFactory::CreateRobot() {
 } /* CreateRobot() */
 
 Light* EntityFactory::CreateLight() {
-  auto* light = new Light;
+  auto* light = pool_->lights.Create();
   light->set_type(kLight);
   light->set_color(LIGHT_COLOR);
   light->set_pose(SetPoseRandomly());
   light->set_radius(LIGHT_RADIUS);
-  light->set_heading(LIGHT_HEADING);
+  light->set_heading(LIGHT_HEADING(rng_));
   ++entity_count_;
   ++light_count_;
   light->set_id(light_count_);
@@ -75,7 +74,7 @@ Light* EntityFactory::CreateLight() {
 } /* CreateLight() */
 
 Food* EntityFactory::CreateFood() {
-  auto* food = new Food;
+  auto* food = pool_->foods.Create();
   food->set_type(kFood);
   food->set_color(FOOD_COLOR);
   food->set_pose(SetPoseRandomly());
@@ -88,8 +87,8 @@ Food* EntityFactory::CreateFood() {
 
 Pose EntityFactory::SetPoseRandomly() {
   // Dividing arena into 19x14 grid. Each grid square is 50x50
-  return {static_cast<double>((30 + (random() % 19) * 50)),
-        static_cast<double>((30 + (random() % 14) * 50))};
+  return {static_cast<double>((30 + rng_->Below(19) * 50)),
+        static_cast<double>((30 + rng_->Below(14) * 50))};
 } /* SetPoseRandomly() */
 
 NAMESPACE_END(csci3081);
@@ -13,13 +13,16 @@
 #include <string>
 
 #include "src/food.h"
+#include "src/checkpoint.h"
 #include "src/common.h"
 #include "src/entity_type.h"
 #include "src/robot_type.h"
 #include "src/light.h"
+#include "src/object_pool.h"
 #include "src/params.h"
 #include "src/pose.h"
 #include "src/rgb_color.h"
+#include "src/rng.h"
 #include "src/robot.h"
 
 /*******************************************************************************
@@ -30,6 +33,26 @@ NAMESPACE_BEGIN(csci3081);
 /*******************************************************************************
  * Class Definitions
  ******************************************************************************/
+/**
+ * @brief The memory the entities of an Arena are constructed in: one
+ * ObjectPool per entity type. Entities therefore must not own anything their
+ * destructors would have to free.
+ */
+struct EntityPool {
+  ObjectPool<Robot> robots{};
+  ObjectPool<Light> lights{};
+  ObjectPool<Food> foods{};
+
+  /**
+   * @brief Release every entity in O(1). The memory is kept for reuse.
+   */
+  void Clear() {
+    robots.Clear();
+    lights.Clear();
+    foods.Clear();
+  }
+};
+
 /**
  * @brief A factory for the instantiation of all types of arena entities.
  *
@@ -37,14 +60,22 @@ NAMESPACE_BEGIN(csci3081);
  * It assigns ID's to the entity when it creates it.
  * The factory randomly places entities, and in doing so, attempts to not
  * have them overlap.
+ *
+ * Entities are constructed in an EntityPool owned by the caller (the Arena),
+ * which also destroys them.
  */
 class EntityFactory {
  public:
   /**
    * @brief EntityFactory constructor.
    *
+   * @param[in] pool The pool new entities are constructed in.
+   * @param[in] rng The generator every random choice is drawn from.
    */
-  EntityFactory();
+  EntityFactory(EntityPool *pool, Rng *rng);
+
+  EntityFactory(const EntityFactory &other) = delete;
+  EntityFactory &operator=(const EntityFactory &other) = delete;
 
   /**
    * @brief Default destructor.
@@ -55,7 +86,7 @@ class EntityFactory {
   * @brief CreateEntity is primary purpose of this class.
   *
   * @param[in] etype The type to make.
-  * @param[out] new dynamically created entity.
+  * @param[out] new entity, owned by the pool.
   *
   * Currently, the Arena gets the entity and places it in the appropriate data
   * structure. It might be useful to instead have the factory place on the
@@ -65,18 +96,8 @@ class EntityFactory {
   ArenaEntity* CreateEntity(EntityType etype);
 
   /**
-  * @brief Resets entity counters upon new game.
-  */
-  void ResetCounts() {
-    entity_count_ = 0;
-    robot_count_ = 0;
-    light_count_ = 0;
-    food_count_ = 0;
-  }
-
- private:
-   /**
-   * @brief CreateRobot called from within CreateEntity.
+   * @brief CreateRobot called from within CreateEntity, or directly when the
+   * caller wants the entity's static type.
    */
   Robot* CreateRobot();
 
@@ -90,11 +111,45 @@ class EntityFactory {
   */
   Food* CreateFood();
 
+  /**
+  * @brief Resets entity counters upon new game.
+  */
+  void ResetCounts() {
+    entity_count_ = 0;
+    robot_count_ = 0;
+    light_count_ = 0;
+    food_count_ = 0;
+  }
+
+  /**
+   * @brief Copy the counters into, or restore them from, a checkpoint, so
+   * entities created after a restore continue the ids.
+   */
+  void SaveCounts(CheckpointHeader *header) const {
+    header->entity_count = entity_count_;
+    header->robot_count = robot_count_;
+    header->light_count = light_count_;
+    header->food_count = food_count_;
+  }
+  void LoadCounts(const CheckpointHeader &header) {
+    entity_count_ = header.entity_count;
+    robot_count_ = header.robot_count;
+    light_count_ = header.light_count;
+    food_count_ = header.food_count;
+  }
+
+ private:
   /**
   * @brief An attempt to not overlap any of the newly constructed entities.
   */
   Pose SetPoseRandomly();
 
+  // Where entities are constructed.
+  EntityPool *pool_;
+
+  // Source of the random positions, radii and headings.
+  Rng *rng_;
+
   /* Factory tracks the number of created entities. There is no accounting for
    * the destruction of entities */
   int entity_count_{0};
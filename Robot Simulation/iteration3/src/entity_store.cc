@@ -0,0 +1,98 @@
+/**
+ * @file entity_store.cc
+ *
+ * @copyright 2018 Nate Samuelson, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "src/entity_store.h"
+#include "src/arena_entity.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+int EntityStore::Add(ArenaEntity *ent) {
+  int slot = static_cast<int>(entity.size());
+  Resize(entity.size() + 1);
+  entity[slot] = ent;
+  ent->BindStore(this, slot);
+  return slot;
+} /* Add() */
+
+void EntityStore::RemoveType(EntityType etype) {
+  size_t kept = 0;
+  for (size_t i = 0; i < entity.size(); ++i) {
+    if (type[i] == etype) {
+      entity[i]->UnbindStore();
+      continue;
+    }
+    if (kept != i) {
+      MoveSlot(i, kept);
+      entity[kept]->slot_ = static_cast<int>(kept);
+    }
+    ++kept;
+  }
+  Resize(kept);
+} /* RemoveType() */
+
+void EntityStore::Clear() {
+  for (auto ent : entity) {
+    ent->UnbindStore();
+  }
+  Resize(0);
+} /* Clear() */
+
+void EntityStore::SlotsOfType(EntityType etype,
+                              std::vector<int> *slots) const {
+  slots->clear();
+  for (size_t i = 0; i < type.size(); ++i) {
+    if (type[i] == etype) {
+      slots->push_back(static_cast<int>(i));
+    }
+  }
+} /* SlotsOfType() */
+
+void EntityStore::Resize(size_t n) {
+  entity.resize(n, nullptr);
+  type.resize(n, kUndefined);
+  x.resize(n, 0);
+  y.resize(n, 0);
+  theta.resize(n, 0);
+  radius.resize(n, 0);
+  vel_left.resize(n, 0);
+  vel_right.resize(n, 0);
+  hunger.resize(n, 0);
+  starved.resize(n, 0);
+  hunger_level.resize(n, 0);
+  left_sensor_x.resize(n, 0);
+  left_sensor_y.resize(n, 0);
+  right_sensor_x.resize(n, 0);
+  right_sensor_y.resize(n, 0);
+} /* Resize() */
+
+void EntityStore::MoveSlot(size_t from, size_t to) {
+  entity[to] = entity[from];
+  type[to] = type[from];
+  x[to] = x[from];
+  y[to] = y[from];
+  theta[to] = theta[from];
+  radius[to] = radius[from];
+  vel_left[to] = vel_left[from];
+  vel_right[to] = vel_right[from];
+  hunger[to] = hunger[from];
+  starved[to] = starved[from];
+  hunger_level[to] = hunger_level[from];
+  left_sensor_x[to] = left_sensor_x[from];
+  left_sensor_y[to] = left_sensor_y[from];
+  right_sensor_x[to] = right_sensor_x[from];
+  right_sensor_y[to] = right_sensor_y[from];
+} /* MoveSlot() */
+
+NAMESPACE_END(csci3081);
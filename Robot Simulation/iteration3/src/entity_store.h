@@ -0,0 +1,124 @@
+/**
+ * @file entity_store.h
+ *
+ * @copyright 2018 Nate Samuelson, All rights reserved.
+ */
+
+#ifndef SRC_ENTITY_STORE_H_
+#define SRC_ENTITY_STORE_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <cstdint>
+#include <vector>
+
+#include "src/common.h"
+#include "src/entity_type.h"
+#include "src/pose.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+class ArenaEntity;
+
+/*******************************************************************************
+ * Struct Definitions
+ ******************************************************************************/
+/**
+ * @brief Structure-of-arrays storage for the state the Arena touches every
+ * timestep.
+ *
+ * Each entity added to the store gets a slot, and every array below has one
+ * element per slot, in the order the entities were added. The Arena's per-step
+ * loops walk these arrays directly instead of chasing ArenaEntity pointers.
+ *
+ * Once an entity is added it is "bound" to its slot: the pose and radius live
+ * only in the store, and the entity's accessors (ArenaEntity::get_pose(),
+ * set_position(), ...) become a thin view onto it. The remaining arrays
+ * (velocities, hunger, sensor positions) are owned by the entity and mirrored
+ * into the store by ArenaEntity::SyncStore() whenever they change.
+ */
+struct EntityStore {
+ public:
+  /**
+   * @brief Append an entity and bind it to the new slot.
+   *
+   * @return The slot the entity was placed in.
+   */
+  int Add(ArenaEntity *ent);
+
+  /**
+   * @brief Remove every entity of a type, unbinding them. The remaining
+   * entities keep their relative order (and are re-bound to their new slots).
+   */
+  void RemoveType(EntityType etype);
+
+  /**
+   * @brief Unbind and remove all entities.
+   */
+  void Clear();
+
+  /**
+   * @brief Remove all entities without unbinding them, for when they are
+   * about to be destroyed anyway.
+   */
+  void Release() { Resize(0); }
+
+  /**
+   * @brief Fill `slots` with the slots holding entities of a type, in order.
+   */
+  void SlotsOfType(EntityType etype, std::vector<int> *slots) const;
+
+  size_t size() const { return entity.size(); }
+
+  Pose get_pose(int slot) const { return Pose(x[slot], y[slot], theta[slot]); }
+  void set_pose(int slot, const Pose &pose) {
+    x[slot] = pose.x;
+    y[slot] = pose.y;
+    theta[slot] = pose.theta;
+  }
+
+  // The entity bound to each slot, and its type.
+  std::vector<ArenaEntity *> entity{};
+  std::vector<EntityType> type{};
+
+  // Pose and radius. Authoritative: bound entities read and write these.
+  std::vector<double> x{};
+  std::vector<double> y{};
+  std::vector<double> theta{};
+  std::vector<double> radius{};
+
+  // Wheel velocities used for the latest pose update (mobile entities only).
+  std::vector<double> vel_left{};
+  std::vector<double> vel_right{};
+
+  // Hunger state (Robots only). Flags are bytes rather than a vector<bool> so
+  // that neighboring slots can be written independently.
+  std::vector<uint8_t> hunger{};
+  std::vector<uint8_t> starved{};
+  std::vector<double> hunger_level{};
+
+  // Position of the left and right sensors (Robots only).
+  std::vector<double> left_sensor_x{};
+  std::vector<double> left_sensor_y{};
+  std::vector<double> right_sensor_x{};
+  std::vector<double> right_sensor_y{};
+
+ private:
+  /**
+   * @brief Resize every array to `n` slots.
+   */
+  void Resize(size_t n);
+
+  /**
+   * @brief Copy slot `from` into slot `to`.
+   */
+  void MoveSlot(size_t from, size_t to);
+};
+
+NAMESPACE_END(csci3081);
+
+#endif  // SRC_ENTITY_STORE_H_
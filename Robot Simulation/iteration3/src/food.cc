@@ -30,8 +30,8 @@ Food::~Food() {}  /* ~Food() */
  * Member Functions
  ******************************************************************************/
 
-void Food::Reset() {
-  set_pose(set_pose_randomly());
+void Food::Reset(Rng *rng) {
+  set_pose(set_pose_randomly(rng));
   set_color(FOOD_COLOR);
 } /* Reset() */
 
@@ -31,7 +31,7 @@ NAMESPACE_BEGIN(csci3081);
  * Food restores the hunger of a robot if it comes within 5 pixels
  * of the food object.
 */
-class Food : public ArenaImmobileEntity {
+class Food final : public ArenaImmobileEntity {
  public:
   /**
    * @brief Constructor.
@@ -50,7 +50,7 @@ class Food : public ArenaImmobileEntity {
    * @brief Reset the Food using the initialization parameters received
    * by the constructor.
    */
-  void Reset() override;
+  void Reset(Rng *rng) override;
 
   /**
    * @brief Get the name of the Food for visualization purposes, and to
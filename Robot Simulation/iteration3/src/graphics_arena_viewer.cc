@@ -7,12 +7,14 @@
 /*******************************************************************************
  * Includes
  ******************************************************************************/
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
 #include <vector>
 #include <iostream>
 
 #include "src/graphics_arena_viewer.h"
 #include "src/arena_params.h"
-#include "src/robot.h"
 #include "src/rgb_color.h"
 
 /*******************************************************************************
@@ -25,13 +27,24 @@ NAMESPACE_BEGIN(csci3081);
  ******************************************************************************/
 GraphicsArenaViewer::GraphicsArenaViewer(
     const struct arena_params *const params,
-    Arena * arena, Controller * controller) :
+    Arena * arena, Controller * controller, const char *replay) :
     GraphicsApp(
         params->x_dim + GUI_MENU_WIDTH + GUI_MENU_GAP * 2,
         params->y_dim,
         "Robot Simulation"),
     controller_(controller),
-    arena_(arena) {
+    arena_(arena),
+    replay_(),
+    replay_snapshot_(),
+    replay_clock_() {
+  if (replay) {
+    replaying_ = replay_.Open(replay) &&
+                 replay_.Next(&replay_snapshot_, nullptr);
+    if (!replaying_) {
+      std::cerr << "cannot replay " << replay << ": " << strerror(errno)
+                << std::endl;
+    }
+  }
   auto *gui = new nanogui::FormHelper(screen());
   nanogui::ref<nanogui::Window> window =
       gui->addWindow(
@@ -51,6 +64,11 @@ GraphicsArenaViewer::GraphicsArenaViewer(
       "New Game",
       std::bind(&GraphicsArenaViewer::OnNewGameBtnPressed, this));
   new_game_button_->setFixedWidth(100);
+  speed_button_ =
+    gui->addButton(
+      "Speed x1",
+      std::bind(&GraphicsArenaViewer::OnSpeedBtnPressed, this));
+  speed_button_->setFixedWidth(100);
 
   // vvvvvvvvvv  ADDED BELOW HERE (from nanogui example1.cc)   vvvvvvvvvvvvvvvv
 
@@ -209,12 +227,17 @@ GraphicsArenaViewer::GraphicsArenaViewer(
  * Member Functions
  ******************************************************************************/
 
-// This is the primary driver for state change in the arena.
-// It will be called at each iteration of nanogui::mainloop()
 void GraphicsArenaViewer::UpdateSimulation(double dt) {
-  if (!paused_ &&
-    arena_->get_game_status() == PLAYING) {
-    controller_->AdvanceTime(dt);
+  if (!replaying_ || paused_) {
+    return;
+  }
+  for (int i = replay_clock_.Advance(dt); i > 0; --i) {
+    if (!replay_.Next(&replay_snapshot_, nullptr)) {
+      // The end of the recording.
+      paused_ = true;
+      playing_button_->setCaption("Play");
+      break;
+    }
   }
 } /* UpdateSimulation() */
 
@@ -234,6 +257,11 @@ void GraphicsArenaViewer::Initialize() {
  * Handlers for User Keyboard and Mouse Events
  ******************************************************************************/
 void GraphicsArenaViewer::OnPlayingBtnPressed() {
+  if (replaying_) {
+    paused_ = !paused_;
+    playing_button_->setCaption(paused_ ? "Play" : "Pause");
+    return;
+  }
   if (!paused_) {
     controller_->AcceptCommunication(kPause);
     paused_ = true;
@@ -249,13 +277,22 @@ void GraphicsArenaViewer::OnPlayingBtnPressed() {
 } /* OnPlayingBtnPressed() */
 
 void GraphicsArenaViewer::OnNewGameBtnPressed() {
-  controller_->AcceptCommunication(kNewGame);
+  if (replaying_) {
+    replay_.Seek(0);
+    replay_.Next(&replay_snapshot_, nullptr);
+    replay_clock_.Reset();
+  } else {
+    controller_->AcceptCommunication(kNewGame);
+  }
   initialized_ = false;
   paused_ = true;
   playing_button_->setCaption("Play");
 } /* OnNewGameBtnPressed() */
 
 void GraphicsArenaViewer::OnFoodBtnPressed() {
+  if (replaying_) {
+    return;
+  }
   if (food_) {
     controller_->AcceptCommunication(kFoodOff);
     food_button_->setCaption("Food (OFF)");
@@ -267,6 +304,21 @@ void GraphicsArenaViewer::OnFoodBtnPressed() {
   }
 } /* OnFoodBtnPressed() */
 
+void GraphicsArenaViewer::OnSpeedBtnPressed() {
+  if (replaying_) {
+    replay_clock_.set_speed(fast_forward_ ? 1 : SIM_FAST_FORWARD);
+  }
+  if (fast_forward_) {
+    controller_->AcceptCommunication(kNormalSpeed);
+    speed_button_->setCaption("Speed x1");
+    fast_forward_ = false;
+  } else {
+    controller_->AcceptCommunication(kFastForward);
+    speed_button_->setCaption("Speed x" + std::to_string(SIM_FAST_FORWARD));
+    fast_forward_ = true;
+  }
+} /* OnSpeedBtnPressed() */
+
 /*******************************************************************************
  * Drawing of Entities in Arena
  ******************************************************************************/
@@ -275,14 +327,14 @@ void GraphicsArenaViewer::OnFoodBtnPressed() {
   * However, the actual position of sensors has been tested and is accurate.
 */
 void GraphicsArenaViewer::DrawSensors(NVGcontext *ctx,
-                                     const Robot *const robot) {
+                                     const RenderEntity &robot) {
   nvgSave(ctx);
   nvgTranslate(ctx,
-    static_cast<float>(robot->get_left_sensor_pose().x),
-    static_cast<float>(robot->get_left_sensor_pose().y));
+    static_cast<float>(robot.left_sensor_x),
+    static_cast<float>(robot.left_sensor_y));
   // Sensor circle
   nvgBeginPath(ctx);
-  nvgCircle(ctx, 0.0, 0.0, robot->get_radius()/2);
+  nvgCircle(ctx, 0.0, 0.0, robot.radius/2);
   nvgFillColor(ctx,
               nvgRGBA(255, 255, 0, 255));
   nvgFill(ctx);
@@ -293,11 +345,11 @@ void GraphicsArenaViewer::DrawSensors(NVGcontext *ctx,
 
   nvgSave(ctx);
   nvgTranslate(ctx,
-   static_cast<float>(robot->get_right_sensor_pose().x),
-   static_cast<float>(robot->get_right_sensor_pose().y));
+   static_cast<float>(robot.right_sensor_x),
+   static_cast<float>(robot.right_sensor_y));
   // Sensor circle
   nvgBeginPath(ctx);
-  nvgCircle(ctx, 0.0, 0.0, robot->get_radius()/2);
+  nvgCircle(ctx, 0.0, 0.0, robot.radius/2);
   nvgFillColor(ctx,
                nvgRGBA(255, 255, 0, 255));
   nvgFill(ctx);
@@ -307,25 +359,26 @@ void GraphicsArenaViewer::DrawSensors(NVGcontext *ctx,
   nvgRestore(ctx);
 } /* DrawSensors() */
 
-void GraphicsArenaViewer::DrawArena(NVGcontext *ctx) {
+void GraphicsArenaViewer::DrawArena(NVGcontext *ctx,
+                                    const RenderSnapshot &snapshot) {
   nvgBeginPath(ctx);
   // Creates new rectangle shaped sub-path.
-  nvgRect(ctx, 0, 0, arena_->get_x_dim(), arena_->get_y_dim());
+  nvgRect(ctx, 0, 0, snapshot.x_dim, snapshot.y_dim);
   nvgStrokeColor(ctx, nvgRGBA(255, 255, 255, 255));
   nvgStroke(ctx);
 } /* DrawArena() */
 
 void GraphicsArenaViewer::DrawEntity(NVGcontext *ctx,
-                                       const ArenaEntity *const entity) {
+                                       const RenderEntity &entity) {
   // light's circle
   nvgBeginPath(ctx);
   nvgCircle(ctx,
-            static_cast<float>(entity->get_pose().x),
-            static_cast<float>(entity->get_pose().y),
-            static_cast<float>(entity->get_radius()));
+            static_cast<float>(entity.x),
+            static_cast<float>(entity.y),
+            static_cast<float>(entity.radius));
   nvgFillColor(ctx,
-               nvgRGBA(entity->get_color().r, entity->get_color().g,
-                       entity->get_color().b, 255));
+               nvgRGBA(entity.color.r, entity.color.g,
+                       entity.color.b, 255));
   nvgFill(ctx);
   nvgStrokeColor(ctx, nvgRGBA(0, 0, 0, 255));
   nvgStroke(ctx);
@@ -333,9 +386,9 @@ void GraphicsArenaViewer::DrawEntity(NVGcontext *ctx,
   // light id text label
   nvgFillColor(ctx, nvgRGBA(0, 0, 0, 255));
   nvgText(ctx,
-          static_cast<float>(entity->get_pose().x),
-          static_cast<float>(entity->get_pose().y),
-          entity->get_name().c_str(), nullptr);
+          static_cast<float>(entity.x),
+          static_cast<float>(entity.y),
+          entity.get_name().c_str(), nullptr);
 } /* DrawEntity() */
 
 void GraphicsArenaViewer::DrawUsingNanoVG(NVGcontext *ctx) {
@@ -343,14 +396,41 @@ void GraphicsArenaViewer::DrawUsingNanoVG(NVGcontext *ctx) {
   nvgFontSize(ctx, 12.0f);
   nvgFontFace(ctx, "sans-bold");
   nvgTextAlign(ctx, NVG_ALIGN_CENTER | NVG_ALIGN_MIDDLE);
-  DrawArena(ctx);
-  std::vector<ArenaEntity *> entities = arena_->get_entities();
-  for (auto &entity : entities) {
-    if (entity->get_type() == kRobot) {
-      DrawSensors(ctx, dynamic_cast<Robot *>(entity));
+  const RenderSnapshot &snapshot =
+    replaying_ ? replay_snapshot_ : controller_->get_snapshot();
+  DrawArena(ctx, snapshot);
+  for (const RenderEntity &entity : snapshot.entities) {
+    if (entity.type == kRobot) {
+      DrawSensors(ctx, entity);
     }
     DrawEntity(ctx, entity);
   } /* for(i..) */
+#ifdef ARENA_PROFILE
+  DrawProfile(ctx, snapshot);
+#endif
 } /* DrawUsingNanoVG() */
 
+#ifdef ARENA_PROFILE
+void GraphicsArenaViewer::DrawProfile(NVGcontext *ctx,
+                                      const RenderSnapshot &snapshot) {
+  nvgSave(ctx);
+  nvgFontSize(ctx, 11.0f);
+  nvgFontFace(ctx, "sans");
+  nvgTextAlign(ctx, NVG_ALIGN_LEFT | NVG_ALIGN_TOP);
+  nvgFillColor(ctx, nvgRGBA(255, 255, 255, 255));
+  char line[96];
+  snprintf(line, sizeof(line), "%-11s %8s %8s %8s (us)", "phase", "p50", "p99",
+           "max");
+  nvgText(ctx, 5, 5, line, nullptr);
+  for (int p = 0; p < kPhaseCount; ++p) {
+    ProfilePhase phase = static_cast<ProfilePhase>(p);
+    const PhaseStats &stats = snapshot.phase_stats[p];
+    snprintf(line, sizeof(line), "%-11s %8.1f %8.1f %8.1f",
+             PhaseProfiler::PhaseName(phase), stats.p50, stats.p99, stats.max);
+    nvgText(ctx, 5, 5 + 14.0f * (p + 1), line, nullptr);
+  }
+  nvgRestore(ctx);
+} /* DrawProfile() */
+#endif
+
 NAMESPACE_END(csci3081);
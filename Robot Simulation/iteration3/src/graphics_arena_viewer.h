@@ -16,6 +16,9 @@
 #include "src/controller.h"
 #include "src/common.h"
 #include "src/communication.h"
+#include "src/render_snapshot.h"
+#include "src/step_accumulator.h"
+#include "src/trajectory.h"
 
 /*******************************************************************************
  * Namespaces
@@ -45,7 +48,13 @@ class Controller;
  *  ```
  *
  *  While the window is open UpdateSimulation will be called repeatedly,
- *  once per frame.
+ *  once per frame. The Arena is stepped on the Controller's
+ *  SimulationThread; each frame draws the latest RenderSnapshot it published.
+ *
+ *  In replay mode the viewer instead plays back a trajectory recorded by
+ *  the headless driver (`--record`), without running the simulation. Play,
+ *  New Game (back to the start) and Speed work as usual; the arena
+ *  configuration is ignored.
  */
 class GraphicsArenaViewer : public GraphicsApp {
  public:
@@ -54,9 +63,12 @@ class GraphicsArenaViewer : public GraphicsApp {
    *
    * @param params A arena_params passed down from main.cc for the
    * initialization of the Arena and the entities therein.
+   * @param replay A trajectory file to play back instead of simulating,
+   * or nullptr.
    */
-  explicit GraphicsArenaViewer(const struct arena_params *const params,
-                               Arena *arena, Controller *controller);
+  GraphicsArenaViewer(const struct arena_params *const params,
+                      Arena *arena, Controller *controller,
+                      const char *replay = nullptr);
 
   /**
    * @brief Destructor.
@@ -66,12 +78,19 @@ class GraphicsArenaViewer : public GraphicsApp {
   ~GraphicsArenaViewer() override { delete arena_; }
 
   /**
-   * @brief Informs the Arena of the new time, so that it can update.
+   * @brief Called once per frame. When replaying, moves on as many frames
+   * of the trajectory as dt is worth; otherwise there is nothing to do, as
+   * the Arena is stepped on its own thread.
    *
-   * @param dt The new timestep.
+   * @param dt The time since the last frame.
    */
   void UpdateSimulation(double dt) override;
 
+  /**
+   * @brief Whether a trajectory is being played back (see the constructor).
+   */
+  bool is_replaying() const { return replaying_; }
+
   /**
    * @brief Configures the parameters of the Arena based on user input.
    *
@@ -101,6 +120,11 @@ class GraphicsArenaViewer : public GraphicsApp {
    */
   void OnFoodBtnPressed();
 
+  /**
+   * @brief Toggle fast-forward (SIM_FAST_FORWARD times normal speed).
+   */
+  void OnSpeedBtnPressed();
+
   /**
    * @brief Called each time the mouse moves on the screen within the GUI
    * window.
@@ -169,7 +193,8 @@ class GraphicsArenaViewer : public GraphicsApp {
    * @brief Draw the Arena with all of its entities using `nanogui`.
    *
    * This is the primary driver for drawing all entities in the Arena. It is
-   * called at each iteration of `nanogui::mainloop()`.
+   * called at each iteration of `nanogui::mainloop()`, and draws the latest
+   * snapshot of the Arena without waiting for the simulation.
    *
    * @param[in] ctx Context for nanogui.
    */
@@ -212,8 +237,9 @@ class GraphicsArenaViewer : public GraphicsApp {
     * should probably only be called from with DrawUsingNanoVG.
     *
     * @param[in] ctx The `nanovg` context.
+    * @param[in] snapshot The Arena to draw.
     */
-  void DrawArena(NVGcontext *ctx);
+  void DrawArena(NVGcontext *ctx, const RenderSnapshot &snapshot);
 
   /**
    * @brief Draw a Robot's sensors using `nanogui`.
@@ -222,9 +248,9 @@ class GraphicsArenaViewer : public GraphicsApp {
    * should probably only be called from with DrawUsingNanoVG.
    *
    * @param[in] ctx The `nanovg` context.
-   * @param[in] robot The specific Robot handle.
+   * @param[in] robot The specific Robot.
    */
-  void DrawSensors(NVGcontext *ctx, const class Robot *const robot);
+  void DrawSensors(NVGcontext *ctx, const RenderEntity &robot);
 
   /**
    * @brief Draw any entity using `nanogui`.
@@ -233,13 +259,24 @@ class GraphicsArenaViewer : public GraphicsApp {
    * should probably only be called from with DrawUsingNanoVG.
    *
    * @param[in] ctx The `nanovg` context.
-   * @param[in] entity The entity's handle.
+   * @param[in] entity The entity to draw.
    */
-  void DrawEntity(NVGcontext *ctx, const class ArenaEntity *const entity);
+  void DrawEntity(NVGcontext *ctx, const RenderEntity &entity);
+
+#ifdef ARENA_PROFILE
+  /**
+   * @brief Draw the Arena's phase timings in the top left corner. Only
+   * built with -DARENA_PROFILE.
+   *
+   * @param[in] ctx The `nanovg` context.
+   * @param[in] snapshot The snapshot holding the timings.
+   */
+  void DrawProfile(NVGcontext *ctx, const RenderSnapshot &snapshot);
+#endif
 
   // Controller pointer used to access controller methods.
   Controller *controller_;
-  // Arena pointer used to access arena methods.
+  // The Arena, owned by the viewer. Only the SimulationThread touches it.
   Arena *arena_;
   // Determines whether or not GraphicsArenaViewer continues to update.
   bool paused_{true};
@@ -250,6 +287,16 @@ class GraphicsArenaViewer : public GraphicsApp {
   nanogui::Button *playing_button_{nullptr};
   nanogui::Button *new_game_button_{nullptr};
   nanogui::Button *food_button_{nullptr};
+  nanogui::Button *speed_button_{nullptr};
+  // Whether the simulation is running in fast-forward.
+  bool fast_forward_{false};
+
+  // Replay mode: the trajectory, the frame being shown and the clock
+  // pacing the frames like the SimulationThread paces timesteps.
+  bool replaying_{false};
+  TrajectoryReader replay_;
+  RenderSnapshot replay_snapshot_;
+  StepAccumulator replay_clock_;
 };
 
 NAMESPACE_END(csci3081);
@@ -0,0 +1,227 @@
+/**
+ * @file headless_main.cc
+ *
+ * @copyright 2018 Nate Samuelson, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#include "src/arena.h"
+#include "src/arena_params.h"
+#include "src/robot.h"
+#include "src/trajectory.h"
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+static void PrintUsage(const char *exe) {
+  std::cout << "usage: " << exe << " [options]\n"
+            << "  --robots N       number of robots (default " << N_ROBOTS
+            << ")\n"
+            << "  --lights N       number of lights (default " << N_LIGHTS
+            << ")\n"
+            << "  --foods N        number of food entities (default "
+            << N_FOODS << ")\n"
+            << "  --ratio R        fraction of explore robots (default 0.5)\n"
+            << "  --sensitivity S  robot light sensitivity (default 1.0)\n"
+            << "  --steps N        timesteps to run (default 10000)\n"
+            << "  --threads N      threads used to step the arena (default "
+            << N_THREADS << ")\n"
+            << "  --field-res P    sample sensors from intensity fields with\n"
+            << "                   nodes P pixels apart (default 0: exact)\n"
+            << "  --seed N         random seed, for reproducible runs (default "
+            << ARENA_SEED << ": random)\n"
+            << "  --no-food        disable food and hunger\n"
+            << "  --keep-going     keep stepping after a robot starves\n"
+            << "  --resume F       start from the checkpoint in file F instead\n"
+            << "                   of a new arena\n"
+            << "  --checkpoint F   save a checkpoint to file F at the end\n"
+            << "  --record F       record every timestep to trajectory file F\n"
+            << "  --profile-csv F  file for the phase timings (default "
+            << PROFILE_CSV_FILE << ", needs a PROFILE=1 build)\n";
+}
+
+static const char *StatusName(int status) {
+  switch (status) {
+    case WON: return "WON";
+    case LOST: return "LOST";
+    case PLAYING: return "PLAYING";
+    case PAUSED: return "PAUSED";
+    default: return "UNKNOWN";
+  }
+}
+
+/**
+ * Headless batch driver. Builds an Arena from arena_params (and a few
+ * behavior parameters normally set with the GUI sliders), steps it as fast as
+ * possible and prints the throughput and the final state of the Arena. No
+ * graphics libraries are needed, so it can be built with `make headless` on
+ * machines without a display.
+ */
+int main(int argc, char **argv) {
+  csci3081::arena_params aparams;
+  aparams.n_robots = N_ROBOTS;
+  aparams.n_lights = N_LIGHTS;
+  aparams.n_foods = N_FOODS;
+  aparams.x_dim = ARENA_X_DIM;
+  aparams.y_dim = ARENA_Y_DIM;
+  aparams.n_threads = N_THREADS;
+  double robot_ratio = 0.5;
+  double light_sensitivity = 1.0;
+  long steps = 10000;
+  bool food = true;
+  bool keep_going = false;
+  const char *profile_csv = PROFILE_CSV_FILE;
+  const char *resume = nullptr;
+  const char *checkpoint = nullptr;
+  const char *record = nullptr;
+
+  for (int i = 1; i < argc; ++i) {
+    bool has_value = i + 1 < argc;
+    if (!strcmp(argv[i], "--robots") && has_value) {
+      aparams.n_robots = strtoul(argv[++i], nullptr, 10);
+    } else if (!strcmp(argv[i], "--lights") && has_value) {
+      aparams.n_lights = strtoul(argv[++i], nullptr, 10);
+    } else if (!strcmp(argv[i], "--foods") && has_value) {
+      aparams.n_foods = strtoul(argv[++i], nullptr, 10);
+    } else if (!strcmp(argv[i], "--ratio") && has_value) {
+      robot_ratio = atof(argv[++i]);
+    } else if (!strcmp(argv[i], "--sensitivity") && has_value) {
+      light_sensitivity = atof(argv[++i]);
+    } else if (!strcmp(argv[i], "--steps") && has_value) {
+      steps = atol(argv[++i]);
+    } else if (!strcmp(argv[i], "--threads") && has_value) {
+      aparams.n_threads = strtoul(argv[++i], nullptr, 10);
+    } else if (!strcmp(argv[i], "--field-res") && has_value) {
+      aparams.field_resolution = atof(argv[++i]);
+    } else if (!strcmp(argv[i], "--seed") && has_value) {
+      aparams.seed = strtoull(argv[++i], nullptr, 10);
+    } else if (!strcmp(argv[i], "--no-food")) {
+      food = false;
+    } else if (!strcmp(argv[i], "--keep-going")) {
+      keep_going = true;
+    } else if (!strcmp(argv[i], "--resume") && has_value) {
+      resume = argv[++i];
+    } else if (!strcmp(argv[i], "--checkpoint") && has_value) {
+      checkpoint = argv[++i];
+    } else if (!strcmp(argv[i], "--record") && has_value) {
+      record = argv[++i];
+    } else if (!strcmp(argv[i], "--profile-csv") && has_value) {
+      profile_csv = argv[++i];
+    } else {
+      PrintUsage(argv[0]);
+      return 1;
+    }
+  }
+
+  csci3081::Arena arena(&aparams);
+  if (resume) {
+    if (!arena.LoadCheckpoint(resume)) {
+      std::cerr << "cannot resume from " << resume << ": "
+                << strerror(errno) << std::endl;
+      return 1;
+    }
+  } else {
+    // Same set up sequence as GraphicsArenaViewer::Initialize()
+    int explorers = static_cast<int>(robot_ratio * aparams.n_robots);
+    int cowards = static_cast<int>(aparams.n_robots) - explorers;
+    arena.set_light_sensitivity(light_sensitivity);
+    arena.AddRobot(cowards, csci3081::kCoward);
+    arena.AddRobot(explorers, csci3081::kExplore);
+    arena.AddLight(static_cast<int>(aparams.n_lights));
+    if (food) {
+      arena.AddFood(static_cast<int>(aparams.n_foods));
+      arena.AcceptCommand(csci3081::kFoodOn);
+    } else {
+      arena.AcceptCommand(csci3081::kFoodOff);
+    }
+    arena.AcceptCommand(csci3081::kPlay);
+  }
+
+  // The recording starts with the arena as set up.
+  csci3081::TrajectoryWriter recorder;
+  if (record) {
+    if (!recorder.Open(record, arena.get_x_dim(), arena.get_y_dim()) ||
+        !recorder.AddFrame(arena.get_store(), arena.get_game_status(),
+                           arena.get_events())) {
+      std::cerr << "cannot record to " << record << ": " << strerror(errno)
+                << std::endl;
+      return 1;
+    }
+    arena.set_record_events(true);
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  long step = 0;
+  while (step < steps &&
+         (keep_going || arena.get_game_status() == PLAYING)) {
+    arena.AdvanceTime(1);
+    ++step;
+    if (record) {
+      if (!recorder.AddFrame(arena.get_store(), arena.get_game_status(),
+                             arena.get_events())) {
+        std::cerr << "cannot record to " << record << ": "
+                  << strerror(errno) << std::endl;
+        return 1;
+      }
+      arena.ClearEvents();
+    }
+  }
+  std::chrono::duration<double> elapsed =
+    std::chrono::steady_clock::now() - start;
+
+  if (record && !recorder.Close()) {
+    std::cerr << "cannot record to " << record << ": " << strerror(errno)
+              << std::endl;
+    return 1;
+  }
+
+  if (checkpoint && !arena.SaveCheckpoint(checkpoint)) {
+    std::cerr << "cannot save checkpoint " << checkpoint << ": "
+              << strerror(errno) << std::endl;
+    return 1;
+  }
+
+  int starved = 0;
+  double hunger = 0;
+  for (csci3081::Robot *robot : arena.get_robots().entities()) {
+    starved += robot->CheckStarvation() ? 1 : 0;
+    hunger += robot->get_hunger_level();
+  }
+  size_t n_robots = arena.get_n_robots();
+
+  std::cout << "steps:        " << step << "\n"
+            << "elapsed (s):  " << elapsed.count() << "\n"
+            << "steps/sec:    "
+            << (elapsed.count() > 0 ? step / elapsed.count() : 0) << "\n"
+            << "status:       " << StatusName(arena.get_game_status())
+            << "\n"
+            << "threads:      " << arena.get_n_threads() << "\n"
+            << "seed:         " << arena.get_seed() << "\n"
+            << "robots:       " << n_robots << "\n"
+            << "lights:       " << arena.get_n_lights() << "\n"
+            << "foods:        " << arena.get_n_foods() << "\n"
+            << "starved:      " << starved << "\n"
+            << "mean hunger:  " << (n_robots ? hunger / n_robots : 0)
+            << std::endl;
+  if (record) {
+    std::cout << "recorded:     " << recorder.get_n_frames() << " frames, "
+              << recorder.get_size() << " bytes" << std::endl;
+  }
+
+  if (csci3081::PhaseProfiler::kEnabled) {
+    std::cout << "\nlast " << PROFILE_WINDOW << " timesteps (us):\n";
+    arena.WriteProfileCsv(std::cout);
+    std::ofstream csv(profile_csv);
+    arena.WriteProfileCsv(csv);
+  }
+  return 0;
+}
@@ -0,0 +1,73 @@
+/**
+ * @file intensity_field.cc
+ *
+ * @copyright 2018 Nate Samuelson, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <algorithm>
+#include <cmath>
+
+#include "src/intensity_field.h"
+#include "src/sensor_kernel.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Constants
+ ******************************************************************************/
+// Nodes are computed with a small gain so the kernel's clamp at 1000 is never
+// reached, then scaled back to unit gain.
+static const double kNodeGain = 1e-3;
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+void IntensityField::Resize(double x_dim, double y_dim, double spacing) {
+  spacing_ = std::max(spacing, 1.0);
+  // One node past the far edge, so every cell has four corners.
+  n_cols_ = std::max(1, static_cast<int>(std::ceil(x_dim / spacing_))) + 1;
+  n_rows_ = std::max(1, static_cast<int>(std::ceil(y_dim / spacing_))) + 1;
+  size_t n_nodes = static_cast<size_t>(n_cols_ * n_rows_);
+  node_x_.resize(n_nodes);
+  node_y_.resize(n_nodes);
+  gain_.assign(n_nodes, kNodeGain);
+  value_.assign(n_nodes, 0);
+  for (int row = 0; row < n_rows_; ++row) {
+    for (int col = 0; col < n_cols_; ++col) {
+      node_x_[row * n_cols_ + col] = col * spacing_;
+      node_y_[row * n_cols_ + col] = row * spacing_;
+    }
+  }
+} /* Resize() */
+
+void IntensityField::Compute(size_t begin, size_t end, const double *source_x,
+                             const double *source_y, size_t n_sources) {
+  std::fill(value_.begin() + begin, value_.begin() + end, 0);
+  AccumulateSensorReadings(&node_x_[begin], &node_y_[begin], &gain_[begin],
+                           end - begin, source_x, source_y, n_sources,
+                           &value_[begin]);
+  for (size_t i = begin; i < end; ++i) {
+    value_[i] /= kNodeGain;
+  }
+} /* Compute() */
+
+double IntensityField::Sample(double x, double y) const {
+  double fx = std::min(std::max(x / spacing_, 0.0), n_cols_ - 1.0);
+  double fy = std::min(std::max(y / spacing_, 0.0), n_rows_ - 1.0);
+  int col = std::min(static_cast<int>(fx), n_cols_ - 2);
+  int row = std::min(static_cast<int>(fy), n_rows_ - 2);
+  double tx = fx - col;
+  double ty = fy - row;
+  const double *top = &value_[row * n_cols_ + col];
+  const double *bottom = top + n_cols_;
+  return (1 - ty) * ((1 - tx) * top[0] + tx * top[1]) +
+         ty * ((1 - tx) * bottom[0] + tx * bottom[1]);
+} /* Sample() */
+
+NAMESPACE_END(csci3081);
@@ -0,0 +1,86 @@
+/**
+ * @file intensity_field.h
+ *
+ * @copyright 2018 Nate Samuelson, All rights reserved.
+ */
+
+#ifndef SRC_INTENSITY_FIELD_H_
+#define SRC_INTENSITY_FIELD_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <cstddef>
+#include <vector>
+
+#include "src/common.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief The light (or food) intensity over the Arena, cached on a grid of
+ * nodes so that a sensor reading costs one bilinear sample instead of a loop
+ * over every source.
+ *
+ * The value at each node is the reading AccumulateSensorReadings() gives a
+ * sensor with unit gain at that node, before clamping. A sensor's reading is
+ * then approximately `gain * Sample(x, y)`, clamped at 1000 as usual. The
+ * error grows with the node spacing; with nodes 8 pixels apart, readings are
+ * within a percent of the exact ones except right on top of a source, where
+ * they are saturated anyway.
+ *
+ * Nodes are computed in independent ranges by Compute(), so the Arena can
+ * spread the work over its ThreadPool.
+ */
+class IntensityField {
+ public:
+  IntensityField() : node_x_(), node_y_(), gain_(), value_() {}
+
+  /**
+   * @brief Lay out nodes every `spacing` pixels over [0, x_dim] x [0, y_dim].
+   * All values are zero until computed.
+   */
+  void Resize(double x_dim, double y_dim, double spacing);
+
+  /**
+   * @brief Compute the value of nodes [begin, end) from the given sources.
+   *
+   * @param[in] source_x, source_y Light or food positions, n_sources each.
+   */
+  void Compute(size_t begin, size_t end, const double *source_x,
+               const double *source_y, size_t n_sources);
+
+  /**
+   * @brief Bilinear interpolation of the node values around (x, y).
+   * Positions outside of the Arena are clamped to its border.
+   */
+  double Sample(double x, double y) const;
+
+  /**
+   * @brief Number of nodes, i.e. the end of the range Compute() accepts.
+   */
+  size_t size() const { return value_.size(); }
+
+ private:
+  // Number of columns and rows of nodes.
+  int n_cols_{1};
+  int n_rows_{1};
+  // Distance between neighboring nodes. Zero until the first Resize().
+  double spacing_{0};
+  // Node positions and values in row major order, and the gain they are
+  // computed with.
+  std::vector<double> node_x_;
+  std::vector<double> node_y_;
+  std::vector<double> gain_;
+  std::vector<double> value_;
+};
+
+NAMESPACE_END(csci3081);
+
+#endif  // SRC_INTENSITY_FIELD_H_
@@ -0,0 +1,287 @@
+/**
+ * @file kinematics_kernel.cc
+ *
+ * @copyright 2018 Nate Samuelson, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) && defined(__GNUC__)
+#include <immintrin.h>
+#define KINEMATICS_KERNEL_X86 1
+#endif
+
+#include "src/kinematics_kernel.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Constants
+ ******************************************************************************/
+static const double kDegToRad = M_PI / 180.0;
+// sin(x) and cos(x) are evaluated from r = x - n * pi/2, n = round(x * 2/pi),
+// with pi/2 in three parts of 33 bits so that n * part is exact for |n| up
+// to 2^20.
+static const double kTwoOverPi = 6.36619772367581382433e-01;
+static const double kPio2Hi = 1.57079632673412561417e+00;
+static const double kPio2Mid = 6.07710050630396597660e-11;
+static const double kPio2Lo = 2.02226624871116645580e-21;
+// Adding 1.5 * 2^52 rounds to an integer and leaves it in the low mantissa
+// bits, where its two lowest bits give the quadrant.
+static const double kRoundShift = 6755399441055744.0;
+// Minimax polynomials for |r| <= pi/4 (from fdlibm's __kernel_sin and
+// __kernel_cos), highest degree first:
+//   sin(r) = r + r^3 * S(r^2),  cos(r) = 1 - r^2/2 + r^4 * C(r^2)
+static const double kSinPoly[] = {
+  1.58969099521155010221e-10, -2.50507602534068634195e-08,
+  2.75573137070700676789e-06, -1.98412698298579493134e-04,
+  8.33333333332248946124e-03, -1.66666666666666324348e-01};
+static const double kCosPoly[] = {
+  -1.13596475577881948265e-11, 2.08757232129817482790e-09,
+  -2.75573143513906633035e-07, 2.48015872894767294178e-05,
+  -1.38888888888741095749e-03, 4.16666666666666019037e-02};
+static const int kPolySize = sizeof(kSinPoly) / sizeof(kSinPoly[0]);
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+static double FlipSign(double x, uint64_t sign) {
+  uint64_t bits;
+  memcpy(&bits, &x, sizeof(bits));
+  bits ^= sign;
+  memcpy(&x, &bits, sizeof(x));
+  return x;
+} /* FlipSign() */
+
+void KinematicsKernelSinCos(double x, double *sine, double *cosine) {
+  double t = x * kTwoOverPi + kRoundShift;
+  double n = t - kRoundShift;
+  double r = x - n * kPio2Hi;
+  r = r - n * kPio2Mid;
+  r = r - n * kPio2Lo;
+  double z = r * r;
+  double ps = kSinPoly[0];
+  double pc = kCosPoly[0];
+  for (int k = 1; k < kPolySize; ++k) {
+    ps = ps * z + kSinPoly[k];
+    pc = pc * z + kCosPoly[k];
+  }
+  double s = r + r * z * ps;
+  // 1 - z/2 loses the low bits of z/2; they are added back separately.
+  double hz = 0.5 * z;
+  double w = 1 - hz;
+  double c = w + (((1 - w) - hz) + z * z * pc);
+  // In quadrant q, (sin x, cos x) is (s, c), (c, -s), (-s, -c) or (-c, s).
+  uint64_t q;
+  memcpy(&q, &t, sizeof(q));
+  *sine = FlipSign((q & 1) ? c : s, (q & 2) << 62);
+  *cosine = FlipSign((q & 1) ? s : c, ((q + 1) & 2) << 62);
+} /* KinematicsKernelSinCos() */
+
+static void IntegrateScalar(double *x, double *y, double *theta,
+                            const double *vel_left, const double *vel_right,
+                            size_t begin, size_t end, double dt) {
+  for (size_t i = begin; i < end; ++i) {
+    double d = vel_left[i] - vel_right[i];
+    double h = d * dt;
+    double s0, c0, sh, ch;
+    KinematicsKernelSinCos(theta[i] * kDegToRad, &s0, &c0);
+    KinematicsKernelSinCos(h, &sh, &ch);
+    bool straight = !(std::fabs(d) > 0);
+    double speed = straight ? vel_left[i] * dt :
+      (vel_left[i] + vel_right[i]) * sh / d;
+    x[i] = x[i] + speed * (c0 * ch - s0 * sh);
+    y[i] = y[i] + speed * (s0 * ch + c0 * sh);
+    theta[i] = theta[i] + (h + h);
+  }
+} /* IntegrateScalar() */
+
+#ifdef KINEMATICS_KERNEL_X86
+/*
+ * The vector versions repeat KinematicsKernelSinCos() and IntegrateScalar()
+ * lane for lane, with the same operations in the same order (and no fused
+ * multiply-add), so every path rounds identically. The straight-line case is
+ * blended in with a mask, dividing by 1 instead of 0 in its lanes.
+ */
+static __m128d Select2(__m128d mask, __m128d a, __m128d b) {
+  return _mm_or_pd(_mm_and_pd(mask, a), _mm_andnot_pd(mask, b));
+} /* Select2() */
+
+static void SinCos2(__m128d x, __m128d *sine, __m128d *cosine) {
+  __m128d shift = _mm_set1_pd(kRoundShift);
+  __m128d t = _mm_add_pd(_mm_mul_pd(x, _mm_set1_pd(kTwoOverPi)), shift);
+  __m128d n = _mm_sub_pd(t, shift);
+  __m128d r = _mm_sub_pd(x, _mm_mul_pd(n, _mm_set1_pd(kPio2Hi)));
+  r = _mm_sub_pd(r, _mm_mul_pd(n, _mm_set1_pd(kPio2Mid)));
+  r = _mm_sub_pd(r, _mm_mul_pd(n, _mm_set1_pd(kPio2Lo)));
+  __m128d z = _mm_mul_pd(r, r);
+  __m128d ps = _mm_set1_pd(kSinPoly[0]);
+  __m128d pc = _mm_set1_pd(kCosPoly[0]);
+  for (int k = 1; k < kPolySize; ++k) {
+    ps = _mm_add_pd(_mm_mul_pd(ps, z), _mm_set1_pd(kSinPoly[k]));
+    pc = _mm_add_pd(_mm_mul_pd(pc, z), _mm_set1_pd(kCosPoly[k]));
+  }
+  __m128d s = _mm_add_pd(r, _mm_mul_pd(_mm_mul_pd(r, z), ps));
+  __m128d one = _mm_set1_pd(1);
+  __m128d hz = _mm_mul_pd(_mm_set1_pd(0.5), z);
+  __m128d w = _mm_sub_pd(one, hz);
+  __m128d c = _mm_add_pd(w, _mm_add_pd(_mm_sub_pd(_mm_sub_pd(one, w), hz),
+                                       _mm_mul_pd(_mm_mul_pd(z, z), pc)));
+  __m128i q = _mm_castpd_si128(t);
+  __m128i bit0 = _mm_set1_epi64x(1);
+  __m128i bit1 = _mm_set1_epi64x(2);
+  __m128d swap = _mm_castsi128_pd(
+    _mm_sub_epi64(_mm_setzero_si128(), _mm_and_si128(q, bit0)));
+  __m128d sin_sign = _mm_castsi128_pd(
+    _mm_slli_epi64(_mm_and_si128(q, bit1), 62));
+  __m128d cos_sign = _mm_castsi128_pd(
+    _mm_slli_epi64(_mm_and_si128(_mm_add_epi64(q, bit0), bit1), 62));
+  *sine = _mm_xor_pd(Select2(swap, c, s), sin_sign);
+  *cosine = _mm_xor_pd(Select2(swap, s, c), cos_sign);
+} /* SinCos2() */
+
+static size_t IntegrateSse2(double *x, double *y, double *theta,
+                            const double *vel_left, const double *vel_right,
+                            size_t n, double dt) {
+  __m128d vdt = _mm_set1_pd(dt);
+  __m128d abs_mask = _mm_castsi128_pd(_mm_set1_epi64x(INT64_MAX));
+  size_t i = 0;
+  for (; i + 2 <= n; i += 2) {
+    __m128d left = _mm_loadu_pd(vel_left + i);
+    __m128d right = _mm_loadu_pd(vel_right + i);
+    __m128d heading = _mm_loadu_pd(theta + i);
+    __m128d d = _mm_sub_pd(left, right);
+    __m128d h = _mm_mul_pd(d, vdt);
+    __m128d s0, c0, sh, ch;
+    SinCos2(_mm_mul_pd(heading, _mm_set1_pd(kDegToRad)), &s0, &c0);
+    SinCos2(h, &sh, &ch);
+    __m128d straight = _mm_cmpngt_pd(_mm_and_pd(d, abs_mask),
+                                     _mm_setzero_pd());
+    __m128d speed = Select2(straight, _mm_mul_pd(left, vdt),
+      _mm_div_pd(_mm_mul_pd(_mm_add_pd(left, right), sh),
+                 Select2(straight, _mm_set1_pd(1), d)));
+    __m128d dir_x = _mm_sub_pd(_mm_mul_pd(c0, ch), _mm_mul_pd(s0, sh));
+    __m128d dir_y = _mm_add_pd(_mm_mul_pd(s0, ch), _mm_mul_pd(c0, sh));
+    _mm_storeu_pd(x + i, _mm_add_pd(_mm_loadu_pd(x + i),
+                                    _mm_mul_pd(speed, dir_x)));
+    _mm_storeu_pd(y + i, _mm_add_pd(_mm_loadu_pd(y + i),
+                                    _mm_mul_pd(speed, dir_y)));
+    _mm_storeu_pd(theta + i, _mm_add_pd(heading, _mm_add_pd(h, h)));
+  }
+  return i;
+} /* IntegrateSse2() */
+
+__attribute__((target("avx2")))
+static __m256d Select4(__m256d mask, __m256d a, __m256d b) {
+  return _mm256_blendv_pd(b, a, mask);
+} /* Select4() */
+
+__attribute__((target("avx2")))
+static void SinCos4(__m256d x, __m256d *sine, __m256d *cosine) {
+  __m256d shift = _mm256_set1_pd(kRoundShift);
+  __m256d t = _mm256_add_pd(_mm256_mul_pd(x, _mm256_set1_pd(kTwoOverPi)),
+                            shift);
+  __m256d n = _mm256_sub_pd(t, shift);
+  __m256d r = _mm256_sub_pd(x, _mm256_mul_pd(n, _mm256_set1_pd(kPio2Hi)));
+  r = _mm256_sub_pd(r, _mm256_mul_pd(n, _mm256_set1_pd(kPio2Mid)));
+  r = _mm256_sub_pd(r, _mm256_mul_pd(n, _mm256_set1_pd(kPio2Lo)));
+  __m256d z = _mm256_mul_pd(r, r);
+  __m256d ps = _mm256_set1_pd(kSinPoly[0]);
+  __m256d pc = _mm256_set1_pd(kCosPoly[0]);
+  for (int k = 1; k < kPolySize; ++k) {
+    ps = _mm256_add_pd(_mm256_mul_pd(ps, z), _mm256_set1_pd(kSinPoly[k]));
+    pc = _mm256_add_pd(_mm256_mul_pd(pc, z), _mm256_set1_pd(kCosPoly[k]));
+  }
+  __m256d s = _mm256_add_pd(r, _mm256_mul_pd(_mm256_mul_pd(r, z), ps));
+  __m256d one = _mm256_set1_pd(1);
+  __m256d hz = _mm256_mul_pd(_mm256_set1_pd(0.5), z);
+  __m256d w = _mm256_sub_pd(one, hz);
+  __m256d c = _mm256_add_pd(w, _mm256_add_pd(
+    _mm256_sub_pd(_mm256_sub_pd(one, w), hz),
+    _mm256_mul_pd(_mm256_mul_pd(z, z), pc)));
+  __m256i q = _mm256_castpd_si256(t);
+  __m256i bit0 = _mm256_set1_epi64x(1);
+  __m256i bit1 = _mm256_set1_epi64x(2);
+  __m256d swap = _mm256_castsi256_pd(
+    _mm256_slli_epi64(_mm256_and_si256(q, bit0), 63));
+  __m256d sin_sign = _mm256_castsi256_pd(
+    _mm256_slli_epi64(_mm256_and_si256(q, bit1), 62));
+  __m256d cos_sign = _mm256_castsi256_pd(_mm256_slli_epi64(
+    _mm256_and_si256(_mm256_add_epi64(q, bit0), bit1), 62));
+  *sine = _mm256_xor_pd(Select4(swap, c, s), sin_sign);
+  *cosine = _mm256_xor_pd(Select4(swap, s, c), cos_sign);
+} /* SinCos4() */
+
+__attribute__((target("avx2")))
+static size_t IntegrateAvx2(double *x, double *y, double *theta,
+                            const double *vel_left, const double *vel_right,
+                            size_t n, double dt) {
+  __m256d vdt = _mm256_set1_pd(dt);
+  __m256d abs_mask = _mm256_castsi256_pd(_mm256_set1_epi64x(INT64_MAX));
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m256d left = _mm256_loadu_pd(vel_left + i);
+    __m256d right = _mm256_loadu_pd(vel_right + i);
+    __m256d heading = _mm256_loadu_pd(theta + i);
+    __m256d d = _mm256_sub_pd(left, right);
+    __m256d h = _mm256_mul_pd(d, vdt);
+    __m256d s0, c0, sh, ch;
+    SinCos4(_mm256_mul_pd(heading, _mm256_set1_pd(kDegToRad)), &s0, &c0);
+    SinCos4(h, &sh, &ch);
+    __m256d straight = _mm256_cmp_pd(_mm256_and_pd(d, abs_mask),
+                                     _mm256_setzero_pd(), _CMP_NGT_UQ);
+    __m256d speed = Select4(straight, _mm256_mul_pd(left, vdt),
+      _mm256_div_pd(_mm256_mul_pd(_mm256_add_pd(left, right), sh),
+                    Select4(straight, _mm256_set1_pd(1), d)));
+    __m256d dir_x = _mm256_sub_pd(_mm256_mul_pd(c0, ch),
+                                  _mm256_mul_pd(s0, sh));
+    __m256d dir_y = _mm256_add_pd(_mm256_mul_pd(s0, ch),
+                                  _mm256_mul_pd(c0, sh));
+    _mm256_storeu_pd(x + i, _mm256_add_pd(_mm256_loadu_pd(x + i),
+                                          _mm256_mul_pd(speed, dir_x)));
+    _mm256_storeu_pd(y + i, _mm256_add_pd(_mm256_loadu_pd(y + i),
+                                          _mm256_mul_pd(speed, dir_y)));
+    _mm256_storeu_pd(theta + i,
+                     _mm256_add_pd(heading, _mm256_add_pd(h, h)));
+  }
+  return i;
+} /* IntegrateAvx2() */
+
+static bool HasAvx2() {
+  static const bool has_avx2 = __builtin_cpu_supports("avx2");
+  return has_avx2;
+} /* HasAvx2() */
+#endif  // KINEMATICS_KERNEL_X86
+
+void IntegrateDifferentialDrive(double *x, double *y, double *theta,
+                                const double *vel_left,
+                                const double *vel_right, size_t n,
+                                double dt) {
+  size_t done = 0;
+#ifdef KINEMATICS_KERNEL_X86
+  if (HasAvx2()) {
+    done = IntegrateAvx2(x, y, theta, vel_left, vel_right, n, dt);
+  } else {
+    done = IntegrateSse2(x, y, theta, vel_left, vel_right, n, dt);
+  }
+#endif
+  IntegrateScalar(x, y, theta, vel_left, vel_right, done, n, dt);
+} /* IntegrateDifferentialDrive() */
+
+const char *KinematicsKernelIsa() {
+#ifdef KINEMATICS_KERNEL_X86
+  return HasAvx2() ? "avx2" : "sse2";
+#else
+  return "scalar";
+#endif
+} /* KinematicsKernelIsa() */
+
+NAMESPACE_END(csci3081);
@@ -0,0 +1,67 @@
+/**
+ * @file kinematics_kernel.h
+ *
+ * @copyright 2018 Nate Samuelson, All rights reserved.
+ */
+
+#ifndef SRC_KINEMATICS_KERNEL_H_
+#define SRC_KINEMATICS_KERNEL_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <cstddef>
+
+#include "src/common.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+/**
+ * @brief Batched version of MotionBehaviorDifferential::UpdatePose().
+ *
+ * Moves every entity i by its wheel velocities over dt. With
+ * a = deg2rad(theta[i]), d = vel_left[i] - vel_right[i] and h = d * dt, the
+ * entity follows an arc about its ICC, which works out to
+ *
+ *     x[i] += k * cos(a + h),  y[i] += k * sin(a + h),
+ *     k = (vel_left[i] + vel_right[i]) * sin(h) / d,  theta[i] += 2 * h
+ *
+ * so each entity needs only the sine and cosine of its heading and of h.
+ * When d is zero, k is vel_left[i] * dt instead (driving straight ahead, as
+ * UpdatePose() always has); this case is picked with a mask rather than a
+ * branch.
+ *
+ * Entities are processed four (AVX2) or two (SSE2) at a time depending on
+ * what the CPU supports, with a scalar loop for the remainder. All paths use
+ * KinematicsKernelSinCos(), so they give identical results.
+ *
+ * @param[in,out] x, y, theta Poses, n each.
+ * @param[in] vel_left, vel_right Wheel velocities, n each.
+ * @param[in] dt Elapsed time.
+ */
+void IntegrateDifferentialDrive(double *x, double *y, double *theta,
+                                const double *vel_left,
+                                const double *vel_right, size_t n, double dt);
+
+/**
+ * @brief The sin() and cos() approximation used by
+ * IntegrateDifferentialDrive(). Accurate to about an ulp for |x| below 10^6
+ * radians.
+ */
+void KinematicsKernelSinCos(double x, double *sine, double *cosine);
+
+/**
+ * @brief Name of the instruction set IntegrateDifferentialDrive() uses on
+ * this machine ("avx2", "sse2" or "scalar").
+ */
+const char *KinematicsKernelIsa();
+
+NAMESPACE_END(csci3081);
+
+#endif  // SRC_KINEMATICS_KERNEL_H_
@@ -27,17 +27,23 @@ Light::Light() :
   set_color(LIGHT_COLOR);
   set_pose(LIGHT_INIT_POS);
   set_radius(LIGHT_RADIUS);
-  sensor_touch_->Reset();
+  sensor_touch_.Reset();
 } /* Light() */
 /*******************************************************************************
  * Member Functions
  ******************************************************************************/
-void Light::Reset() {
-  set_pose(set_pose_randomly());
-  set_heading(LIGHT_HEADING);
+void Light::Reset(Rng *rng) {
+  set_pose(set_pose_randomly(rng));
+  set_heading(LIGHT_HEADING(rng));
 } /* Reset() */
 
 void Light::TimestepUpdate(unsigned int dt) {
+  UpdateControl();
+  // Use velocity and position to update position
+  motion_behavior_.UpdatePose(dt, motion_handler_.get_velocity());
+} /* TimestepUpdate() */
+
+bool Light::UpdateControl() {
   if (GetState() && avoid_time_ > 0) {
     motion_handler_.set_velocity(AVOIDANCE_VELOCITY,
                                 AVOIDANCE_VELOCITY);
@@ -51,12 +57,36 @@ void Light::TimestepUpdate(unsigned int dt) {
   // Update heading as indicated by touch sensor
   motion_handler_.UpdateVelocity();
 
-  // Use velocity and position to update position
-  motion_behavior_.UpdatePose(dt, motion_handler_.get_velocity());
+  // Reset Sensor for next cycle. The pose is updated afterwards, by the
+  // caller.
+  sensor_touch_.Reset();
+  SyncStore();
+  return true;
+} /* UpdateControl() */
 
-  // Reset Sensor for next cycle
-  sensor_touch_->Reset();
-} /* TimestepUpdate() */
+void Light::SyncStore() {
+  EntityStore *store = get_store();
+  if (store) {
+    WheelVelocity vel = motion_handler_.get_velocity();
+    store->vel_left[get_slot()] = vel.left;
+    store->vel_right[get_slot()] = vel.right;
+  }
+} /* SyncStore() */
+
+void Light::SaveState(CheckpointEntity *record) const {
+  motion_handler_.SaveState(record);
+  record->touch_output = sensor_touch_.get_output();
+  record->avoiding = state_;
+  record->avoid_time = avoid_time_;
+} /* SaveState() */
+
+void Light::LoadState(const CheckpointEntity &record) {
+  motion_handler_.LoadState(record);
+  sensor_touch_.set_output(record.touch_output != 0);
+  state_ = record.avoiding != 0;
+  avoid_time_ = record.avoid_time;
+  SyncStore();
+} /* LoadState() */
 
 void Light::HandleCollision() {
   SetState(true);
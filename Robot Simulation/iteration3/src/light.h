@@ -13,6 +13,7 @@
 #include <string>
 
 #include "src/arena_mobile_entity.h"
+#include "src/checkpoint.h"
 #include "src/common.h"
 #include "src/motion_handler_light.h"
 #include "src/motion_behavior_differential.h"
@@ -41,7 +42,7 @@ class MotionbehaviorDifferential;
  * The touch sensor is activated when the light collides with an object.
  * Upon collision, the lights reverse in an arc before continuing forward.
  */
-class Light : public ArenaMobileEntity {
+class Light final : public ArenaMobileEntity {
  public:
   /**
    * @brief Constructor.
@@ -52,7 +53,7 @@ class Light : public ArenaMobileEntity {
    * @brief Reset the Light to a newly constructed state (needed for reset
    * button to work in GUI).
    */
-  void Reset() override;
+  void Reset(Rng *rng) override;
 
   /**
    * @brief Update the Light's position and velocity after the specified
@@ -62,6 +63,21 @@ class Light : public ArenaMobileEntity {
    */
   void TimestepUpdate(unsigned int dt) override;
 
+  /**
+   * @brief Everything TimestepUpdate() does except moving: updates the
+   * avoidance state and the wheel velocities, and publishes them to the
+   * EntityStore.
+   *
+   * @return Whether the Light should now move by its wheel velocities, which
+   * it always does.
+   */
+  bool UpdateControl();
+
+  /**
+   * @brief Publishes the wheel velocities to the EntityStore.
+   */
+  void SyncStore() override;
+
   /**
    * @brief Handles the collision by setting the sensor to activated.
    */
@@ -82,6 +98,18 @@ class Light : public ArenaMobileEntity {
   void SetState(bool state) { state_ = state; }
   bool GetState() { return state_; }
 
+  /**
+   * @brief Copy the Light's motion and avoidance state into a checkpoint
+   * record.
+   */
+  void SaveState(CheckpointEntity *record) const;
+
+  /**
+   * @brief Restore the state saved by SaveState(). The Light must already
+   * be bound to its slot, which is brought up to date.
+   */
+  void LoadState(const CheckpointEntity &record);
+
  private:
   // Manages pose and wheel velocities that change with time and collisions.
   MotionHandlerLight motion_handler_;
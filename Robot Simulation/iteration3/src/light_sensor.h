@@ -63,13 +63,8 @@ class LightSensor : public Sensor {
    * a reading relative to the distance.
   **/
   void CalculateReading(Pose location_) {
-    double deltaX = (pose_.x - location_.x);
-    double deltaY = (pose_.y - location_.y);
-    double distance = pow(deltaX*deltaX + deltaY*deltaY, 0.5) - LIGHT_RADIUS;
-    reading_ += light_sensitivity_/pow(1.015, distance);
-    if (reading_ > 1000) {
-     reading_ = 1000;
-    }
+    AddReading(Intensity(pose_.x, pose_.y, location_.x, location_.y,
+                         light_sensitivity_));
   }
 
   double GetLightSensitivity() { return light_sensitivity_/2000; }
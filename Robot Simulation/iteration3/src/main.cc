@@ -7,6 +7,7 @@
 /*******************************************************************************
  * Includes
  ******************************************************************************/
+#include <cstring>
 #include <iostream>
 
 #include "src/arena_params.h"
@@ -16,9 +17,18 @@
 /*******************************************************************************
  * Non-Member Functions
  ******************************************************************************/
-int main(__unused int argc, __unused char **argv) {
+int main(int argc, char **argv) {
+  // `--replay F` plays back trajectory file F instead of simulating.
+  const char *replay = nullptr;
+  if (argc == 3 && !strcmp(argv[1], "--replay")) {
+    replay = argv[2];
+  } else if (argc != 1) {
+    std::cerr << "usage: " << argv[0] << " [--replay F]" << std::endl;
+    return 1;
+  }
+
   // The controller creates both the arena and viewer
-  auto *controller = new csci3081::Controller;
+  auto *controller = new csci3081::Controller(replay);
 
   // The controller will call Run of the viewer
   controller->Run();
@@ -18,5 +18,22 @@ NAMESPACE_BEGIN(csci3081);
 /*******************************************************************************
  * Member Functions
  ******************************************************************************/
+void MotionHandler::SaveState(CheckpointEntity *record) const {
+  record->vel_left = velocity_.left;
+  record->vel_right = velocity_.right;
+  record->max_speed = max_speed_;
+  record->max_angle = max_angle_;
+  record->speed_delta = speed_delta_;
+  record->angle_delta = angle_delta_;
+} /* SaveState() */
+
+void MotionHandler::LoadState(const CheckpointEntity &record) {
+  velocity_.left = record.vel_left;
+  velocity_.right = record.vel_right;
+  max_speed_ = record.max_speed;
+  max_angle_ = record.max_angle;
+  speed_delta_ = record.speed_delta;
+  angle_delta_ = record.angle_delta;
+} /* LoadState() */
 
 NAMESPACE_END(csci3081);
@@ -15,6 +15,7 @@
 #include "src/wheel_velocity.h"
 #include "src/sensor_touch.h"
 #include "src/arena_mobile_entity.h"
+#include "src/checkpoint.h"
 
 /*******************************************************************************
  * Namespaces
@@ -119,6 +120,16 @@ class MotionHandler {
 
   ArenaMobileEntity * get_entity() { return entity_; }
 
+  /**
+   * @brief Copy the velocity and its limits into a checkpoint record.
+   */
+  void SaveState(CheckpointEntity *record) const;
+
+  /**
+   * @brief Restore the velocity and its limits from a checkpoint record.
+   */
+  void LoadState(const CheckpointEntity &record);
+
  private:
   double max_speed_{10};
   double min_speed_{0};
@@ -86,4 +86,16 @@ bool MotionHandlerRobot::UpdateState() {
   return false;
 } /* UpdateState() */
 
+void MotionHandlerRobot::SaveState(CheckpointEntity *record) const {
+  MotionHandler::SaveState(record);
+  record->avoiding = state_;
+  record->avoid_time = avoid_time_;
+} /* SaveState() */
+
+void MotionHandlerRobot::LoadState(const CheckpointEntity &record) {
+  MotionHandler::LoadState(record);
+  state_ = record.avoiding != 0;
+  avoid_time_ = record.avoid_time;
+} /* LoadState() */
+
 NAMESPACE_END(csci3081);
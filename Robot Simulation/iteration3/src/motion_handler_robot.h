@@ -88,6 +88,16 @@ class MotionHandlerRobot : public MotionHandler {
   bool GetState() { return state_; }
   void SetState(bool state) { state_ = state; }
 
+  /**
+   * @brief Copy the velocity and avoidance state into a checkpoint record.
+   */
+  void SaveState(CheckpointEntity *record) const;
+
+  /**
+   * @brief Restore the velocity and avoidance state from a checkpoint record.
+   */
+  void LoadState(const CheckpointEntity &record);
+
  private:
   // State is used to determine if a robot is an avoidance mode
   bool state_;
@@ -0,0 +1,89 @@
+/**
+ * @file object_pool.h
+ *
+ * @copyright 2018 Nate Samuelson, All rights reserved.
+ */
+
+#ifndef SRC_OBJECT_POOL_H_
+#define SRC_OBJECT_POOL_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "src/common.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief A typed, monotonic pool of objects.
+ *
+ * Objects are constructed back to back in slabs of kSlabSize objects, and
+ * are only ever released all together by Clear(). Clearing keeps the slabs
+ * and just rewinds the pool, so repeatedly filling and clearing a pool (e.g.
+ * New Game after New Game) reuses the same memory instead of growing it.
+ *
+ * Releasing is O(1): destructors are never run, so T must not own anything
+ * (memory, files, ...) that its destructor would have to give back.
+ *
+ * Pointers returned by Create() stay valid until Clear() (slabs never move).
+ */
+template <class T, size_t kSlabSize = 256>
+class ObjectPool {
+ public:
+  ObjectPool() : slabs_() {}
+
+  /**
+   * @brief Frees the slabs.
+   */
+  ~ObjectPool() = default;
+
+  ObjectPool(const ObjectPool &other) = delete;
+  ObjectPool &operator=(const ObjectPool &other) = delete;
+
+  /**
+   * @brief Construct a new object in the pool.
+   */
+  template <class... Args>
+  T *Create(Args &&... args) {
+    size_t slab = size_ / kSlabSize;
+    if (slab == slabs_.size()) {
+      slabs_.emplace_back(new Storage[kSlabSize]);
+    }
+    T *obj = new (&slabs_[slab][size_ % kSlabSize])
+      T(std::forward<Args>(args)...);
+    ++size_;
+    return obj;
+  }
+
+  /**
+   * @brief Release every object at once. The memory is kept for the next
+   * objects.
+   */
+  void Clear() { size_ = 0; }
+
+  size_t size() const { return size_; }
+  size_t capacity() const { return slabs_.size() * kSlabSize; }
+
+ private:
+  using Storage = typename std::aligned_storage<sizeof(T), alignof(T)>::type;
+
+  std::vector<std::unique_ptr<Storage[]>> slabs_;
+  // Number of live objects; they occupy the first size_ places.
+  size_t size_{0};
+};
+
+NAMESPACE_END(csci3081);
+
+#endif  // SRC_OBJECT_POOL_H_
@@ -32,6 +32,33 @@
 #define TOTAL_LIGHTS 8
 #define ARENA_X_DIM X_DIM
 #define ARENA_Y_DIM Y_DIM
+// Threads used to step the arena (1 steps it serially on the caller).
+#define N_THREADS 1
+// Seed of the Arena's random number generator (0: a different one each run).
+#define ARENA_SEED 0
+// Pixels between the nodes of the cached sensor intensity fields (0: none).
+#define FIELD_RESOLUTION 0
+
+// simulation timing
+// Wall clock seconds per arena timestep at normal speed.
+#define SIM_STEP_SIZE 0.05
+// Most timesteps taken per rendered frame; any backlog beyond is dropped.
+#define SIM_MAX_SUBSTEPS 100
+// Speed multiplier of the viewer's fast-forward mode.
+#define SIM_FAST_FORWARD 10
+
+// profiling (only used when built with -DARENA_PROFILE)
+// Timesteps kept per phase for the p50/p99/max statistics.
+#define PROFILE_WINDOW 256
+// File the statistics are written to at exit.
+#define PROFILE_CSV_FILE "arena_profile.csv"
+
+// trajectory recording (see TrajectoryWriter)
+// Positions and radii are stored in 1/TRAJECTORY_SCALE pixels, headings in
+// 1/TRAJECTORY_SCALE degrees.
+#define TRAJECTORY_SCALE 64
+// Most timesteps between keyframes, where replay can start.
+#define TRAJECTORY_KEYFRAME_INTERVAL 100
 
 // game status
 #define WON 1
@@ -58,7 +85,12 @@
 #define ROBOT_ANGLE_DELTA 1
 #define ROBOT_SPEED_DELTA 1
 #define ROBOT_COLLISION_DELTA 1
-#define ROBOT_RADIUS (random()%6)+8
+// Robot radii are drawn uniformly from [ROBOT_MIN_RADIUS, ROBOT_MAX_RADIUS]
+// with the Arena's Rng.
+#define ROBOT_MIN_RADIUS 8
+#define ROBOT_MAX_RADIUS 13
+#define ROBOT_RADIUS(rng) \
+  (ROBOT_MIN_RADIUS + (rng)->Below(ROBOT_MAX_RADIUS - ROBOT_MIN_RADIUS + 1))
 #define ROBOT_INIT_POS \
   { 500, 500 , 0}
 #define ROBOT_COLOR \
@@ -89,6 +121,6 @@
 #define LIGHT_MAX_RADIUS 50
 #define LIGHT_COLOR \
   { 255, 255, 255 }
-#define LIGHT_HEADING (random()%360)
+#define LIGHT_HEADING(rng) ((rng)->Below(360))
 
 #endif  // SRC_PARAMS_H_
@@ -0,0 +1,83 @@
+/**
+ * @file phase_profiler.cc
+ *
+ * @copyright 2018 Nate Samuelson, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <algorithm>
+#include <cmath>
+
+#include "src/phase_profiler.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Constructors/Destructor
+ ******************************************************************************/
+PhaseProfiler::PhaseProfiler(size_t window)
+    : window_(std::max(window, static_cast<size_t>(1))),
+      samples_(kPhaseCount, std::vector<double>(window_)),
+      count_(kPhaseCount, 0) {}
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+void PhaseProfiler::Record(ProfilePhase phase, double usec) {
+  samples_[phase][count_[phase] % window_] = usec;
+  ++count_[phase];
+} /* Record() */
+
+PhaseStats PhaseProfiler::Stats(ProfilePhase phase) const {
+  PhaseStats stats;
+  stats.samples = std::min(count_[phase], window_);
+  if (stats.samples == 0) {
+    return stats;
+  }
+  scratch_.assign(samples_[phase].begin(),
+                  samples_[phase].begin() + stats.samples);
+  // Nearest rank: the smallest sample with at least p of them at or below.
+  auto percentile = [this](double p) {
+    size_t rank = static_cast<size_t>(std::ceil(p * scratch_.size()));
+    auto nth = scratch_.begin() + (rank > 0 ? rank - 1 : 0);
+    std::nth_element(scratch_.begin(), nth, scratch_.end());
+    return *nth;
+  };
+  stats.p50 = percentile(0.50);
+  stats.p99 = percentile(0.99);
+  stats.max = *std::max_element(scratch_.begin(), scratch_.end());
+  return stats;
+} /* Stats() */
+
+void PhaseProfiler::Clear() {
+  std::fill(count_.begin(), count_.end(), 0);
+} /* Clear() */
+
+void PhaseProfiler::WriteCsv(std::ostream &out) const {
+  out << "phase,samples,p50_us,p99_us,max_us\n";
+  for (int p = 0; p < kPhaseCount; ++p) {
+    ProfilePhase phase = static_cast<ProfilePhase>(p);
+    PhaseStats stats = Stats(phase);
+    out << PhaseName(phase) << "," << stats.samples << "," << stats.p50 << ","
+        << stats.p99 << "," << stats.max << "\n";
+  }
+} /* WriteCsv() */
+
+const char *PhaseProfiler::PhaseName(ProfilePhase phase) {
+  switch (phase) {
+    case kPhaseStep: return "step";
+    case kPhaseTimestep: return "timestep";
+    case kPhaseHunger: return "hunger";
+    case kPhaseSensors: return "sensors";
+    case kPhaseCollisions: return "collisions";
+    case kPhaseCount:
+    default: return "unknown";
+  }
+} /* PhaseName() */
+
+NAMESPACE_END(csci3081);
@@ -0,0 +1,142 @@
+/**
+ * @file phase_profiler.h
+ *
+ * @copyright 2018 Nate Samuelson, All rights reserved.
+ */
+
+#ifndef SRC_PHASE_PROFILER_H_
+#define SRC_PHASE_PROFILER_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <chrono>
+#include <ostream>
+#include <vector>
+
+#include "src/common.h"
+#include "src/params.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/*
+ * Profiling is compiled in with -DARENA_PROFILE (`make PROFILE=1`). Without
+ * it, PROFILE_PHASE expands to nothing and no clock is ever read, and the
+ * Arena keeps no PhaseProfiler at all.
+ */
+#ifdef ARENA_PROFILE
+#define PROFILE_PHASE(profiler, phase) \
+  csci3081::ScopedPhaseTimer profile_timer_##phase((profiler), (phase))
+#else
+#define PROFILE_PHASE(profiler, phase)
+#endif
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+/**
+ * @brief The phases of Arena::UpdateEntitiesTimestep(). kPhaseStep is the
+ * whole timestep.
+ */
+enum ProfilePhase {
+  kPhaseStep, kPhaseTimestep, kPhaseHunger, kPhaseSensors, kPhaseCollisions,
+  kPhaseCount
+};
+
+/**
+ * @brief Summary of the most recent samples of a phase, in microseconds.
+ */
+struct PhaseStats {
+  size_t samples{0};
+  double p50{0};
+  double p99{0};
+  double max{0};
+};
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief Keeps the durations of the last `window` timesteps of each phase and
+ * reports their percentiles.
+ *
+ * Recording is a single store into a ring buffer; the percentiles are only
+ * computed when asked for (e.g. once per frame by the viewer).
+ */
+class PhaseProfiler {
+ public:
+#ifdef ARENA_PROFILE
+  static constexpr bool kEnabled = true;
+#else
+  static constexpr bool kEnabled = false;
+#endif
+
+  explicit PhaseProfiler(size_t window = PROFILE_WINDOW);
+
+  /**
+   * @brief Record one duration of a phase, dropping the oldest one once the
+   * window is full.
+   */
+  void Record(ProfilePhase phase, double usec);
+
+  /**
+   * @brief The p50/p99/max of the samples currently in the window.
+   */
+  PhaseStats Stats(ProfilePhase phase) const;
+
+  /**
+   * @brief Forget all samples.
+   */
+  void Clear();
+
+  /**
+   * @brief Write the stats of every phase as CSV, with a header row.
+   */
+  void WriteCsv(std::ostream &out) const;
+
+  static const char *PhaseName(ProfilePhase phase);
+
+ private:
+  size_t window_;
+  // One ring buffer of durations per phase.
+  std::vector<std::vector<double>> samples_;
+  // Samples ever recorded per phase; the next one goes at count % window.
+  std::vector<size_t> count_;
+  // Sort space for Stats()
+  mutable std::vector<double> scratch_{};
+};
+
+/**
+ * @brief Records the time from its construction to its destruction as one
+ * sample of a phase. Use through PROFILE_PHASE().
+ */
+class ScopedPhaseTimer {
+ public:
+  ScopedPhaseTimer(PhaseProfiler *profiler, ProfilePhase phase)
+      : profiler_(profiler), phase_(phase),
+        start_(std::chrono::steady_clock::now()) {}
+
+  ~ScopedPhaseTimer() {
+    std::chrono::duration<double, std::micro> elapsed =
+      std::chrono::steady_clock::now() - start_;
+    profiler_->Record(phase_, elapsed.count());
+  }
+
+  ScopedPhaseTimer(const ScopedPhaseTimer &other) = delete;
+  ScopedPhaseTimer &operator=(const ScopedPhaseTimer &other) = delete;
+
+ private:
+  PhaseProfiler *profiler_;
+  ProfilePhase phase_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+NAMESPACE_END(csci3081);
+
+#endif  // SRC_PHASE_PROFILER_H_
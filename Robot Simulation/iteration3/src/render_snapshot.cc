@@ -0,0 +1,42 @@
+/**
+ * @file render_snapshot.cc
+ *
+ * @copyright 2018 Nate Samuelson, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "src/render_snapshot.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+std::string RenderEntity::get_name() const {
+  switch (type) {
+    case kRobot: return "Robot";
+    case kLight: return "Light" + std::to_string(id);
+    case kFood: return "Food";
+    default: return "";
+  }
+} /* get_name() */
+
+void RenderSnapshotBuffer::Publish() {
+  // Release makes the snapshot visible to the reader that picks it up.
+  back_ = middle_.exchange(back_ | kFresh, std::memory_order_acq_rel) &
+          ~kFresh;
+} /* Publish() */
+
+const RenderSnapshot &RenderSnapshotBuffer::Latest() {
+  if (middle_.load(std::memory_order_relaxed) & kFresh) {
+    front_ = middle_.exchange(front_, std::memory_order_acq_rel) & ~kFresh;
+  }
+  return buffers_[front_];
+} /* Latest() */
+
+NAMESPACE_END(csci3081);
@@ -0,0 +1,123 @@
+/**
+ * @file render_snapshot.h
+ *
+ * @copyright 2018 Nate Samuelson, All rights reserved.
+ */
+
+#ifndef SRC_RENDER_SNAPSHOT_H_
+#define SRC_RENDER_SNAPSHOT_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "src/common.h"
+#include "src/entity_type.h"
+#include "src/params.h"
+#include "src/phase_profiler.h"
+#include "src/rgb_color.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Struct Definitions
+ ******************************************************************************/
+/**
+ * @brief What the viewer needs to draw one entity.
+ */
+struct RenderEntity {
+  EntityType type{kUndefined};
+  int id{0};
+  double x{0};
+  double y{0};
+  double radius{0};
+  RgbColor color{};
+  // Positions of the left and right sensors (Robots only).
+  double left_sensor_x{0};
+  double left_sensor_y{0};
+  double right_sensor_x{0};
+  double right_sensor_y{0};
+
+  /**
+   * @brief The label of the entity, as ArenaEntity::get_name() gives it.
+   */
+  std::string get_name() const;
+};
+
+/**
+ * @brief A copy of the state of an Arena, taken between timesteps by
+ * Arena::FillSnapshot(), that can be drawn while the Arena keeps stepping.
+ */
+struct RenderSnapshot {
+  // Every entity, in store order.
+  std::vector<RenderEntity> entities{};
+  double x_dim{0};
+  double y_dim{0};
+  int game_status{PAUSED};
+#ifdef ARENA_PROFILE
+  // Arena::get_phase_stats() of each phase
+  PhaseStats phase_stats[kPhaseCount]{};
+#endif
+};
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief Triple buffer handing RenderSnapshots from the simulation thread to
+ * the viewer without locks.
+ *
+ * The writer fills back() and calls Publish(), which swaps it with the
+ * middle buffer. The reader's Latest() swaps the middle buffer with its own
+ * if it holds a newer snapshot. Neither side ever waits for the other, and
+ * each works on a buffer the other cannot touch; a snapshot the reader has
+ * not picked up yet is simply replaced by the next one.
+ *
+ * There must be exactly one writer thread and one reader thread.
+ */
+class RenderSnapshotBuffer {
+ public:
+  RenderSnapshotBuffer() : buffers_() {}
+
+  RenderSnapshotBuffer(const RenderSnapshotBuffer &other) = delete;
+  RenderSnapshotBuffer &operator=(const RenderSnapshotBuffer &other) = delete;
+
+  /**
+   * @brief Writer: the buffer to fill next. Holds an old snapshot, which the
+   * writer must overwrite completely.
+   */
+  RenderSnapshot *back() { return &buffers_[back_]; }
+
+  /**
+   * @brief Writer: make back() the latest snapshot.
+   */
+  void Publish();
+
+  /**
+   * @brief Reader: the latest published snapshot. It stays valid and
+   * unchanged until the next call.
+   */
+  const RenderSnapshot &Latest();
+
+ private:
+  // Set in middle_ when it holds a snapshot the reader has not seen.
+  static const int kFresh = 4;
+
+  RenderSnapshot buffers_[3];
+  // Index of the writer's buffer.
+  int back_{0};
+  // Index of the reader's buffer.
+  int front_{1};
+  // Index of the buffer in between, plus kFresh.
+  std::atomic<int> middle_{2};
+};
+
+NAMESPACE_END(csci3081);
+
+#endif  // SRC_RENDER_SNAPSHOT_H_
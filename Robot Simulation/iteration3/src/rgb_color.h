@@ -61,6 +61,11 @@ struct RgbColor {
   RgbColor(int r_in, int g_in, int b_in) : r(r_in), g(g_in), b(b_in) {}
 
   void Set(RgbColorEnum value);
+
+  bool operator==(const RgbColor &other) const {
+    return r == other.r && g == other.g && b == other.b;
+  }
+  bool operator!=(const RgbColor &other) const { return !(*this == other); }
 };
 
 NAMESPACE_END(csci3081);
@@ -0,0 +1,94 @@
+/**
+ * @file rng.h
+ *
+ * @copyright 2018 Nate Samuelson, All rights reserved.
+ */
+
+#ifndef SRC_RNG_H_
+#define SRC_RNG_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <cstdint>
+
+#include "src/common.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief A small, fast pseudo-random number generator (xoshiro256**).
+ *
+ * Each Arena owns one, seeded from arena_params::seed, and every random
+ * choice made while building the Arena (positions, radii, headings) is drawn
+ * from it. The same seed therefore always gives the same Arena, no matter
+ * what else the process is doing, and arenas never share any state.
+ */
+class Rng {
+ public:
+  /**
+   * @brief Constructor. See Seed().
+   */
+  explicit Rng(uint64_t seed) { Seed(seed); }
+
+  /**
+   * @brief Restart the sequence. The 256 bits of state are expanded from the
+   * 64 bit seed with splitmix64, so any seed (including 0) is fine.
+   */
+  void Seed(uint64_t seed);
+
+  /**
+   * @brief The next 64 random bits.
+   */
+  uint64_t Next() {
+    uint64_t result = Rotl(s_[1] * 5, 7) * 9;
+    uint64_t t = s_[1] << 17;
+    s_[2] ^= s_[0];
+    s_[3] ^= s_[1];
+    s_[1] ^= s_[2];
+    s_[0] ^= s_[3];
+    s_[2] ^= t;
+    s_[3] = Rotl(s_[3], 45);
+    return result;
+  }
+
+  /**
+   * @brief A uniformly distributed integer in [0, n), for n > 0.
+   */
+  int Below(int n) {
+    // Scales the top 32 bits instead of taking a modulus. The bias is at
+    // most n / 2^32, far too small to matter here.
+    return static_cast<int>(((Next() >> 32) * static_cast<uint64_t>(n)) >> 32);
+  }
+
+  uint64_t get_seed() const { return seed_; }
+
+  /**
+   * @brief Copy out, or restore, the position in the sequence (e.g. for a
+   * checkpoint). A restored generator continues exactly where the saved one
+   * would have.
+   */
+  void get_state(uint64_t state[4]) const {
+    for (int i = 0; i < 4; ++i) { state[i] = s_[i]; }
+  }
+  void set_state(uint64_t seed, const uint64_t state[4]) {
+    seed_ = seed;
+    for (int i = 0; i < 4; ++i) { s_[i] = state[i]; }
+  }
+
+ private:
+  static uint64_t Rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+  uint64_t seed_{0};
+  uint64_t s_[4]{};
+};
+
+NAMESPACE_END(csci3081);
+
+#endif  // SRC_RNG_H_
@@ -38,7 +38,7 @@ Robot::Robot() :
   set_type(kRobot);
   set_color(ROBOT_COLOR);
   set_pose(ROBOT_INIT_POS);
-  set_radius(ROBOT_RADIUS);
+  set_radius(ROBOT_MIN_RADIUS);
   left_light_sensor_.set_pose(SensorLocation(-40*M_PI/180));
   right_light_sensor_.set_pose(SensorLocation(40*M_PI/180));
   left_food_sensor_.set_pose(SensorLocation(-40*M_PI/180));
@@ -48,6 +48,13 @@ Robot::Robot() :
  * Member Functions
  ******************************************************************************/
 void Robot::TimestepUpdate(unsigned int dt) {
+  if (UpdateControl()) {
+    // Use velocity and position to update position
+    motion_behavior_.UpdatePose(dt, motion_handler_.get_velocity());
+  }
+} /* TimestepUpdate() */
+
+bool Robot::UpdateControl() {
   // Checks whether hunger is activated
   if (hunger_) {
     // Increments hunger of the robot after initial timer expires
@@ -71,7 +78,8 @@ void Robot::TimestepUpdate(unsigned int dt) {
   right_food_sensor_.set_pose(SensorLocation(40*M_PI/180));
 
   // If statement allows robot to ignore sensor data while in avoidance mode
-  if (motion_handler_.UpdateState()) {
+  bool moves = !motion_handler_.UpdateState();
+  if (!moves) {
     // Updates active/avoidance mode and adjusts heading accordingly
     set_heading(get_heading()-10);
   } else {
@@ -81,16 +89,17 @@ void Robot::TimestepUpdate(unsigned int dt) {
     hunger_, hunger_level_,
     left_food_sensor_.GetReading(), right_food_sensor_.GetReading());
 
-    // Use velocity and position to update position
-    motion_behavior_.UpdatePose(dt, motion_handler_.get_velocity());
+    // The pose is updated last, by the caller. Nothing below depends on it.
 
     // Reset Sensor for next cycle
-    sensor_touch_->Reset();
+    sensor_touch_.Reset();
 
     // Zero Sensors after utilizing data
     ZeroSensors();
   }
-} /* TimestepUpdate() */
+  SyncStore();
+  return moves;
+} /* UpdateControl() */
 
 Pose Robot::SensorLocation(double angle_) {
   double theta = (M_PI*get_pose().theta/180) + angle_;
@@ -121,16 +130,74 @@ bool Robot::CheckStarvation() {
   return (starvation_time_ < 0.01);
 } /* CheckStarvation() */
 
-void Robot::Reset() {
-  set_pose(set_pose_randomly());
+void Robot::Reset(Rng *rng) {
+  set_pose(set_pose_randomly(rng));
   set_color(ROBOT_COLOR);
   hunger_level_ = 0;
   starvation_time_ = 100;
   motion_handler_.set_velocity(0.0, 0.0);
   motion_handler_.set_max_angle(ROBOT_MAX_ANGLE);
-  sensor_touch_->Reset();
+  sensor_touch_.Reset();
+  SyncStore();
 } /* Reset() */
 
+void Robot::SyncStore() {
+  EntityStore *store = get_store();
+  if (!store) {
+    return;
+  }
+  int slot = get_slot();
+  WheelVelocity vel = motion_handler_.get_velocity();
+  store->vel_left[slot] = vel.left;
+  store->vel_right[slot] = vel.right;
+  store->hunger[slot] = hunger_;
+  store->starved[slot] = CheckStarvation();
+  store->hunger_level[slot] = hunger_level_;
+  Pose left = left_light_sensor_.get_pose();
+  Pose right = right_light_sensor_.get_pose();
+  store->left_sensor_x[slot] = left.x;
+  store->left_sensor_y[slot] = left.y;
+  store->right_sensor_x[slot] = right.x;
+  store->right_sensor_y[slot] = right.y;
+} /* SyncStore() */
+
+void Robot::SaveState(CheckpointEntity *record) const {
+  motion_handler_.SaveState(record);
+  record->touch_output = sensor_touch_.get_output();
+  record->robot_type = type_;
+  record->hunger = hunger_;
+  record->light_sensitivity = light_sensitivity_;
+  record->hunger_time = hunger_time_;
+  record->hunger_level = hunger_level_;
+  record->starvation_time = starvation_time_;
+  const Sensor *sensors[4] = {&left_light_sensor_, &right_light_sensor_,
+                              &left_food_sensor_, &right_food_sensor_};
+  for (int i = 0; i < 4; ++i) {
+    Pose pose = sensors[i]->get_pose();
+    record->sensor_x[i] = pose.x;
+    record->sensor_y[i] = pose.y;
+    record->sensor_reading[i] = sensors[i]->GetReading();
+  }
+} /* SaveState() */
+
+void Robot::LoadState(const CheckpointEntity &record) {
+  motion_handler_.LoadState(record);
+  sensor_touch_.set_output(record.touch_output != 0);
+  type_ = static_cast<RobotType>(record.robot_type);
+  hunger_ = record.hunger != 0;
+  set_light_sensitivity(record.light_sensitivity);
+  hunger_time_ = record.hunger_time;
+  hunger_level_ = record.hunger_level;
+  starvation_time_ = record.starvation_time;
+  Sensor *sensors[4] = {&left_light_sensor_, &right_light_sensor_,
+                        &left_food_sensor_, &right_food_sensor_};
+  for (int i = 0; i < 4; ++i) {
+    sensors[i]->set_pose(record.sensor_x[i], record.sensor_y[i]);
+    sensors[i]->set_reading(record.sensor_reading[i]);
+  }
+  SyncStore();
+} /* LoadState() */
+
 void Robot::HandleCollision() {
   motion_handler_.SetState(true);
 } /* HandleCollision() */
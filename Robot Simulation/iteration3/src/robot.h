@@ -15,6 +15,7 @@
 #include "src/light_sensor.h"
 #include "src/food_sensor.h"
 #include "src/arena_mobile_entity.h"
+#include "src/checkpoint.h"
 #include "src/common.h"
 #include "src/motion_handler_robot.h"
 #include "src/motion_behavior_differential.h"
@@ -46,7 +47,7 @@ class MotionBehaviorDifferential;
  * The heading is modified after a collision to move the robot away from the
  * other object.
  */
-class Robot : public ArenaMobileEntity {
+class Robot final : public ArenaMobileEntity {
  public:
   /**
    * @brief Constructor using initialization values from params.h.
@@ -62,7 +63,7 @@ class Robot : public ArenaMobileEntity {
    * @brief Reset the Robot to a newly constructed state (needed for reset
    * button to work in GUI).
    */
-  void Reset() override;
+  void Reset(Rng *rng) override;
 
   /**
    * @brief Update the Robot's position and velocity after the specified
@@ -72,6 +73,16 @@ class Robot : public ArenaMobileEntity {
    */
   void TimestepUpdate(unsigned int dt) override;
 
+  /**
+   * @brief Everything TimestepUpdate() does except moving: updates hunger,
+   * the sensors and the wheel velocities, and publishes them to the
+   * EntityStore.
+   *
+   * @return Whether the Robot should now move by its wheel velocities (false
+   * while it turns in place to avoid an obstacle).
+   */
+  bool UpdateControl();
+
   /**
    * @brief Calculates the proper position of a sensor relative to a robot.
    *
@@ -110,12 +121,33 @@ class Robot : public ArenaMobileEntity {
    * @brief Returns status of hunger in robots.
    */
   bool GetHunger() { return hunger_; }
-  void SetHunger(bool hunger) { hunger_ = hunger; }
+  void SetHunger(bool hunger) { hunger_ = hunger; SyncStore(); }
 
   /**
    * @brief Resets the hunger level and hunger timer for the robot.
    */
-  void ResetHunger() { hunger_level_ = 0; hunger_time_ = 100; }
+  void ResetHunger() { hunger_level_ = 0; hunger_time_ = 100; SyncStore(); }
+
+  /**
+   * @brief Publishes wheel velocities, hunger state and sensor positions to
+   * the EntityStore.
+   */
+  void SyncStore() override;
+
+  double get_hunger_level() const { return hunger_level_; }
+
+  /**
+   * @brief Copy the Robot's own state (everything but the pose, radius,
+   * color and id, which the Arena saves for every entity) into a
+   * checkpoint record.
+   */
+  void SaveState(CheckpointEntity *record) const;
+
+  /**
+   * @brief Restore the state saved by SaveState(). The Robot must already
+   * be bound to its slot, which is brought up to date.
+   */
+  void LoadState(const CheckpointEntity &record);
 
   /**
    * @brief Get the name of the Robot for visualization and for debugging.
@@ -139,6 +171,15 @@ class Robot : public ArenaMobileEntity {
   Pose get_left_sensor_pose() const { return left_light_sensor_.get_pose(); }
   Pose get_right_sensor_pose() const { return right_light_sensor_.get_pose(); }
 
+  /**
+   * @brief Get pointers to the Robot's light and food sensors, e.g. to
+   * update their readings in a batch (see AccumulateSensorReadings()).
+   */
+  LightSensor * get_left_light_sensor() { return &left_light_sensor_; }
+  LightSensor * get_right_light_sensor() { return &right_light_sensor_; }
+  FoodSensor * get_left_food_sensor() { return &left_food_sensor_; }
+  FoodSensor * get_right_food_sensor() { return &right_food_sensor_; }
+
  private:
   // Determines the type of robot
   RobotType type_;
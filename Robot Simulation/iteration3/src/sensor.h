@@ -72,9 +72,10 @@ class Sensor {
   */
   void ZeroReading() { reading_ = 0; }
 
-  double GetReading() {
+  double GetReading() const {
     return reading_;
   }
+  void set_reading(double reading) { reading_ = reading; }
 
   /**
    * @brief Checks for the presence of a light.
@@ -85,15 +86,35 @@ class Sensor {
    * a reading relative to the distance.
   **/
   void CalculateReading(Pose location_) {
-    double deltaX = (pose_.x - location_.x);
-    double deltaY = (pose_.y - location_.y);
-    double distance = pow(deltaX*deltaX + deltaY*deltaY, 0.5) - LIGHT_RADIUS;
-    reading_ += 2000/pow(1.015, distance);
+    AddReading(Intensity(pose_.x, pose_.y, location_.x, location_.y, 2000));
+  }
+
+  /**
+   * @brief Adds to the reading, clamping it at 1000.
+   */
+  void AddReading(double intensity) {
+    reading_ += intensity;
     if (reading_ > 1000) {
      reading_ = 1000;
     }
   }
 
+  /**
+   * @brief The reading a sensor at (sx, sy) gets from a source at (lx, ly).
+   *
+   * Shared with the Arena, which computes readings straight from the
+   * EntityStore arrays.
+   *
+   * @param[in] gain The reading at zero distance (2000 * sensitivity).
+   */
+  static double Intensity(double sx, double sy, double lx, double ly,
+                          double gain) {
+    double deltaX = (sx - lx);
+    double deltaY = (sy - ly);
+    double distance = pow(deltaX*deltaX + deltaY*deltaY, 0.5) - LIGHT_RADIUS;
+    return gain/pow(1.015, distance);
+  }
+
  protected:
   // The sensors position and heading
   Pose pose_;
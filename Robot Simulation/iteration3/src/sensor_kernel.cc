@@ -0,0 +1,214 @@
+/**
+ * @file sensor_kernel.cc
+ *
+ * @copyright 2018 Nate Samuelson, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) && defined(__GNUC__)
+#include <immintrin.h>
+#define SENSOR_KERNEL_X86 1
+#endif
+
+#include "src/params.h"
+#include "src/sensor_kernel.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Constants
+ ******************************************************************************/
+// exp(x) is evaluated as 2^n * p(r) with n = round(x / ln 2) and
+// r = x - n * ln 2 (in two parts, so that n * kLn2Hi is exact).
+static const double kExpMin = -700;
+static const double kExpMax = 700;
+static const double kLog2e = 1.4426950408889634;
+static const double kLn2Hi = 6.93147180369123816490e-01;
+static const double kLn2Lo = 1.90821492927058770002e-10;
+// Adding 1.5 * 2^52 rounds to an integer and leaves it in the low mantissa
+// bits, from where it can be shifted into the exponent field.
+static const double kRoundShift = 6755399441055744.0;
+// Taylor coefficients 1/k!, k = 13..0. |r| <= ln(2) / 2, so the truncation
+// error is below one ulp.
+static const double kExpPoly[] = {
+  1.6059043836821613e-10, 2.08767569878681e-09, 2.505210838544172e-08,
+  2.755731922398589e-07, 2.7557319223985893e-06, 2.48015873015873e-05,
+  0.0001984126984126984, 0.001388888888888889, 0.008333333333333333,
+  0.041666666666666664, 0.16666666666666666, 0.5, 1.0, 1.0};
+static const int kExpPolySize = sizeof(kExpPoly) / sizeof(kExpPoly[0]);
+// ln(1.015): 1.015^-d == exp(-d * ln(1.015)).
+static const double kLn1015 = 0.014888612493750559;
+static const double kMaxReading = 1000;
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+double SensorKernelExp(double x) {
+  x = std::min(std::max(x, kExpMin), kExpMax);
+  double t = x * kLog2e + kRoundShift;
+  double n = t - kRoundShift;
+  double r = x - n * kLn2Hi;
+  r = r - n * kLn2Lo;
+  double p = kExpPoly[0];
+  for (int k = 1; k < kExpPolySize; ++k) {
+    p = p * r + kExpPoly[k];
+  }
+  uint64_t bits;
+  memcpy(&bits, &t, sizeof(bits));
+  bits = (bits + 1023) << 52;
+  double scale;
+  memcpy(&scale, &bits, sizeof(scale));
+  return p * scale;
+} /* SensorKernelExp() */
+
+static void AccumulateScalar(const double *sensor_x, const double *sensor_y,
+                             const double *gain, size_t begin, size_t end,
+                             const double *source_x, const double *source_y,
+                             size_t n_sources, double *reading) {
+  for (size_t i = begin; i < end; ++i) {
+    double acc = reading[i];
+    for (size_t j = 0; j < n_sources; ++j) {
+      double dx = sensor_x[i] - source_x[j];
+      double dy = sensor_y[i] - source_y[j];
+      double distance = std::sqrt(dx*dx + dy*dy);
+      acc = acc + gain[i] * SensorKernelExp((LIGHT_RADIUS - distance) *
+                                            kLn1015);
+    }
+    reading[i] = acc > kMaxReading ? kMaxReading : acc;
+  }
+} /* AccumulateScalar() */
+
+#ifdef SENSOR_KERNEL_X86
+/*
+ * The vector versions repeat SensorKernelExp() and AccumulateScalar() lane
+ * for lane, with the same operations in the same order (and no fused
+ * multiply-add), so every path rounds identically.
+ */
+static __m128d Exp2(__m128d x) {
+  x = _mm_min_pd(_mm_max_pd(x, _mm_set1_pd(kExpMin)), _mm_set1_pd(kExpMax));
+  __m128d shift = _mm_set1_pd(kRoundShift);
+  __m128d t = _mm_add_pd(_mm_mul_pd(x, _mm_set1_pd(kLog2e)), shift);
+  __m128d n = _mm_sub_pd(t, shift);
+  __m128d r = _mm_sub_pd(x, _mm_mul_pd(n, _mm_set1_pd(kLn2Hi)));
+  r = _mm_sub_pd(r, _mm_mul_pd(n, _mm_set1_pd(kLn2Lo)));
+  __m128d p = _mm_set1_pd(kExpPoly[0]);
+  for (int k = 1; k < kExpPolySize; ++k) {
+    p = _mm_add_pd(_mm_mul_pd(p, r), _mm_set1_pd(kExpPoly[k]));
+  }
+  __m128i bits = _mm_add_epi64(_mm_castpd_si128(t), _mm_set1_epi64x(1023));
+  return _mm_mul_pd(p, _mm_castsi128_pd(_mm_slli_epi64(bits, 52)));
+} /* Exp2() */
+
+static size_t AccumulateSse2(const double *sensor_x, const double *sensor_y,
+                             const double *gain, size_t n_sensors,
+                             const double *source_x, const double *source_y,
+                             size_t n_sources, double *reading) {
+  size_t i = 0;
+  for (; i + 2 <= n_sensors; i += 2) {
+    __m128d sx = _mm_loadu_pd(sensor_x + i);
+    __m128d sy = _mm_loadu_pd(sensor_y + i);
+    __m128d g = _mm_loadu_pd(gain + i);
+    __m128d acc = _mm_loadu_pd(reading + i);
+    for (size_t j = 0; j < n_sources; ++j) {
+      __m128d dx = _mm_sub_pd(sx, _mm_set1_pd(source_x[j]));
+      __m128d dy = _mm_sub_pd(sy, _mm_set1_pd(source_y[j]));
+      __m128d distance = _mm_sqrt_pd(
+        _mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy)));
+      __m128d x = _mm_mul_pd(
+        _mm_sub_pd(_mm_set1_pd(LIGHT_RADIUS), distance),
+        _mm_set1_pd(kLn1015));
+      acc = _mm_add_pd(acc, _mm_mul_pd(g, Exp2(x)));
+    }
+    _mm_storeu_pd(reading + i, _mm_min_pd(acc, _mm_set1_pd(kMaxReading)));
+  }
+  return i;
+} /* AccumulateSse2() */
+
+__attribute__((target("avx2")))
+static __m256d Exp4(__m256d x) {
+  x = _mm256_min_pd(_mm256_max_pd(x, _mm256_set1_pd(kExpMin)),
+                    _mm256_set1_pd(kExpMax));
+  __m256d shift = _mm256_set1_pd(kRoundShift);
+  __m256d t = _mm256_add_pd(_mm256_mul_pd(x, _mm256_set1_pd(kLog2e)), shift);
+  __m256d n = _mm256_sub_pd(t, shift);
+  __m256d r = _mm256_sub_pd(x, _mm256_mul_pd(n, _mm256_set1_pd(kLn2Hi)));
+  r = _mm256_sub_pd(r, _mm256_mul_pd(n, _mm256_set1_pd(kLn2Lo)));
+  __m256d p = _mm256_set1_pd(kExpPoly[0]);
+  for (int k = 1; k < kExpPolySize; ++k) {
+    p = _mm256_add_pd(_mm256_mul_pd(p, r), _mm256_set1_pd(kExpPoly[k]));
+  }
+  __m256i bits = _mm256_add_epi64(_mm256_castpd_si256(t),
+                                  _mm256_set1_epi64x(1023));
+  return _mm256_mul_pd(p, _mm256_castsi256_pd(_mm256_slli_epi64(bits, 52)));
+} /* Exp4() */
+
+__attribute__((target("avx2")))
+static size_t AccumulateAvx2(const double *sensor_x, const double *sensor_y,
+                             const double *gain, size_t n_sensors,
+                             const double *source_x, const double *source_y,
+                             size_t n_sources, double *reading) {
+  size_t i = 0;
+  for (; i + 4 <= n_sensors; i += 4) {
+    __m256d sx = _mm256_loadu_pd(sensor_x + i);
+    __m256d sy = _mm256_loadu_pd(sensor_y + i);
+    __m256d g = _mm256_loadu_pd(gain + i);
+    __m256d acc = _mm256_loadu_pd(reading + i);
+    for (size_t j = 0; j < n_sources; ++j) {
+      __m256d dx = _mm256_sub_pd(sx, _mm256_set1_pd(source_x[j]));
+      __m256d dy = _mm256_sub_pd(sy, _mm256_set1_pd(source_y[j]));
+      __m256d distance = _mm256_sqrt_pd(
+        _mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy)));
+      __m256d x = _mm256_mul_pd(
+        _mm256_sub_pd(_mm256_set1_pd(LIGHT_RADIUS), distance),
+        _mm256_set1_pd(kLn1015));
+      acc = _mm256_add_pd(acc, _mm256_mul_pd(g, Exp4(x)));
+    }
+    _mm256_storeu_pd(reading + i,
+                     _mm256_min_pd(acc, _mm256_set1_pd(kMaxReading)));
+  }
+  return i;
+} /* AccumulateAvx2() */
+
+static bool HasAvx2() {
+  static const bool has_avx2 = __builtin_cpu_supports("avx2");
+  return has_avx2;
+} /* HasAvx2() */
+#endif  // SENSOR_KERNEL_X86
+
+void AccumulateSensorReadings(const double *sensor_x, const double *sensor_y,
+                              const double *gain, size_t n_sensors,
+                              const double *source_x, const double *source_y,
+                              size_t n_sources, double *reading) {
+  size_t done = 0;
+#ifdef SENSOR_KERNEL_X86
+  if (HasAvx2()) {
+    done = AccumulateAvx2(sensor_x, sensor_y, gain, n_sensors, source_x,
+                          source_y, n_sources, reading);
+  } else {
+    done = AccumulateSse2(sensor_x, sensor_y, gain, n_sensors, source_x,
+                          source_y, n_sources, reading);
+  }
+#endif
+  AccumulateScalar(sensor_x, sensor_y, gain, done, n_sensors, source_x,
+                   source_y, n_sources, reading);
+} /* AccumulateSensorReadings() */
+
+const char *SensorKernelIsa() {
+#ifdef SENSOR_KERNEL_X86
+  return HasAvx2() ? "avx2" : "sse2";
+#else
+  return "scalar";
+#endif
+} /* SensorKernelIsa() */
+
+NAMESPACE_END(csci3081);
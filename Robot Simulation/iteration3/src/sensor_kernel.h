@@ -0,0 +1,66 @@
+/**
+ * @file sensor_kernel.h
+ *
+ * @copyright 2018 Nate Samuelson, All rights reserved.
+ */
+
+#ifndef SRC_SENSOR_KERNEL_H_
+#define SRC_SENSOR_KERNEL_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <cstddef>
+
+#include "src/common.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+/**
+ * @brief Batched version of Sensor::CalculateReading().
+ *
+ * For every sensor i, adds the reading caused by every source j,
+ *
+ *     gain[i] * exp(-(|sensor_i - source_j| - LIGHT_RADIUS) * ln(1.015))
+ *
+ * to reading[i], then clamps reading[i] at 1000. Since every term is
+ * positive, clamping once at the end gives the same result as clamping after
+ * each term like CalculateReading() does. Sources are summed in order, so a
+ * sensor's reading does not depend on which other sensors are in the batch.
+ *
+ * Sensors are processed four (AVX2) or two (SSE2) at a time depending on what
+ * the CPU supports, with a scalar loop for the remainder. All paths use the
+ * same exp() approximation, so they give identical results.
+ *
+ * @param[in] sensor_x, sensor_y Sensor positions, n_sensors each.
+ * @param[in] gain Reading of each sensor at zero distance (2000 *
+ * sensitivity), n_sensors.
+ * @param[in] source_x, source_y Light or food positions, n_sources each.
+ * @param[in,out] reading The reading of each sensor, n_sensors.
+ */
+void AccumulateSensorReadings(const double *sensor_x, const double *sensor_y,
+                              const double *gain, size_t n_sensors,
+                              const double *source_x, const double *source_y,
+                              size_t n_sources, double *reading);
+
+/**
+ * @brief The exp() approximation used by AccumulateSensorReadings(), for
+ * x in roughly [-700, 700]. Accurate to a couple of ulp.
+ */
+double SensorKernelExp(double x);
+
+/**
+ * @brief Name of the instruction set AccumulateSensorReadings() uses on this
+ * machine ("avx2", "sse2" or "scalar").
+ */
+const char *SensorKernelIsa();
+
+NAMESPACE_END(csci3081);
+
+#endif  // SRC_SENSOR_KERNEL_H_
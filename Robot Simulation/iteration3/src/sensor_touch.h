@@ -64,6 +64,7 @@ class SensorTouch {
    * @brief Getter for output, which is true when collision occurs.
    */
   bool get_output() const { return output_; }
+  void set_output(bool output) { output_ = output; }
 
   /**
    * @brief Modify heading to presumably move away from collision.
@@ -0,0 +1,77 @@
+/**
+ * @file simulation_thread.cc
+ *
+ * @copyright 2018 Nate Samuelson, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <chrono>
+
+#include "src/simulation_thread.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Constructors/Destructor
+ ******************************************************************************/
+SimulationThread::SimulationThread(Arena *arena) : arena_(arena) {
+  // So there is something to draw before the thread first runs.
+  arena_->FillSnapshot(snapshots_.back());
+  snapshots_.Publish();
+} /* SimulationThread() */
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+void SimulationThread::Start() {
+  if (!thread_.joinable()) {
+    stop_ = false;
+    thread_ = std::thread(&SimulationThread::Run, this);
+  }
+} /* Start() */
+
+void SimulationThread::Stop() {
+  if (!thread_.joinable()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  wake_.notify_one();
+  thread_.join();
+} /* Stop() */
+
+void SimulationThread::Run() {
+  using Clock = std::chrono::steady_clock;
+  Clock::time_point last = Clock::now();
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stop_) {
+    Clock::time_point now = Clock::now();
+    std::chrono::duration<double> dt = now - last;
+    last = now;
+    if (arena_->get_game_status() == PLAYING) {
+      int steps = clock_.Advance(dt.count());
+      if (steps > 0) {
+        arena_->AdvanceTime(steps);
+        changed_ = true;
+      }
+    }
+    if (changed_) {
+      arena_->FillSnapshot(snapshots_.back());
+      snapshots_.Publish();
+      changed_ = false;
+    }
+    // Sleep until the next timestep is due, unless a command comes first.
+    std::chrono::duration<double> step(clock_.get_step_size() /
+                                       clock_.get_speed());
+    wake_.wait_for(lock, step);
+  }
+} /* Run() */
+
+NAMESPACE_END(csci3081);
@@ -0,0 +1,112 @@
+/**
+ * @file simulation_thread.h
+ *
+ * @copyright 2018 Nate Samuelson, All rights reserved.
+ */
+
+#ifndef SRC_SIMULATION_THREAD_H_
+#define SRC_SIMULATION_THREAD_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "src/arena.h"
+#include "src/common.h"
+#include "src/render_snapshot.h"
+#include "src/step_accumulator.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief Steps an Arena in real time on a thread of its own.
+ *
+ * While the Arena is PLAYING, the thread converts the wall clock time that
+ * has passed into timesteps with a StepAccumulator, takes them, and
+ * publishes a RenderSnapshot of the result. The viewer draws the latest
+ * snapshot without ever touching the Arena, so a slow frame does not hold
+ * up the simulation and a long batch of timesteps does not hold up drawing.
+ *
+ * Anything else that reads or changes the Arena (or the clock) must do so
+ * through Command(), which runs between batches of timesteps.
+ */
+class SimulationThread {
+ public:
+  /**
+   * @brief Constructor. The thread does not run until Start().
+   *
+   * @param[in] arena The Arena to step. Must outlive the thread.
+   */
+  explicit SimulationThread(Arena *arena);
+
+  /**
+   * @brief Destructor. Stops the thread.
+   */
+  ~SimulationThread() { Stop(); }
+
+  SimulationThread(const SimulationThread &other) = delete;
+  SimulationThread &operator=(const SimulationThread &other) = delete;
+
+  void Start();
+
+  /**
+   * @brief Stop the thread and wait for it to finish its current batch.
+   */
+  void Stop();
+
+  /**
+   * @brief Run `command` on the calling thread, with the simulation thread
+   * held off, then publish a new snapshot.
+   */
+  template <class F>
+  void Command(F command) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      command();
+      changed_ = true;
+    }
+    wake_.notify_one();
+  }
+
+  /**
+   * @brief The latest snapshot of the Arena. Must always be called from the
+   * same (viewer) thread.
+   */
+  const RenderSnapshot &Latest() { return snapshots_.Latest(); }
+
+  /**
+   * @brief The clock converting wall clock time into timesteps. Only to be
+   * used inside Command().
+   */
+  StepAccumulator *clock() { return &clock_; }
+
+ private:
+  /**
+   * @brief The body of the thread.
+   */
+  void Run();
+
+  Arena *arena_;
+  // Guards the Arena, clock_, changed_ and stop_.
+  std::mutex mutex_{};
+  // Signalled when a command has run or the thread should stop.
+  std::condition_variable wake_{};
+  StepAccumulator clock_{};
+  bool changed_{true};
+  bool stop_{false};
+  RenderSnapshotBuffer snapshots_{};
+  std::thread thread_{};
+};
+
+NAMESPACE_END(csci3081);
+
+#endif  // SRC_SIMULATION_THREAD_H_
@@ -0,0 +1,84 @@
+/**
+ * @file spatial_grid.cc
+ *
+ * @copyright 2018 Nate Samuelson, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <algorithm>
+#include <cmath>
+
+#include "src/spatial_grid.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+void SpatialGrid::Resize(double x_dim, double y_dim, double cell_size) {
+  cell_size_ = std::max(cell_size, 1.0);
+  n_cols_ = std::max(1, static_cast<int>(std::ceil(x_dim / cell_size_)));
+  n_rows_ = std::max(1, static_cast<int>(std::ceil(y_dim / cell_size_)));
+  cells_.resize(static_cast<size_t>(n_cols_ * n_rows_));
+  Clear();
+} /* Resize() */
+
+void SpatialGrid::Clear() {
+  for (auto &cell : cells_) {
+    cell.clear();
+  }
+  id_cell_.clear();
+} /* Clear() */
+
+void SpatialGrid::Insert(int id, double x, double y) {
+  int cell = CellIndex(x, y);
+  if (static_cast<size_t>(id) >= id_cell_.size()) {
+    id_cell_.resize(static_cast<size_t>(id) + 1, -1);
+  }
+  id_cell_[id] = cell;
+  cells_[cell].push_back(id);
+} /* Insert() */
+
+void SpatialGrid::Move(int id, double x, double y) {
+  int cell = CellIndex(x, y);
+  int old_cell = id_cell_[id];
+  if (cell == old_cell) {
+    return;
+  }
+  // Order within a cell does not matter, so swap the last id into the hole.
+  std::vector<int> &old_ids = cells_[old_cell];
+  auto it = std::find(old_ids.begin(), old_ids.end(), id);
+  *it = old_ids.back();
+  old_ids.pop_back();
+  id_cell_[id] = cell;
+  cells_[cell].push_back(id);
+} /* Move() */
+
+void SpatialGrid::Query(double x, double y, std::vector<int> *out) const {
+  out->clear();
+  int cell = CellIndex(x, y);
+  int col = cell % n_cols_;
+  int row = cell / n_cols_;
+  for (int r = std::max(0, row - 1); r <= std::min(n_rows_ - 1, row + 1);
+       ++r) {
+    for (int c = std::max(0, col - 1); c <= std::min(n_cols_ - 1, col + 1);
+         ++c) {
+      const std::vector<int> &ids = cells_[r * n_cols_ + c];
+      out->insert(out->end(), ids.begin(), ids.end());
+    }
+  }
+} /* Query() */
+
+int SpatialGrid::CellIndex(double x, double y) const {
+  // Clamp in floating point first so huge coordinates cannot overflow an int.
+  double col = std::min(std::max(x / cell_size_, 0.0), n_cols_ - 1.0);
+  double row = std::min(std::max(y / cell_size_, 0.0), n_rows_ - 1.0);
+  return static_cast<int>(row) * n_cols_ + static_cast<int>(col);
+} /* CellIndex() */
+
+NAMESPACE_END(csci3081);
@@ -0,0 +1,102 @@
+/**
+ * @file spatial_grid.h
+ *
+ * @copyright 2018 Nate Samuelson, All rights reserved.
+ */
+
+#ifndef SRC_SPATIAL_GRID_H_
+#define SRC_SPATIAL_GRID_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <vector>
+
+#include "src/common.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief A uniform grid over the Arena used as a broad phase for proximity
+ * queries between entities.
+ *
+ * The grid does not know anything about entities. Callers insert integer ids
+ * (e.g. an index into the Arena's entity list) at a position, and Query()
+ * returns every id stored in the 3x3 block of cells surrounding a point. As
+ * long as the cell size is at least the largest distance of interest (e.g.
+ * the sum of the two largest radii for collisions), no pair within that
+ * distance can be missed.
+ *
+ * Positions outside of the Arena are clamped to the border cells, so entities
+ * that have briefly left the Arena are still found.
+ */
+class SpatialGrid {
+ public:
+  /**
+   * @brief Constructor. The grid is empty until Resize() is called.
+   */
+  SpatialGrid() : cells_(), id_cell_() {}
+
+  /**
+   * @brief Size the grid to cover the Arena and remove all ids.
+   *
+   * @param[in] x_dim Width of the Arena.
+   * @param[in] y_dim Height of the Arena.
+   * @param[in] cell_size Edge length of a single (square) cell.
+   */
+  void Resize(double x_dim, double y_dim, double cell_size);
+
+  /**
+   * @brief Remove all ids, keeping the current dimensions (and the memory
+   * already reserved by each cell).
+   */
+  void Clear();
+
+  /**
+   * @brief Store an id in the cell containing (x, y).
+   *
+   * @param[in] id A non-negative id. Each id may be inserted only once.
+   */
+  void Insert(int id, double x, double y);
+
+  /**
+   * @brief Move a previously inserted id to the cell containing (x, y).
+   */
+  void Move(int id, double x, double y);
+
+  /**
+   * @brief Collect the ids of the 3x3 block of cells around (x, y).
+   *
+   * @param[out] out Cleared, then filled with the candidate ids. The order of
+   * the ids is unspecified.
+   */
+  void Query(double x, double y, std::vector<int> *out) const;
+
+  double get_cell_size() const { return cell_size_; }
+
+ private:
+  /**
+   * @brief Get the (clamped) index of the cell containing (x, y).
+   */
+  int CellIndex(double x, double y) const;
+
+  // Number of columns and rows of cells.
+  int n_cols_{1};
+  int n_rows_{1};
+  // Edge length of a cell. Zero until the first call to Resize().
+  double cell_size_{0};
+  // The ids stored in each cell, in row major order.
+  std::vector<std::vector<int>> cells_;
+  // The cell each id was inserted into, or -1 if the id is not in the grid.
+  std::vector<int> id_cell_;
+};
+
+NAMESPACE_END(csci3081);
+
+#endif  // SRC_SPATIAL_GRID_H_
@@ -0,0 +1,63 @@
+/**
+ * @file step_accumulator.cc
+ *
+ * @copyright 2018 Nate Samuelson, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <algorithm>
+#include <cmath>
+
+#include "src/step_accumulator.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Constructors/Destructor
+ ******************************************************************************/
+StepAccumulator::StepAccumulator(double step_size, int max_substeps)
+    : step_size_(SIM_STEP_SIZE), max_substeps_(SIM_MAX_SUBSTEPS) {
+  set_step_size(step_size);
+  set_max_substeps(max_substeps);
+} /* StepAccumulator() */
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+int StepAccumulator::Advance(double dt) {
+  if (dt > 0) {
+    accumulated_ += dt * speed_;
+  }
+  double steps = std::floor(accumulated_ / step_size_);
+  if (steps > max_substeps_) {
+    // Too far behind: take the capped number of steps, drop the rest.
+    dropped_ += accumulated_ - max_substeps_ * step_size_;
+    accumulated_ = 0;
+    return max_substeps_;
+  }
+  accumulated_ -= steps * step_size_;
+  return static_cast<int>(steps);
+} /* Advance() */
+
+void StepAccumulator::set_step_size(double step_size) {
+  if (step_size > 0) {
+    step_size_ = step_size;
+  }
+} /* set_step_size() */
+
+void StepAccumulator::set_max_substeps(int max_substeps) {
+  max_substeps_ = std::max(max_substeps, 1);
+} /* set_max_substeps() */
+
+void StepAccumulator::set_speed(double speed) {
+  if (speed > 0) {
+    speed_ = speed;
+  }
+} /* set_speed() */
+
+NAMESPACE_END(csci3081);
@@ -0,0 +1,93 @@
+/**
+ * @file step_accumulator.h
+ *
+ * @copyright 2018 Nate Samuelson, All rights reserved.
+ */
+
+#ifndef SRC_STEP_ACCUMULATOR_H_
+#define SRC_STEP_ACCUMULATOR_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "src/common.h"
+#include "src/params.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief Converts elapsed wall clock time into a number of fixed-size Arena
+ * timesteps.
+ *
+ * Every frame, the elapsed time (multiplied by the speed, for fast-forward)
+ * is added to an accumulator, and one Arena timestep is taken for each full
+ * step_size it holds. The remainder carries over to the next frame, so the
+ * simulation advances at the same rate whatever the frame rate, and a slow
+ * frame is caught up on rather than lost.
+ *
+ * If the Arena cannot keep up, at most max_substeps steps are taken per
+ * frame and the rest of the backlog is dropped, so that a slow frame does not
+ * lead to ever more steps in the following frames.
+ */
+class StepAccumulator {
+ public:
+  /**
+   * @brief Constructor.
+   *
+   * @param[in] step_size Wall clock seconds per timestep at normal speed.
+   * @param[in] max_substeps The most timesteps returned by a single Advance().
+   */
+  explicit StepAccumulator(double step_size = SIM_STEP_SIZE,
+                           int max_substeps = SIM_MAX_SUBSTEPS);
+
+  /**
+   * @brief Add the time elapsed since the last frame.
+   *
+   * @param[in] dt Elapsed wall clock seconds.
+   *
+   * @return The number of timesteps to take this frame.
+   */
+  int Advance(double dt);
+
+  /**
+   * @brief Discard any accumulated time (e.g. on a new game).
+   */
+  void Reset() { accumulated_ = 0; }
+
+  double get_step_size() const { return step_size_; }
+  void set_step_size(double step_size);
+
+  int get_max_substeps() const { return max_substeps_; }
+  void set_max_substeps(int max_substeps);
+
+  /**
+   * @brief Simulated time per wall clock time. 1 is normal speed, K > 1
+   * fast-forwards K times.
+   */
+  double get_speed() const { return speed_; }
+  void set_speed(double speed);
+
+  /**
+   * @brief Total simulated time dropped because the step cap was reached.
+   */
+  double get_dropped_time() const { return dropped_; }
+
+ private:
+  double step_size_;
+  int max_substeps_;
+  double speed_{1};
+  // Simulated time not yet consumed by a timestep. Always < step_size_
+  // between calls to Advance().
+  double accumulated_{0};
+  double dropped_{0};
+};
+
+NAMESPACE_END(csci3081);
+
+#endif  // SRC_STEP_ACCUMULATOR_H_
@@ -0,0 +1,326 @@
+/**
+ * @file sweep.cc
+ *
+ * @copyright 2018 Nate Samuelson, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+#include "src/arena.h"
+#include "src/rng.h"
+#include "src/sweep.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+static std::string Trim(const std::string &text) {
+  size_t begin = text.find_first_not_of(" \t\r");
+  if (begin == std::string::npos) {
+    return "";
+  }
+  return text.substr(begin, text.find_last_not_of(" \t\r") + 1 - begin);
+} /* Trim() */
+
+// The whole of `text` as a number.
+static bool ParseNumber(const std::string &text, double *value) {
+  std::string trimmed = Trim(text);
+  char *end;
+  *value = strtod(trimmed.c_str(), &end);
+  return !trimmed.empty() && *end == '\0' && std::isfinite(*value);
+} /* ParseNumber() */
+
+// Uniform in [0, 1).
+static double Uniform(Rng *rng) {
+  return static_cast<double>(rng->Next() >> 11) / 9007199254740992.0;
+} /* Uniform() */
+
+// A seed for an Arena; 0 would ask for a random one.
+static uint64_t RunSeed(Rng *rng) {
+  uint64_t seed = rng->Next();
+  return seed ? seed : 1;
+} /* RunSeed() */
+
+/*******************************************************************************
+ * SweepDesign Member Functions
+ ******************************************************************************/
+SweepDesign::SweepDesign() {
+  values_[kSweepRobots].list = {N_ROBOTS};
+  values_[kSweepLights].list = {N_LIGHTS};
+  values_[kSweepFoods].list = {N_FOODS};
+  values_[kSweepRatio].list = {0.5};
+  values_[kSweepSensitivity].list = {1.0};
+  values_[kSweepAggressive].list = {0};
+  values_[kSweepLove].list = {0};
+} /* SweepDesign() */
+
+const char *SweepDesign::ParamName(SweepParam param) {
+  switch (param) {
+    case kSweepRobots: return "robots";
+    case kSweepLights: return "lights";
+    case kSweepFoods: return "foods";
+    case kSweepRatio: return "ratio";
+    case kSweepSensitivity: return "sensitivity";
+    case kSweepAggressive: return "aggressive";
+    case kSweepLove: return "love";
+    default: return "unknown";
+  }
+} /* ParamName() */
+
+bool SweepDesign::Parse(std::istream &in, std::string *error) {
+  std::string line;
+  int line_number = 0;
+  while (std::getline(in, line)) {
+    ++line_number;
+    std::string where = "line " + std::to_string(line_number) + ": ";
+    line = Trim(line.substr(0, line.find('#')));
+    if (line.empty()) {
+      continue;
+    }
+    size_t equals = line.find('=');
+    if (equals == std::string::npos) {
+      *error = where + "expected `key = value`";
+      return false;
+    }
+    std::string key = Trim(line.substr(0, equals));
+    std::string value = Trim(line.substr(equals + 1));
+    double number;
+
+    if (key == "design") {
+      if (value != "grid" && value != "random") {
+        *error = where + "design is `grid` or `random`";
+        return false;
+      }
+      random_ = value == "random";
+      continue;
+    }
+    if (key == "runs" || key == "repeats" || key == "steps" ||
+        key == "seed") {
+      if (!ParseNumber(value, &number) || number < 1 ||
+          std::fmod(number, 1) > 0) {
+        *error = where + key + " must be a whole number above 0";
+        return false;
+      }
+      if (key == "runs") {
+        runs_ = static_cast<size_t>(number);
+      } else if (key == "repeats") {
+        repeats_ = static_cast<size_t>(number);
+      } else if (key == "steps") {
+        steps_ = static_cast<long>(number);
+      } else {
+        seed_ = static_cast<uint64_t>(number);
+      }
+      continue;
+    }
+
+    int param = 0;
+    while (param < kSweepParamCount &&
+           key != ParamName(static_cast<SweepParam>(param))) {
+      ++param;
+    }
+    if (param == kSweepParamCount) {
+      *error = where + "unknown key `" + key + "`";
+      return false;
+    }
+    // Fractions are at most 1; everything is at least 0.
+    double max = (param == kSweepRatio || param == kSweepAggressive ||
+                  param == kSweepLove) ? 1 : HUGE_VAL;
+    Values values;
+    size_t dots = value.find("..");
+    if (dots != std::string::npos) {
+      values.range = true;
+      if (!ParseNumber(value.substr(0, dots), &values.lo) ||
+          !ParseNumber(value.substr(dots + 2), &values.hi) ||
+          values.lo > values.hi) {
+        *error = where + "expected a range `lo..hi`";
+        return false;
+      }
+      values.list = {values.lo, values.hi};
+    } else {
+      std::istringstream items(value);
+      std::string item;
+      while (std::getline(items, item, ',')) {
+        if (!ParseNumber(item, &number)) {
+          *error = where + "expected a list of numbers";
+          return false;
+        }
+        values.list.push_back(number);
+      }
+      if (values.list.empty()) {
+        *error = where + "no values for " + key;
+        return false;
+      }
+    }
+    for (double v : values.list) {
+      if (v < 0 || v > max) {
+        *error = where + key + " out of range";
+        return false;
+      }
+    }
+    values_[param] = values;
+  }
+
+  if (!random_) {
+    for (int param = 0; param < kSweepParamCount; ++param) {
+      if (values_[param].range) {
+        *error = std::string("ranges need `design = random` (") +
+                 ParamName(static_cast<SweepParam>(param)) + ")";
+        return false;
+      }
+    }
+  }
+  return true;
+} /* Parse() */
+
+std::vector<SweepRun> SweepDesign::Runs() const {
+  std::vector<SweepRun> runs;
+  Rng rng(seed_);
+  double value[kSweepParamCount];
+  size_t configurations = 1;
+  if (random_) {
+    configurations = runs_;
+  } else {
+    for (const Values &values : values_) {
+      configurations *= values.list.size();
+    }
+  }
+  for (size_t c = 0; c < configurations; ++c) {
+    if (random_) {
+      for (int param = 0; param < kSweepParamCount; ++param) {
+        const Values &values = values_[param];
+        if (values.range) {
+          value[param] = values.lo + (values.hi - values.lo) * Uniform(&rng);
+        } else {
+          value[param] = values.list[rng.Below(
+            static_cast<int>(values.list.size()))];
+        }
+      }
+    } else {
+      // The last parameter varies fastest.
+      size_t rest = c;
+      for (int param = kSweepParamCount - 1; param >= 0; --param) {
+        const std::vector<double> &list = values_[param].list;
+        value[param] = list[rest % list.size()];
+        rest /= list.size();
+      }
+    }
+    for (size_t r = 0; r < repeats_; ++r) {
+      SweepRun run;
+      run.index = runs.size();
+      run.steps = steps_;
+      Apply(value, &run);
+      run.params.seed = RunSeed(&rng);
+      runs.push_back(run);
+    }
+  }
+  return runs;
+} /* Runs() */
+
+void SweepDesign::Apply(const double value[kSweepParamCount], SweepRun *run) {
+  run->params.n_robots = static_cast<size_t>(std::lround(value[kSweepRobots]));
+  run->params.n_lights = static_cast<size_t>(std::lround(value[kSweepLights]));
+  run->params.n_foods = static_cast<size_t>(std::lround(value[kSweepFoods]));
+  // Runs are spread over the cores already.
+  run->params.n_threads = 1;
+  run->robot_ratio = value[kSweepRatio];
+  run->light_sensitivity = value[kSweepSensitivity];
+  run->aggressive = value[kSweepAggressive];
+  run->love = value[kSweepLove];
+} /* Apply() */
+
+/*******************************************************************************
+ * Running
+ ******************************************************************************/
+SweepResult RunConfiguration(const SweepRun &run) {
+  auto start = std::chrono::steady_clock::now();
+  Arena arena(&run.params);
+
+  // Same set up sequence as the headless driver, plus the other types.
+  int n_robots = static_cast<int>(run.params.n_robots);
+  int aggressive = static_cast<int>(std::lround(run.aggressive * n_robots));
+  int love = std::min(static_cast<int>(std::lround(run.love * n_robots)),
+                      n_robots - aggressive);
+  int rest = n_robots - aggressive - love;
+  int explorers = static_cast<int>(run.robot_ratio * rest);
+  arena.set_light_sensitivity(run.light_sensitivity);
+  arena.AddRobot(rest - explorers, kCoward);
+  arena.AddRobot(explorers, kExplore);
+  arena.AddRobot(aggressive, kAggressive);
+  arena.AddRobot(love, kLove);
+  arena.AddLight(static_cast<int>(run.params.n_lights));
+  if (run.params.n_foods > 0) {
+    arena.AddFood(static_cast<int>(run.params.n_foods));
+    arena.AcceptCommand(kFoodOn);
+  } else {
+    arena.AcceptCommand(kFoodOff);
+  }
+  arena.AcceptCommand(kPlay);
+  arena.set_record_events(true);
+
+  SweepResult result;
+  while (result.survival_steps < run.steps &&
+         arena.get_game_status() == PLAYING) {
+    arena.AdvanceTime(1);
+    ++result.survival_steps;
+    for (const ArenaEvent &event : arena.get_events()) {
+      switch (event.type) {
+        case kEventFoodCaptured: ++result.food_captures; break;
+        case kEventRobotCollision: ++result.robot_collisions; break;
+        case kEventRobotHitWall: ++result.robot_wall_collisions; break;
+        case kEventLightHitWall: ++result.light_wall_collisions; break;
+        default: break;
+      }
+    }
+    arena.ClearEvents();
+  }
+
+  result.game_status = arena.get_game_status();
+  double hunger = 0;
+  for (Robot *robot : arena.get_robots().entities()) {
+    result.starved += robot->CheckStarvation() ? 1 : 0;
+    hunger += robot->get_hunger_level();
+  }
+  result.mean_hunger = n_robots ? hunger / n_robots : 0;
+  std::chrono::duration<double> elapsed =
+    std::chrono::steady_clock::now() - start;
+  result.seconds = elapsed.count();
+  return result;
+} /* RunConfiguration() */
+
+void WriteSweepCsvHeader(std::ostream &out) {
+  out << "run,seed";
+  for (int param = 0; param < kSweepParamCount; ++param) {
+    out << "," << SweepDesign::ParamName(static_cast<SweepParam>(param));
+  }
+  out << ",steps,lost,survival_steps,starved,mean_hunger,food_captures,"
+      << "robot_collisions,robot_wall_collisions,light_wall_collisions,"
+      << "seconds\n";
+} /* WriteSweepCsvHeader() */
+
+void WriteSweepCsvRow(std::ostream &out, const SweepRun &run,
+                      const SweepResult &result) {
+  out << run.index << "," << run.params.seed << ","
+      << run.params.n_robots << "," << run.params.n_lights << ","
+      << run.params.n_foods << "," << run.robot_ratio << ","
+      << run.light_sensitivity << "," << run.aggressive << ","
+      << run.love << "," << run.steps << ","
+      << (result.game_status == LOST ? 1 : 0) << ","
+      << result.survival_steps << "," << result.starved << ","
+      << result.mean_hunger << "," << result.food_captures << ","
+      << result.robot_collisions << "," << result.robot_wall_collisions
+      << "," << result.light_wall_collisions << "," << result.seconds
+      << "\n";
+} /* WriteSweepCsvRow() */
+
+NAMESPACE_END(csci3081);
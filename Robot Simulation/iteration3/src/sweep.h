@@ -0,0 +1,166 @@
+/**
+ * @file sweep.h
+ *
+ * @copyright 2018 Nate Samuelson, All rights reserved.
+ */
+
+#ifndef SRC_SWEEP_H_
+#define SRC_SWEEP_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "src/arena_params.h"
+#include "src/common.h"
+#include "src/params.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Struct Definitions
+ ******************************************************************************/
+/**
+ * @brief The parameters a sweep can vary, and their names in a sweep spec.
+ */
+enum SweepParam {
+  kSweepRobots, kSweepLights, kSweepFoods, kSweepRatio, kSweepSensitivity,
+  kSweepAggressive, kSweepLove, kSweepParamCount
+};
+
+/**
+ * @brief One configuration of a sweep: an Arena and the behavior parameters
+ * otherwise set with the GUI sliders.
+ */
+struct SweepRun {
+  // Position in the sweep, from 0.
+  size_t index{0};
+  // Includes the Arena's seed; always one thread.
+  arena_params params{};
+  // Fraction of the Coward and Explore robots that explore (the viewer's
+  // robot_ratio_).
+  double robot_ratio{0.5};
+  double light_sensitivity{1.0};
+  // Fractions of all robots that are Aggressive and Love robots.
+  double aggressive{0};
+  double love{0};
+  // Most timesteps to run; the run ends earlier if a robot starves.
+  long steps{0};
+};
+
+/**
+ * @brief What happened in a run.
+ */
+struct SweepResult {
+  int game_status{PAUSED};
+  // Timesteps until the first robot starved (the game was lost), or all of
+  // them if none did.
+  long survival_steps{0};
+  int starved{0};
+  double mean_hunger{0};
+  long food_captures{0};
+  long robot_collisions{0};
+  long robot_wall_collisions{0};
+  long light_wall_collisions{0};
+  double seconds{0};
+};
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief The set of configurations of a parameter sweep, read from a spec.
+ *
+ * A spec has one `key = value` per line; `#` starts a comment. The
+ * parameters (robots, lights, foods, ratio, sensitivity, aggressive, love)
+ * take a comma separated list of values, or for a random design a range
+ * `lo..hi`. Other keys:
+ *
+ *   design = grid      every combination of the listed values (default)
+ *   design = random    `runs` configurations, each parameter picked
+ *                      uniformly from its list or range
+ *   runs = N           number of random configurations (default 100)
+ *   repeats = N        runs of each configuration, with different seeds
+ *   steps = N          most timesteps per run (default 10000)
+ *   seed = N           seed of the design and of every run's Arena
+ *
+ * For example:
+ *
+ *   design = grid
+ *   robots = 10, 20
+ *   sensitivity = 0.5, 1, 2
+ *   repeats = 4
+ *
+ * is 24 runs. Parameters not given keep the defaults of params.h and the
+ * viewer.
+ */
+class SweepDesign {
+ public:
+  SweepDesign();
+
+  /**
+   * @brief Read a spec.
+   *
+   * @param[out] error What is wrong with the spec, when false is returned.
+   */
+  bool Parse(std::istream &in, std::string *error);
+
+  /**
+   * @brief Every run of the sweep, in order. The same spec always gives the
+   * same runs.
+   */
+  std::vector<SweepRun> Runs() const;
+
+  /**
+   * @brief The name of a parameter in specs and CSV headers.
+   */
+  static const char *ParamName(SweepParam param);
+
+ private:
+  // The values of one parameter: a list, or the range [lo, hi].
+  struct Values {
+    std::vector<double> list{};
+    bool range{false};
+    double lo{0};
+    double hi{0};
+  };
+
+  /**
+   * @brief Set the parameters of `run` from the chosen values.
+   */
+  static void Apply(const double value[kSweepParamCount], SweepRun *run);
+
+  Values values_[kSweepParamCount];
+  bool random_{false};
+  size_t runs_{100};
+  size_t repeats_{1};
+  long steps_{10000};
+  uint64_t seed_{1};
+};
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+/**
+ * @brief Set up and run one configuration in a headless Arena, the way the
+ * headless driver does.
+ */
+SweepResult RunConfiguration(const SweepRun &run);
+
+/**
+ * @brief Write the CSV header, or the row of one finished run.
+ */
+void WriteSweepCsvHeader(std::ostream &out);
+void WriteSweepCsvRow(std::ostream &out, const SweepRun &run,
+                      const SweepResult &result);
+
+NAMESPACE_END(csci3081);
+
+#endif  // SRC_SWEEP_H_
@@ -0,0 +1,117 @@
+/**
+ * @file sweep_main.cc
+ *
+ * @copyright 2018 Nate Samuelson, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+
+#include "src/sweep.h"
+#include "src/work_stealing_pool.h"
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+static void PrintUsage(const char *exe) {
+  std::cout << "usage: " << exe << " SPEC [options]\n"
+            << "  SPEC             file describing the runs, see sweep.h\n"
+            << "  --jobs N         runs at the same time (default 0: one per "
+            << "core)\n"
+            << "  --out F          write the CSV to file F (default: stdout)\n";
+}
+
+/**
+ * Parameter sweep driver. Reads a grid or random design from SPEC, runs every
+ * configuration as its own headless Arena, several at once, and writes one
+ * CSV row per run as soon as it finishes (so rows are not in run order).
+ */
+int main(int argc, char **argv) {
+  const char *spec = nullptr;
+  const char *out_file = nullptr;
+  size_t jobs = 0;
+
+  for (int i = 1; i < argc; ++i) {
+    bool has_value = i + 1 < argc;
+    if (!strcmp(argv[i], "--jobs") && has_value) {
+      jobs = static_cast<size_t>(atoi(argv[++i]));
+    } else if (!strcmp(argv[i], "--out") && has_value) {
+      out_file = argv[++i];
+    } else if (argv[i][0] != '-' && !spec) {
+      spec = argv[i];
+    } else {
+      PrintUsage(argv[0]);
+      return strcmp(argv[i], "--help") ? 1 : 0;
+    }
+  }
+  if (!spec) {
+    PrintUsage(argv[0]);
+    return 1;
+  }
+
+  std::ifstream spec_in(spec);
+  if (!spec_in) {
+    std::cerr << "cannot read " << spec << ": " << strerror(errno)
+              << std::endl;
+    return 1;
+  }
+  csci3081::SweepDesign design;
+  std::string error;
+  if (!design.Parse(spec_in, &error)) {
+    std::cerr << spec << ": " << error << std::endl;
+    return 1;
+  }
+  std::vector<csci3081::SweepRun> runs = design.Runs();
+
+  std::ofstream file_out;
+  if (out_file) {
+    file_out.open(out_file);
+    if (!file_out) {
+      std::cerr << "cannot write " << out_file << ": " << strerror(errno)
+                << std::endl;
+      return 1;
+    }
+  }
+  std::ostream &out = out_file ? file_out : std::cout;
+  csci3081::WriteSweepCsvHeader(out);
+  out.flush();
+
+  csci3081::WorkStealingPool pool(jobs);
+  std::cerr << runs.size() << " runs on " << pool.get_n_threads()
+            << " threads" << std::endl;
+
+  std::mutex out_mutex;
+  size_t n_lost = 0;
+  double run_seconds = 0;
+  auto start = std::chrono::steady_clock::now();
+  pool.Run(runs.size(), [&](size_t task, size_t) {
+      csci3081::SweepResult result = csci3081::RunConfiguration(runs[task]);
+      std::lock_guard<std::mutex> lock(out_mutex);
+      csci3081::WriteSweepCsvRow(out, runs[task], result);
+      out.flush();
+      n_lost += result.game_status == LOST ? 1 : 0;
+      run_seconds += result.seconds;
+    });
+  std::chrono::duration<double> elapsed =
+    std::chrono::steady_clock::now() - start;
+
+  if (!out) {
+    std::cerr << "cannot write the results: " << strerror(errno)
+              << std::endl;
+    return 1;
+  }
+  std::cerr << "runs:      " << runs.size() << " (" << n_lost << " lost)\n"
+            << "wall time: " << elapsed.count() << " s\n"
+            << "run time:  " << run_seconds << " s (speedup "
+            << (elapsed.count() > 0 ? run_seconds / elapsed.count() : 0)
+            << "x)" << std::endl;
+  return 0;
+}
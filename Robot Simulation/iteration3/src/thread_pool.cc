@@ -0,0 +1,88 @@
+/**
+ * @file thread_pool.cc
+ *
+ * @copyright 2018 Nate Samuelson, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "src/thread_pool.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Constructors/Destructor
+ ******************************************************************************/
+ThreadPool::ThreadPool(size_t n_threads)
+    : workers_(), mutex_(), start_cv_(), done_cv_() {
+  for (size_t t = 1; t < n_threads; ++t) {
+    workers_.emplace_back(&ThreadPool::WorkerMain, this, t);
+  }
+} /* ThreadPool() */
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  start_cv_.notify_all();
+  for (auto &worker : workers_) {
+    worker.join();
+  }
+} /* ~ThreadPool() */
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+void ThreadPool::ParallelFor(size_t n, const Body &body) {
+  if (workers_.empty() || n < 2) {
+    body(0, n, 0);
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    body_ = &body;
+    n_ = n;
+    pending_ = workers_.size();
+    ++generation_;
+  }
+  start_cv_.notify_all();
+  RunChunk(0);
+  std::unique_lock<std::mutex> lock(mutex_);
+  done_cv_.wait(lock, [this] { return pending_ == 0; });
+  body_ = nullptr;
+} /* ParallelFor() */
+
+void ThreadPool::WorkerMain(size_t thread) {
+  unsigned long seen = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      start_cv_.wait(lock, [&] { return stop_ || generation_ != seen; });
+      if (stop_) {
+        return;
+      }
+      seen = generation_;
+    }
+    RunChunk(thread);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (--pending_ == 0) {
+      done_cv_.notify_one();
+    }
+  }
+} /* WorkerMain() */
+
+void ThreadPool::RunChunk(size_t thread) {
+  size_t n_threads = get_n_threads();
+  size_t begin = n_ * thread / n_threads;
+  size_t end = n_ * (thread + 1) / n_threads;
+  if (begin < end) {
+    (*body_)(begin, end, thread);
+  }
+} /* RunChunk() */
+
+NAMESPACE_END(csci3081);
@@ -0,0 +1,104 @@
+/**
+ * @file thread_pool.h
+ *
+ * @copyright 2018 Nate Samuelson, All rights reserved.
+ */
+
+#ifndef SRC_THREAD_POOL_H_
+#define SRC_THREAD_POOL_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "src/common.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief A fixed set of worker threads for data-parallel loops.
+ *
+ * ParallelFor() splits an index range into one contiguous chunk per thread.
+ * The calling thread works on the first chunk, so a pool of n threads starts
+ * only n - 1 workers, and a pool of one thread runs everything inline.
+ *
+ * The split only depends on the range and the number of threads, never on
+ * timing, so a loop body that only writes to its own indices gives the same
+ * results whatever the number of threads.
+ */
+class ThreadPool {
+ public:
+  /**
+   * @brief The body of a parallel loop. Called with a half-open range
+   * [begin, end) and the index of the thread running it, in
+   * [0, get_n_threads()).
+   */
+  using Body = std::function<void(size_t begin, size_t end, size_t thread)>;
+
+  /**
+   * @brief Constructor.
+   *
+   * @param[in] n_threads Total number of threads, including the caller. Zero
+   * is treated as one.
+   */
+  explicit ThreadPool(size_t n_threads);
+
+  /**
+   * @brief Stops and joins the workers.
+   */
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool &other) = delete;
+  ThreadPool &operator=(const ThreadPool &other) = delete;
+
+  /**
+   * @brief Run `body` over [0, n) and wait until every chunk is done.
+   *
+   * Must not be called from inside a loop body.
+   */
+  void ParallelFor(size_t n, const Body &body);
+
+  size_t get_n_threads() const { return workers_.size() + 1; }
+
+ private:
+  /**
+   * @brief Worker loop: wait for a new loop, run this worker's chunk, repeat.
+   */
+  void WorkerMain(size_t thread);
+
+  /**
+   * @brief Run the chunk of the current loop belonging to `thread`.
+   */
+  void RunChunk(size_t thread);
+
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  // Signalled when a new loop starts (or the pool stops).
+  std::condition_variable start_cv_;
+  // Signalled when the last worker finishes its chunk.
+  std::condition_variable done_cv_;
+  // The current loop. Only valid while pending_ > 0.
+  const Body *body_{nullptr};
+  size_t n_{0};
+  // Incremented for every loop so workers can tell a new loop from a
+  // spurious wakeup.
+  unsigned long generation_{0};
+  // Number of workers that have not finished the current loop.
+  size_t pending_{0};
+  bool stop_{false};
+};
+
+NAMESPACE_END(csci3081);
+
+#endif  // SRC_THREAD_POOL_H_
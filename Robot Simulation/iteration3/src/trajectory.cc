@@ -0,0 +1,488 @@
+/**
+ * @file trajectory.cc
+ *
+ * @copyright 2018 Nate Samuelson, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <errno.h>
+#include <sys/types.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "src/arena_entity.h"
+#include "src/trajectory.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+static void PutVarint(std::vector<uint8_t> *out, uint64_t value) {
+  while (value >= 0x80) {
+    out->push_back(static_cast<uint8_t>(value | 0x80));
+    value >>= 7;
+  }
+  out->push_back(static_cast<uint8_t>(value));
+} /* PutVarint() */
+
+// Zigzag encoding maps small negative numbers to small unsigned ones.
+static void PutSigned(std::vector<uint8_t> *out, int64_t value) {
+  PutVarint(out, (static_cast<uint64_t>(value) << 1) ^
+                 static_cast<uint64_t>(value >> 63));
+} /* PutSigned() */
+
+static bool GetVarint(const std::vector<uint8_t> &in, size_t *position,
+                      uint64_t *value) {
+  uint64_t result = 0;
+  for (int shift = 0; shift < 64 && *position < in.size(); shift += 7) {
+    uint8_t byte = in[(*position)++];
+    result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) {
+      *value = result;
+      return true;
+    }
+  }
+  return false;
+} /* GetVarint() */
+
+static bool GetSigned(const std::vector<uint8_t> &in, size_t *position,
+                      int64_t *value) {
+  uint64_t zigzag;
+  if (!GetVarint(in, position, &zigzag)) {
+    return false;
+  }
+  *value = static_cast<int64_t>(zigzag >> 1) ^ -static_cast<int64_t>(zigzag & 1);
+  return true;
+} /* GetSigned() */
+
+static bool GetInt(const std::vector<uint8_t> &in, size_t *position,
+                   int *value) {
+  int64_t wide;
+  if (!GetSigned(in, position, &wide)) {
+    return false;
+  }
+  *value = static_cast<int>(wide);
+  return true;
+} /* GetInt() */
+
+// Events mostly come in id order, and collisions are between neighbors, so
+// ids are stored relative to the event before and the other Robot of a
+// collision relative to the first.
+static int RelativeTo(const ArenaEvent &event) {
+  return event.type == kEventRobotCollision ? event.id : 0;
+} /* RelativeTo() */
+
+static int64_t Quantize(double value, double scale) {
+  return static_cast<int64_t>(std::llround(value * scale));
+} /* Quantize() */
+
+/*******************************************************************************
+ * TrajectoryWriter Member Functions
+ ******************************************************************************/
+bool TrajectoryWriter::Open(const std::string &path, double x_dim,
+                            double y_dim, int keyframe_interval) {
+  Close();
+  file_ = fopen(path.c_str(), "wb");
+  if (!file_) {
+    return false;
+  }
+  scale_ = TRAJECTORY_SCALE;
+  keyframe_interval_ = static_cast<uint32_t>(std::max(keyframe_interval, 1));
+  chunk_header_ = TrajectoryChunk();
+  chunk_.clear();
+  index_.clear();
+  last_.clear();
+  n_frames_ = 0;
+
+  TrajectoryHeader header{};
+  memcpy(header.magic, kTrajectoryMagic, sizeof(header.magic));
+  header.version = kTrajectoryVersion;
+  header.byte_order = kCheckpointByteOrder;
+  header.x_dim = x_dim;
+  header.y_dim = y_dim;
+  header.scale = scale_;
+  header.keyframe_interval = keyframe_interval_;
+  if (fwrite(&header, sizeof(header), 1, file_) != 1) {
+    int saved_errno = errno;
+    fclose(file_);
+    file_ = nullptr;
+    errno = saved_errno;
+    return false;
+  }
+  offset_ = sizeof(header);
+  return true;
+} /* Open() */
+
+bool TrajectoryWriter::AddFrame(const EntityStore &store, int game_status,
+                                const std::vector<ArenaEvent> &events) {
+  if (!file_) {
+    errno = EBADF;
+    return false;
+  }
+  size_t n = store.size();
+  current_.resize(n);
+  bool keyframe = chunk_header_.n_frames == 0 ||
+                  chunk_header_.n_frames >= keyframe_interval_ ||
+                  last_.size() != n;
+  for (size_t i = 0; i < n; ++i) {
+    TrajectoryEntity &ent = current_[i];
+    ent.dx = ent.dy = ent.dtheta = 0;
+    ent.type = store.type[i];
+    ent.id = store.entity[i]->get_id();
+    ent.color = store.entity[i]->get_color();
+    ent.radius = Quantize(store.radius[i], scale_);
+    ent.x = Quantize(store.x[i], scale_);
+    ent.y = Quantize(store.y[i], scale_);
+    ent.theta = Quantize(store.theta[i], scale_);
+    // Only the motion of mobile entities is stored between keyframes.
+    if (!keyframe) {
+      const TrajectoryEntity &last = last_[i];
+      keyframe = ent.type != last.type || ent.id != last.id ||
+                 ent.color != last.color || ent.radius != last.radius ||
+                 (ent.type == kFood &&
+                  (ent.x != last.x || ent.y != last.y ||
+                   ent.theta != last.theta));
+    }
+  }
+
+  if (keyframe) {
+    if (!FlushChunk()) {
+      return false;
+    }
+    chunk_header_.first_step = n_frames_;
+    PutVarint(&chunk_, n);
+    for (const TrajectoryEntity &ent : current_) {
+      PutSigned(&chunk_, ent.type);
+      PutSigned(&chunk_, ent.id);
+      PutSigned(&chunk_, ent.color.r);
+      PutSigned(&chunk_, ent.color.g);
+      PutSigned(&chunk_, ent.color.b);
+      PutSigned(&chunk_, ent.radius);
+      PutSigned(&chunk_, ent.x);
+      PutSigned(&chunk_, ent.y);
+      PutSigned(&chunk_, ent.theta);
+    }
+  }
+  PutSigned(&chunk_, game_status);
+  PutVarint(&chunk_, events.size());
+  int last_id = 0;
+  for (const ArenaEvent &event : events) {
+    PutSigned(&chunk_, event.type);
+    PutSigned(&chunk_, event.id - last_id);
+    PutSigned(&chunk_, event.other - RelativeTo(event));
+    last_id = event.id;
+  }
+  if (!keyframe) {
+    for (size_t i = 0; i < n; ++i) {
+      TrajectoryEntity &ent = current_[i];
+      const TrajectoryEntity &last = last_[i];
+      if (ent.type == kFood) {
+        continue;
+      }
+      ent.dx = ent.x - last.x;
+      ent.dy = ent.y - last.y;
+      ent.dtheta = ent.theta - last.theta;
+      PutSigned(&chunk_, ent.dx - last.dx);
+      PutSigned(&chunk_, ent.dy - last.dy);
+      PutSigned(&chunk_, ent.dtheta - last.dtheta);
+    }
+  }
+  last_.swap(current_);
+  ++chunk_header_.n_frames;
+  ++n_frames_;
+  return true;
+} /* AddFrame() */
+
+bool TrajectoryWriter::FlushChunk() {
+  if (chunk_header_.n_frames == 0) {
+    return true;
+  }
+  if (chunk_.size() > UINT32_MAX) {
+    errno = EFBIG;
+    return false;
+  }
+  chunk_header_.size = static_cast<uint32_t>(chunk_.size());
+  if (fwrite(&chunk_header_, sizeof(chunk_header_), 1, file_) != 1 ||
+      fwrite(chunk_.data(), 1, chunk_.size(), file_) != chunk_.size()) {
+    return false;
+  }
+  index_.push_back({chunk_header_.first_step, offset_});
+  offset_ += sizeof(chunk_header_) + chunk_.size();
+  chunk_.clear();
+  chunk_header_.n_frames = 0;
+  return true;
+} /* FlushChunk() */
+
+bool TrajectoryWriter::Close() {
+  if (!file_) {
+    return true;
+  }
+  bool ok = FlushChunk();
+  TrajectoryTrailer trailer{};
+  trailer.index_offset = offset_;
+  trailer.n_chunks = index_.size();
+  memcpy(trailer.magic, kTrajectoryIndexMagic, sizeof(trailer.magic));
+  ok = ok &&
+       fwrite(index_.data(), sizeof(TrajectoryIndexEntry), index_.size(),
+              file_) == index_.size() &&
+       fwrite(&trailer, sizeof(trailer), 1, file_) == 1;
+  int saved_errno = errno;
+  ok = (fclose(file_) == 0) && ok;
+  if (ok) {
+    offset_ += index_.size() * sizeof(TrajectoryIndexEntry) + sizeof(trailer);
+  } else {
+    errno = saved_errno;
+  }
+  file_ = nullptr;
+  return ok;
+} /* Close() */
+
+/*******************************************************************************
+ * TrajectoryReader Member Functions
+ ******************************************************************************/
+bool TrajectoryReader::Open(const std::string &path) {
+  Close();
+  file_ = fopen(path.c_str(), "rb");
+  if (!file_) {
+    return false;
+  }
+  off_t file_size = -1;
+  if (fread(&header_, sizeof(header_), 1, file_) == 1 &&
+      fseeko(file_, 0, SEEK_END) == 0) {
+    file_size = ftello(file_);
+  }
+  file_size_ = static_cast<uint64_t>(file_size);
+  if (file_size < 0 ||
+      memcmp(header_.magic, kTrajectoryMagic, sizeof(header_.magic)) != 0 ||
+      header_.version != kTrajectoryVersion ||
+      header_.byte_order != kCheckpointByteOrder || !(header_.scale > 0) ||
+      !ReadIndex(static_cast<uint64_t>(file_size)) || !Seek(0)) {
+    Close();
+    errno = EINVAL;
+    return false;
+  }
+  return true;
+} /* Open() */
+
+void TrajectoryReader::Close() {
+  if (file_) {
+    fclose(file_);
+    file_ = nullptr;
+  }
+  index_.clear();
+  entities_.clear();
+  file_size_ = 0;
+  n_frames_ = 0;
+  step_ = 0;
+} /* Close() */
+
+bool TrajectoryReader::ReadIndex(uint64_t file_size) {
+  index_.clear();
+  TrajectoryTrailer trailer;
+  if (file_size >= sizeof(TrajectoryHeader) + sizeof(trailer) &&
+      fseeko(file_, static_cast<off_t>(file_size - sizeof(trailer)),
+             SEEK_SET) == 0 &&
+      fread(&trailer, sizeof(trailer), 1, file_) == 1 &&
+      memcmp(trailer.magic, kTrajectoryIndexMagic,
+             sizeof(trailer.magic)) == 0 &&
+      trailer.index_offset <= file_size - sizeof(trailer) &&
+      // Checked by division first, so a huge n_chunks cannot wrap around.
+      trailer.n_chunks <= (file_size - sizeof(trailer) - trailer.index_offset) /
+                              sizeof(TrajectoryIndexEntry) &&
+      trailer.index_offset +
+          trailer.n_chunks * sizeof(TrajectoryIndexEntry) +
+          sizeof(trailer) == file_size) {
+    index_.resize(trailer.n_chunks);
+    if (fseeko(file_, static_cast<off_t>(trailer.index_offset),
+               SEEK_SET) != 0 ||
+        fread(index_.data(), sizeof(TrajectoryIndexEntry), index_.size(),
+              file_) != index_.size()) {
+      return false;
+    }
+  } else {
+    // No index: the writer did not finish. Keep every complete chunk.
+    uint64_t offset = sizeof(TrajectoryHeader);
+    uint64_t step = 0;
+    TrajectoryChunk chunk;
+    while (offset + sizeof(chunk) <= file_size &&
+           fseeko(file_, static_cast<off_t>(offset), SEEK_SET) == 0 &&
+           fread(&chunk, sizeof(chunk), 1, file_) == 1 &&
+           chunk.first_step == step && chunk.n_frames > 0 &&
+           offset + sizeof(chunk) + chunk.size <= file_size) {
+      index_.push_back({step, offset});
+      offset += sizeof(chunk) + chunk.size;
+      step += chunk.n_frames;
+    }
+  }
+  if (index_.empty()) {
+    return false;
+  }
+  TrajectoryChunk last;
+  if (fseeko(file_, static_cast<off_t>(index_.back().offset), SEEK_SET) != 0 ||
+      fread(&last, sizeof(last), 1, file_) != 1) {
+    return false;
+  }
+  n_frames_ = last.first_step + last.n_frames;
+  return true;
+} /* ReadIndex() */
+
+bool TrajectoryReader::Seek(uint64_t step) {
+  if (!file_ || step >= n_frames_) {
+    errno = EINVAL;
+    return false;
+  }
+  auto after = std::upper_bound(
+    index_.begin(), index_.end(), step,
+    [](uint64_t s, const TrajectoryIndexEntry &entry) {
+      return s < entry.first_step;
+    });
+  if (!LoadChunk(static_cast<size_t>(after - index_.begin()) - 1)) {
+    return false;
+  }
+  while (step_ < step) {
+    if (!DecodeFrame(nullptr)) {
+      return false;
+    }
+  }
+  return true;
+} /* Seek() */
+
+bool TrajectoryReader::LoadChunk(size_t c) {
+  if (fseeko(file_, static_cast<off_t>(index_[c].offset), SEEK_SET) != 0 ||
+      fread(&chunk_header_, sizeof(chunk_header_), 1, file_) != 1 ||
+      chunk_header_.first_step != index_[c].first_step) {
+    return false;
+  }
+  // Never allocate more than the file could hold.
+  if (index_[c].offset > file_size_ - sizeof(chunk_header_) ||
+      chunk_header_.size >
+        file_size_ - sizeof(chunk_header_) - index_[c].offset) {
+    errno = EINVAL;
+    return false;
+  }
+  chunk_.resize(chunk_header_.size);
+  if (fread(chunk_.data(), 1, chunk_.size(), file_) != chunk_.size()) {
+    return false;
+  }
+  chunk_number_ = c;
+  position_ = 0;
+  frame_ = 0;
+  step_ = chunk_header_.first_step;
+
+  uint64_t n;
+  // Every entity takes at least nine bytes.
+  if (!GetVarint(chunk_, &position_, &n) || n > chunk_.size() / 9) {
+    return false;
+  }
+  entities_.resize(static_cast<size_t>(n));
+  for (TrajectoryEntity &ent : entities_) {
+    ent.dx = ent.dy = ent.dtheta = 0;
+    if (!GetInt(chunk_, &position_, &ent.type) ||
+        !GetInt(chunk_, &position_, &ent.id) ||
+        !GetInt(chunk_, &position_, &ent.color.r) ||
+        !GetInt(chunk_, &position_, &ent.color.g) ||
+        !GetInt(chunk_, &position_, &ent.color.b) ||
+        !GetSigned(chunk_, &position_, &ent.radius) ||
+        !GetSigned(chunk_, &position_, &ent.x) ||
+        !GetSigned(chunk_, &position_, &ent.y) ||
+        !GetSigned(chunk_, &position_, &ent.theta)) {
+      return false;
+    }
+  }
+  return true;
+} /* LoadChunk() */
+
+bool TrajectoryReader::DecodeFrame(std::vector<ArenaEvent> *events) {
+  if (frame_ >= chunk_header_.n_frames &&
+      (chunk_number_ + 1 >= index_.size() || !LoadChunk(chunk_number_ + 1))) {
+    return false;
+  }
+  uint64_t n_events;
+  if (!GetInt(chunk_, &position_, &game_status_) ||
+      !GetVarint(chunk_, &position_, &n_events)) {
+    return false;
+  }
+  int last_id = 0;
+  for (uint64_t e = 0; e < n_events; ++e) {
+    int type;
+    ArenaEvent event;
+    if (!GetInt(chunk_, &position_, &type) ||
+        !GetInt(chunk_, &position_, &event.id) ||
+        !GetInt(chunk_, &position_, &event.other)) {
+      return false;
+    }
+    event.type = static_cast<ArenaEventType>(type);
+    event.id += last_id;
+    event.other += RelativeTo(event);
+    last_id = event.id;
+    if (events) {
+      events->push_back(event);
+    }
+  }
+  if (frame_ > 0) {
+    for (TrajectoryEntity &ent : entities_) {
+      if (ent.type == kFood) {
+        continue;
+      }
+      int64_t ddx, ddy, ddtheta;
+      if (!GetSigned(chunk_, &position_, &ddx) ||
+          !GetSigned(chunk_, &position_, &ddy) ||
+          !GetSigned(chunk_, &position_, &ddtheta)) {
+        return false;
+      }
+      ent.dx += ddx;
+      ent.dy += ddy;
+      ent.dtheta += ddtheta;
+      ent.x += ent.dx;
+      ent.y += ent.dy;
+      ent.theta += ent.dtheta;
+    }
+  }
+  ++frame_;
+  ++step_;
+  return true;
+} /* DecodeFrame() */
+
+bool TrajectoryReader::Next(RenderSnapshot *snapshot,
+                            std::vector<ArenaEvent> *events) {
+  if (events) {
+    events->clear();
+  }
+  if (!file_ || step_ >= n_frames_ || !DecodeFrame(events)) {
+    return false;
+  }
+  double unit = 1.0 / header_.scale;
+  snapshot->entities.resize(entities_.size());
+  for (size_t i = 0; i < entities_.size(); ++i) {
+    const TrajectoryEntity &ent = entities_[i];
+    RenderEntity &out = snapshot->entities[i];
+    out.type = static_cast<EntityType>(ent.type);
+    out.id = ent.id;
+    out.x = ent.x * unit;
+    out.y = ent.y * unit;
+    out.radius = ent.radius * unit;
+    out.color = ent.color;
+    if (out.type == kRobot) {
+      // Where Robot::SensorLocation() puts them.
+      double theta = M_PI * (ent.theta * unit) / 180;
+      out.left_sensor_x = out.radius * cos(theta - 40 * M_PI / 180) + out.x;
+      out.left_sensor_y = out.radius * sin(theta - 40 * M_PI / 180) + out.y;
+      out.right_sensor_x = out.radius * cos(theta + 40 * M_PI / 180) + out.x;
+      out.right_sensor_y = out.radius * sin(theta + 40 * M_PI / 180) + out.y;
+    }
+  }
+  snapshot->x_dim = header_.x_dim;
+  snapshot->y_dim = header_.y_dim;
+  snapshot->game_status = game_status_;
+  return true;
+} /* Next() */
+
+NAMESPACE_END(csci3081);
@@ -0,0 +1,272 @@
+/**
+ * @file trajectory.h
+ *
+ * @copyright 2018 Nate Samuelson, All rights reserved.
+ */
+
+#ifndef SRC_TRAJECTORY_H_
+#define SRC_TRAJECTORY_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "src/arena_event.h"
+#include "src/checkpoint.h"
+#include "src/common.h"
+#include "src/entity_store.h"
+#include "src/params.h"
+#include "src/render_snapshot.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Constants
+ ******************************************************************************/
+const char kTrajectoryMagic[8] = {'A', 'R', 'E', 'N', 'A', 'T', 'R', 'J'};
+const char kTrajectoryIndexMagic[8] = {'T', 'R', 'J', 'I', 'N', 'D', 'E', 'X'};
+const uint32_t kTrajectoryVersion = 1;
+
+/*******************************************************************************
+ * Struct Definitions
+ ******************************************************************************/
+/*
+ * A trajectory file is a TrajectoryHeader, then a series of chunks, then an
+ * index of the chunks and a TrajectoryTrailer. The fixed-size parts are
+ * written in the byte order of the machine, like a checkpoint (and marked
+ * with kCheckpointByteOrder).
+ *
+ * A chunk is a TrajectoryChunk followed by `size` bytes holding `n_frames`
+ * consecutive timesteps. The first frame is a keyframe, giving every entity
+ * in full; the others only give, for each Robot and Light, how much its
+ * motion changed since the frame before (the second difference of its
+ * pose). Every number is an unsigned LEB128 varint (signed ones zigzag
+ * encoded first), and positions, radii and headings are fixed point (see
+ * TRAJECTORY_SCALE), so that steady motion takes about a byte per
+ * coordinate and the differences add up exactly. Event ids are likewise
+ * stored relative to the event before. A new chunk starts every
+ * keyframe_interval frames, and whenever an entity is added, removed or
+ * changes color or size.
+ *
+ * Keyframe:
+ *   n_entities, then per entity: type id r g b radius x y theta
+ * Every frame:
+ *   game_status n_events, then per event: type id other
+ * Every frame but the keyframe, after that:
+ *   per Robot and Light: ddx ddy ddtheta
+ *
+ * The index lets a reader start at any keyframe. A file whose writer never
+ * finished has no index; the reader rebuilds it by walking the chunks.
+ */
+struct TrajectoryHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t byte_order;
+  double x_dim;
+  double y_dim;
+  double scale;
+  uint32_t keyframe_interval;
+  uint32_t unused;
+};
+
+struct TrajectoryChunk {
+  uint64_t first_step;
+  uint32_t n_frames;
+  uint32_t size;
+};
+
+struct TrajectoryIndexEntry {
+  uint64_t first_step;
+  // Of the TrajectoryChunk, from the start of the file.
+  uint64_t offset;
+};
+
+struct TrajectoryTrailer {
+  uint64_t index_offset;
+  uint64_t n_chunks;
+  char magic[8];
+};
+
+/**
+ * @brief An entity as stored in a trajectory: fixed point pose and radius.
+ */
+struct TrajectoryEntity {
+  int type{kUndefined};
+  int id{0};
+  RgbColor color{};
+  int64_t radius{0};
+  int64_t x{0};
+  int64_t y{0};
+  int64_t theta{0};
+  // Change in x, y and theta over the last frame.
+  int64_t dx{0};
+  int64_t dy{0};
+  int64_t dtheta{0};
+};
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief Appends the state of an Arena, one timestep at a time, to a
+ * trajectory file (see TrajectoryHeader for the format).
+ *
+ * Frames are encoded into a buffer as they are added and the buffer is
+ * written out a chunk at a time, so memory use only depends on the number of
+ * entities and the keyframe interval, however long the recording.
+ *
+ * Functions return false on failure, with errno describing the problem.
+ */
+class TrajectoryWriter {
+ public:
+  TrajectoryWriter() : chunk_(), index_(), last_(), current_() {}
+  ~TrajectoryWriter() { Close(); }
+
+  TrajectoryWriter(const TrajectoryWriter &other) = delete;
+  TrajectoryWriter &operator=(const TrajectoryWriter &other) = delete;
+
+  /**
+   * @brief Start a new trajectory file at `path`, replacing any file there.
+   */
+  bool Open(const std::string &path, double x_dim, double y_dim,
+            int keyframe_interval = TRAJECTORY_KEYFRAME_INTERVAL);
+
+  /**
+   * @brief Append one timestep.
+   *
+   * @param[in] store The Arena's entities (Arena::get_store()).
+   * @param[in] game_status Arena::get_game_status().
+   * @param[in] events What happened during the timestep
+   * (Arena::get_events()).
+   */
+  bool AddFrame(const EntityStore &store, int game_status,
+                const std::vector<ArenaEvent> &events);
+
+  /**
+   * @brief Write out the last chunk and the index, and close the file.
+   */
+  bool Close();
+
+  uint64_t get_n_frames() const { return n_frames_; }
+
+  /**
+   * @brief Bytes written to the file so far.
+   */
+  uint64_t get_size() const { return offset_; }
+
+ private:
+  /**
+   * @brief Write the chunk being built, if any, and add it to the index.
+   */
+  bool FlushChunk();
+
+  FILE *file_{nullptr};
+  double scale_{TRAJECTORY_SCALE};
+  uint32_t keyframe_interval_{TRAJECTORY_KEYFRAME_INTERVAL};
+  // The chunk being built.
+  TrajectoryChunk chunk_header_{};
+  std::vector<uint8_t> chunk_;
+  std::vector<TrajectoryIndexEntry> index_;
+  // Every entity as of the last frame added, and as of the frame being
+  // added.
+  std::vector<TrajectoryEntity> last_;
+  std::vector<TrajectoryEntity> current_;
+  uint64_t n_frames_{0};
+  uint64_t offset_{0};
+};
+
+/**
+ * @brief Reads back a file written by TrajectoryWriter, one timestep at a
+ * time, as the RenderSnapshots the viewer draws.
+ *
+ * Only the chunk being read is held in memory, so a recording of any length
+ * can be streamed.
+ */
+class TrajectoryReader {
+ public:
+  TrajectoryReader() : index_(), chunk_(), entities_() {}
+  ~TrajectoryReader() { Close(); }
+
+  TrajectoryReader(const TrajectoryReader &other) = delete;
+  TrajectoryReader &operator=(const TrajectoryReader &other) = delete;
+
+  /**
+   * @brief Open the trajectory at `path` and position it at its first frame.
+   *
+   * @return false, with errno set, if the file cannot be read or is not a
+   * trajectory written by this version of the simulation.
+   */
+  bool Open(const std::string &path);
+
+  void Close();
+
+  /**
+   * @brief Position the reader so that Next() returns timestep `step`,
+   * decoding from the keyframe before it.
+   */
+  bool Seek(uint64_t step);
+
+  /**
+   * @brief Decode the next timestep.
+   *
+   * @param[out] snapshot The entities, with the sensor positions of Robots
+   * worked out from their pose, and the game status.
+   * @param[out] events What happened during the timestep (may be nullptr).
+   *
+   * @return false at the end of the trajectory or if it is damaged.
+   */
+  bool Next(RenderSnapshot *snapshot, std::vector<ArenaEvent> *events);
+
+  /**
+   * @brief The timestep the next call to Next() returns.
+   */
+  uint64_t get_step() const { return step_; }
+  uint64_t get_n_frames() const { return n_frames_; }
+  double get_x_dim() const { return header_.x_dim; }
+  double get_y_dim() const { return header_.y_dim; }
+
+ private:
+  /**
+   * @brief Read the index from the end of the file, or failing that by
+   * walking the chunks.
+   */
+  bool ReadIndex(uint64_t file_size);
+
+  /**
+   * @brief Read chunk `c` and decode its keyframe.
+   */
+  bool LoadChunk(size_t c);
+
+  /**
+   * @brief Decode the next timestep into entities_ and game_status_,
+   * moving on to the next chunk if needed.
+   */
+  bool DecodeFrame(std::vector<ArenaEvent> *events);
+
+  FILE *file_{nullptr};
+  uint64_t file_size_{0};
+  TrajectoryHeader header_{};
+  std::vector<TrajectoryIndexEntry> index_;
+  uint64_t n_frames_{0};
+  // The chunk being read, and the position of the next frame in it.
+  TrajectoryChunk chunk_header_{};
+  std::vector<uint8_t> chunk_;
+  size_t chunk_number_{0};
+  size_t position_{0};
+  uint32_t frame_{0};
+  uint64_t step_{0};
+  int game_status_{PAUSED};
+  // Every entity as of the last frame read.
+  std::vector<TrajectoryEntity> entities_;
+};
+
+NAMESPACE_END(csci3081);
+
+#endif  // SRC_TRAJECTORY_H_
@@ -0,0 +1,105 @@
+/**
+ * @file work_stealing_pool.cc
+ *
+ * @copyright 2018 Nate Samuelson, All rights reserved.
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <algorithm>
+#include <thread>
+
+#include "src/work_stealing_pool.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Constructors/Destructor
+ ******************************************************************************/
+WorkStealingPool::WorkStealingPool(size_t n_threads)
+    : n_threads_(n_threads ? n_threads
+                           : std::max(std::thread::hardware_concurrency(), 1u)),
+      shares_(n_threads_) {}
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+void WorkStealingPool::Run(size_t n_tasks, const Body &body) {
+  for (size_t t = 0; t < n_threads_; ++t) {
+    shares_[t].begin = n_tasks * t / n_threads_;
+    shares_[t].end = n_tasks * (t + 1) / n_threads_;
+  }
+  std::vector<std::thread> workers;
+  for (size_t t = 1; t < n_threads_; ++t) {
+    workers.emplace_back(&WorkStealingPool::WorkerMain, this, t,
+                         std::cref(body));
+  }
+  WorkerMain(0, body);
+  for (auto &worker : workers) {
+    worker.join();
+  }
+} /* Run() */
+
+void WorkStealingPool::WorkerMain(size_t thread, const Body &body) {
+  Share &own = shares_[thread];
+  for (;;) {
+    bool found = false;
+    size_t task = 0;
+    {
+      std::lock_guard<std::mutex> lock(own.mutex);
+      if (own.begin < own.end) {
+        task = own.begin++;
+        found = true;
+      }
+    }
+    if (found) {
+      body(task, thread);
+    } else if (!Steal(thread)) {
+      return;
+    }
+  }
+} /* WorkerMain() */
+
+bool WorkStealingPool::Steal(size_t thread) {
+  // Shares only ever shrink, so a victim that looked largest is usually
+  // still worth taking from; if not, look again.
+  for (;;) {
+    size_t victim = thread;
+    size_t largest = 0;
+    for (size_t t = 0; t < n_threads_; ++t) {
+      if (t == thread) { continue; }
+      std::lock_guard<std::mutex> lock(shares_[t].mutex);
+      size_t left = shares_[t].end - shares_[t].begin;
+      if (left > largest) {
+        largest = left;
+        victim = t;
+      }
+    }
+    if (victim == thread) {
+      return false;
+    }
+    size_t begin, end;
+    {
+      std::lock_guard<std::mutex> lock(shares_[victim].mutex);
+      Share &share = shares_[victim];
+      if (share.begin >= share.end) {
+        continue;
+      }
+      // The victim keeps the first half, rounded down: a last task waiting
+      // behind a long one is better started by the idle thread.
+      begin = share.begin + (share.end - share.begin) / 2;
+      end = share.end;
+      share.end = begin;
+    }
+    std::lock_guard<std::mutex> lock(shares_[thread].mutex);
+    shares_[thread].begin = begin;
+    shares_[thread].end = end;
+    return true;
+  }
+} /* Steal() */
+
+NAMESPACE_END(csci3081);
@@ -0,0 +1,91 @@
+/**
+ * @file work_stealing_pool.h
+ *
+ * @copyright 2018 Nate Samuelson, All rights reserved.
+ */
+
+#ifndef SRC_WORK_STEALING_POOL_H_
+#define SRC_WORK_STEALING_POOL_H_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include "src/common.h"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NAMESPACE_BEGIN(csci3081);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief Runs a set of independent tasks of very different lengths (e.g. one
+ * simulation each) on a fixed number of threads.
+ *
+ * Each thread starts with an equal, contiguous share of the task indices and
+ * works through it in order. A thread that runs out steals the second half
+ * of the largest share left (rounded up), so threads stay busy until the
+ * very end however uneven the tasks are, and only touch each other's shares
+ * (under a lock) when stealing.
+ *
+ * Unlike ThreadPool, which splits one loop of short iterations the same way
+ * every time, which thread runs which task depends on timing.
+ */
+class WorkStealingPool {
+ public:
+  /**
+   * @brief A task. Called with the index of the task, in [0, n_tasks), and
+   * of the thread running it, in [0, get_n_threads()).
+   */
+  using Body = std::function<void(size_t task, size_t thread)>;
+
+  /**
+   * @brief Constructor.
+   *
+   * @param[in] n_threads Total number of threads, including the caller.
+   * Zero means one per core.
+   */
+  explicit WorkStealingPool(size_t n_threads);
+
+  /**
+   * @brief Run every task once and wait until all are done.
+   */
+  void Run(size_t n_tasks, const Body &body);
+
+  size_t get_n_threads() const { return n_threads_; }
+
+ private:
+  // The tasks [begin, end) a thread has yet to start.
+  struct Share {
+    std::mutex mutex{};
+    size_t begin{0};
+    size_t end{0};
+    // Keeps shares on separate cache lines.
+    char padding[64];
+  };
+
+  /**
+   * @brief Run tasks until there are none left to take or steal.
+   */
+  void WorkerMain(size_t thread, const Body &body);
+
+  /**
+   * @brief Move half of the largest other share into `thread`'s share.
+   *
+   * @return false if every share is empty.
+   */
+  bool Steal(size_t thread);
+
+  size_t n_threads_;
+  std::vector<Share> shares_;
+};
+
+NAMESPACE_END(csci3081);
+
+#endif  // SRC_WORK_STEALING_POOL_H_
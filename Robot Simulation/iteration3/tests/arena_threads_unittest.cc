@@ -0,0 +1,95 @@
+// Google Test Framework
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+
+// Project code from the ../src directory
+#include "../src/arena.h"
+#include "../src/arena_params.h"
+
+#ifdef ARENA_THREADS_TEST
+
+/************************************************************************
+* SETUP
+*************************************************************************/
+class ArenaThreadsTest : public ::testing::Test {
+ protected:
+  // A crowded seeded arena stepped on `n_threads` threads, with the events
+  // of every step appended to `events`.
+  std::unique_ptr<csci3081::Arena> Run(size_t n_threads,
+                                       std::vector<csci3081::ArenaEvent>
+                                         *events) {
+    params.n_threads = n_threads;
+    std::unique_ptr<csci3081::Arena> arena(new csci3081::Arena(&params));
+    arena->AddRobot(40, csci3081::kCoward);
+    arena->AddRobot(40, csci3081::kExplore);
+    arena->AddRobot(20, csci3081::kAggressive);
+    arena->AddRobot(20, csci3081::kLove);
+    arena->AddLight(6);
+    arena->AddFood(4);
+    arena->AcceptCommand(csci3081::kFoodOn);
+    arena->AcceptCommand(csci3081::kPlay);
+    arena->set_record_events(true);
+    for (int step = 0; step < 300; ++step) {
+      arena->AdvanceTime(1);
+      const std::vector<csci3081::ArenaEvent> &step_events =
+        arena->get_events();
+      events->insert(events->end(), step_events.begin(), step_events.end());
+      arena->ClearEvents();
+    }
+    return arena;
+  }
+
+  // Runs on 1 and 4 threads end in exactly the same state.
+  void ExpectSameOnAnyThreads() {
+    std::vector<csci3081::ArenaEvent> events1, events4;
+    auto arena1 = Run(1, &events1);
+    auto arena4 = Run(4, &events4);
+    const csci3081::EntityStore &a = arena1->get_store();
+    const csci3081::EntityStore &b = arena4->get_store();
+    ASSERT_EQ(a.size(), b.size());
+    EXPECT_EQ(a.type, b.type);
+    EXPECT_EQ(a.x, b.x) << "FAIL: Positions depend on the thread count.";
+    EXPECT_EQ(a.y, b.y) << "FAIL: Positions depend on the thread count.";
+    EXPECT_EQ(a.theta, b.theta);
+    EXPECT_EQ(a.radius, b.radius);
+    EXPECT_EQ(a.vel_left, b.vel_left);
+    EXPECT_EQ(a.vel_right, b.vel_right);
+    EXPECT_EQ(a.hunger, b.hunger);
+    EXPECT_EQ(a.starved, b.starved);
+    EXPECT_EQ(a.hunger_level, b.hunger_level);
+    EXPECT_EQ(a.left_sensor_x, b.left_sensor_x);
+    EXPECT_EQ(a.left_sensor_y, b.left_sensor_y);
+    EXPECT_EQ(a.right_sensor_x, b.right_sensor_x);
+    EXPECT_EQ(a.right_sensor_y, b.right_sensor_y);
+    EXPECT_EQ(arena1->get_game_status(), arena4->get_game_status());
+
+    ASSERT_EQ(events1.size(), events4.size())
+      << "FAIL: Events depend on the thread count.";
+    EXPECT_GT(events1.size(), 0u);
+    for (size_t i = 0; i < events1.size(); ++i) {
+      EXPECT_EQ(events1[i].type, events4[i].type) << "event " << i;
+      EXPECT_EQ(events1[i].id, events4[i].id) << "event " << i;
+      EXPECT_EQ(events1[i].other, events4[i].other) << "event " << i;
+    }
+  }
+
+  csci3081::arena_params params;
+};
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+TEST_F(ArenaThreadsTest, SameOnAnyThreads) {
+  params.seed = 7;
+  ExpectSameOnAnyThreads();
+};
+
+// The same with sensors sampled from intensity fields.
+TEST_F(ArenaThreadsTest, SameOnAnyThreadsWithFields) {
+  params.seed = 8;
+  params.field_resolution = 16;
+  ExpectSameOnAnyThreads();
+};
+
+#endif /* ARENA_THREADS_TEST */
@@ -0,0 +1,114 @@
+// Google Test Framework
+#include <gtest/gtest.h>
+#include <unistd.h>
+#include <cstdio>
+#include <string>
+
+// Project code from the ../src directory
+#include "../src/arena.h"
+#include "../src/arena_params.h"
+#include "../src/checkpoint.h"
+
+#ifdef CHECKPOINT_TEST
+
+/************************************************************************
+* SETUP
+*************************************************************************/
+class CheckpointTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    params.n_threads = 2;
+    params.seed = 7;
+    path = "checkpoint_test_" + std::to_string(getpid()) + ".ckp";
+  }
+  virtual void TearDown() { std::remove(path.c_str()); }
+
+  // A game in progress, with robots avoiding, hungry and eating.
+  void Populate(csci3081::Arena *arena) {
+    arena->set_light_sensitivity(1.5);
+    arena->AddRobot(10, csci3081::kCoward);
+    arena->AddRobot(10, csci3081::kExplore);
+    arena->AddLight(5);
+    arena->AddFood(5);
+    arena->AcceptCommand(csci3081::kFoodOn);
+    arena->AcceptCommand(csci3081::kPlay);
+    arena->AdvanceTime(600);
+  }
+
+  csci3081::arena_params params;
+  std::string path;
+};
+
+// Every entity of `a` is where, and as big, as the same entity of `b`.
+static void ExpectSameEntities(const csci3081::Arena &a,
+                               const csci3081::Arena &b) {
+  const csci3081::EntityStore &sa = a.get_store();
+  const csci3081::EntityStore &sb = b.get_store();
+  ASSERT_EQ(sa.size(), sb.size());
+  for (size_t i = 0; i < sa.size(); ++i) {
+    EXPECT_EQ(sa.type[i], sb.type[i]);
+    EXPECT_EQ(sa.entity[i]->get_id(), sb.entity[i]->get_id());
+    EXPECT_DOUBLE_EQ(sa.x[i], sb.x[i]);
+    EXPECT_DOUBLE_EQ(sa.y[i], sb.y[i]);
+    EXPECT_DOUBLE_EQ(sa.theta[i], sb.theta[i]);
+    EXPECT_DOUBLE_EQ(sa.radius[i], sb.radius[i]);
+    EXPECT_DOUBLE_EQ(sa.hunger_level[i], sb.hunger_level[i]);
+  }
+}
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+// A restored arena steps exactly like the one that was saved.
+TEST_F(CheckpointTest, RoundTrip) {
+  csci3081::Arena saved(&params);
+  Populate(&saved);
+  ASSERT_TRUE(saved.SaveCheckpoint(path))
+    << "FAIL: RoundTrip - Could not save the checkpoint.";
+
+  params.seed = 99;
+  csci3081::Arena restored(&params);
+  restored.AddRobot(3, csci3081::kCoward);
+  ASSERT_TRUE(restored.LoadCheckpoint(path))
+    << "FAIL: RoundTrip - Could not load the checkpoint.";
+  EXPECT_EQ(restored.get_seed(), saved.get_seed());
+  EXPECT_EQ(restored.get_game_status(), saved.get_game_status());
+  ExpectSameEntities(saved, restored);
+
+  saved.AdvanceTime(600);
+  restored.AdvanceTime(600);
+  ExpectSameEntities(saved, restored);
+
+  // The generator and the ids carry on too.
+  saved.AddFood(1);
+  restored.AddFood(1);
+  ExpectSameEntities(saved, restored);
+};
+
+TEST_F(CheckpointTest, RejectsBadFiles) {
+  csci3081::Arena arena(&params);
+  Populate(&arena);
+  size_t n = arena.get_store().size();
+  EXPECT_FALSE(arena.LoadCheckpoint(path))
+    << "FAIL: RejectsBadFiles - Loaded a missing file.";
+
+  ASSERT_TRUE(arena.SaveCheckpoint(path));
+  // Cut off the last entity.
+  ASSERT_EQ(truncate(path.c_str(), sizeof(csci3081::CheckpointHeader) +
+                     (n - 1) * sizeof(csci3081::CheckpointEntity)), 0);
+  EXPECT_FALSE(arena.LoadCheckpoint(path))
+    << "FAIL: RejectsBadFiles - Loaded a truncated file.";
+  EXPECT_EQ(arena.get_store().size(), n)
+    << "FAIL: RejectsBadFiles - A failed load changed the arena.";
+
+  FILE *file = fopen(path.c_str(), "w");
+  ASSERT_NE(file, nullptr);
+  fputs("not a checkpoint, but long enough to hold a header ............"
+        "................................................................",
+        file);
+  fclose(file);
+  EXPECT_FALSE(arena.LoadCheckpoint(path))
+    << "FAIL: RejectsBadFiles - Loaded a file without the magic number.";
+};
+
+#endif /* CHECKPOINT_TEST */
@@ -0,0 +1,127 @@
+// Google Test Framework
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <vector>
+
+// Project code from the ../src directory
+#include "../src/arena.h"
+#include "../src/arena_params.h"
+#include "../src/robot.h"
+
+#ifdef FOOD_GRID_TEST
+
+/************************************************************************
+* SETUP
+*************************************************************************/
+// Robots of radius 10 and food of radius 20 capture within 10 + 20 + 5 = 35,
+// which is also the size of the food grid's cells.
+class FoodGridTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    params.n_threads = 2;
+    arena = new csci3081::Arena(&params);
+    arena->AddRobot(3, csci3081::kCoward);
+    arena->AddFood(3);
+    const csci3081::EntityStore &store = arena->get_store();
+    for (size_t i = 0; i < store.size(); ++i) {
+      if (store.type[i] == csci3081::kRobot) {
+        robots.push_back(store.entity[i]);
+        store.entity[i]->set_radius(10);
+      } else if (store.type[i] == csci3081::kFood) {
+        foods.push_back(store.entity[i]);
+        store.entity[i]->set_radius(20);
+      }
+    }
+  }
+  virtual void TearDown() { delete arena; }
+
+  // The ids of the robots that captured food in one UpdateHunger(), i.e.
+  // whose hunger it reset.
+  std::vector<int> Captures() {
+    const csci3081::EntityStore &store = arena->get_store();
+    for (size_t i = 0; i < store.size(); ++i) {
+      if (store.type[i] == csci3081::kRobot) {
+        MakeHungry(static_cast<csci3081::Robot *>(store.entity[i]));
+      }
+    }
+    arena->UpdateHunger();
+    std::vector<int> captures;
+    for (size_t i = 0; i < store.size(); ++i) {
+      if (store.type[i] == csci3081::kRobot && store.hunger_level[i] <= 0) {
+        captures.push_back(store.entity[i]->get_id());
+      }
+    }
+    std::sort(captures.begin(), captures.end());
+    return captures;
+  }
+
+  // Runs the robot's hunger timer out, leaving it where it was.
+  void MakeHungry(csci3081::Robot *robot) {
+    csci3081::Pose pose = robot->get_pose();
+    while (robot->get_hunger_level() <= 0) {
+      robot->TimestepUpdate(1);
+    }
+    robot->set_pose(pose);
+  }
+
+  csci3081::arena_params params;
+  csci3081::Arena *arena{nullptr};
+  std::vector<csci3081::ArenaEntity *> robots;
+  std::vector<csci3081::ArenaEntity *> foods;
+};
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+// Food just inside the reach is captured, and food just outside is not, with
+// the robot in the next cell of the grid.
+TEST_F(FoodGridTest, ReachAcrossCellBorder) {
+  ASSERT_EQ(robots.size(), 3u);
+  ASSERT_EQ(foods.size(), 3u);
+  foods[0]->set_position(69, 200);
+  robots[0]->set_position(69 + 34.9, 200);
+  foods[1]->set_position(349, 400);
+  robots[1]->set_position(349 + 35.1, 400);
+  foods[2]->set_position(600, 100);
+  robots[2]->set_position(600, 100 + 34.9);
+  arena->FoodMoved();
+  std::vector<int> expected = {robots[0]->get_id(), robots[2]->get_id()};
+  std::sort(expected.begin(), expected.end());
+  EXPECT_EQ(Captures(), expected)
+    << "FAIL: ReachAcrossCellBorder - Wrong food captured.";
+};
+
+// A robot that grows after the grid was built gets larger cells, so it still
+// finds food more than a cell of the old grid away.
+TEST_F(FoodGridTest, RebuildForLargerRobot) {
+  foods[0]->set_position(629, 600);
+  robots[0]->set_position(900, 100);
+  robots[1]->set_position(900, 300);
+  robots[2]->set_position(900, 500);
+  foods[1]->set_position(100, 100);
+  foods[2]->set_position(100, 400);
+  arena->FoodMoved();
+  EXPECT_TRUE(Captures().empty());
+
+  // Two cells of the old grid away, but within 40 + 20 + 5 = 65.
+  robots[0]->set_radius(40);
+  robots[0]->set_position(629 + 60, 600);
+  std::vector<int> expected = {robots[0]->get_id()};
+  EXPECT_EQ(Captures(), expected)
+    << "FAIL: RebuildForLargerRobot - The grid kept cells too small.";
+
+  // Adding a robot rebuilds the grid too.
+  robots[0]->set_radius(10);
+  robots[0]->set_position(900, 100);
+  arena->AddRobot(1, csci3081::kExplore);
+  const csci3081::EntityStore &store = arena->get_store();
+  csci3081::ArenaEntity *added = store.entity[store.size() - 1];
+  ASSERT_EQ(store.type[store.size() - 1], csci3081::kRobot);
+  added->set_radius(45);
+  added->set_position(100 + 69, 400);
+  expected = {added->get_id()};
+  EXPECT_EQ(Captures(), expected)
+    << "FAIL: RebuildForLargerRobot - Missed food for an added robot.";
+};
+
+#endif /* FOOD_GRID_TEST */
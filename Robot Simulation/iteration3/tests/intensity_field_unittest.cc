@@ -0,0 +1,70 @@
+// Google Test Framework
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <vector>
+
+// Project code from the ../src directory
+#include "../src/intensity_field.h"
+#include "../src/sensor_kernel.h"
+
+#ifdef INTENSITY_FIELD_TEST
+
+/************************************************************************
+* SETUP
+*************************************************************************/
+
+class IntensityFieldTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    field.Resize(1024, 768, 8);
+    field.Compute(0, field.size(), source_x.data(), source_y.data(),
+                  source_x.size());
+  }
+  // The exact reading of a sensor with unit gain at (x, y).
+  double Exact(double x, double y) {
+    double gain = 1e-3;
+    double reading = 0;
+    csci3081::AccumulateSensorReadings(&x, &y, &gain, 1, source_x.data(),
+      source_y.data(), source_x.size(), &reading);
+    return reading / gain;
+  }
+  csci3081::IntensityField field;
+  std::vector<double> source_x = {100, 300, 650, 1000, 512};
+  std::vector<double> source_y = {80, 500, 120, 760, 384};
+};
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+// Nodes hold the exact value.
+TEST_F(IntensityFieldTest, ExactAtNodes) {
+  for (double x = 0; x <= 1024; x += 64) {
+    for (double y = 0; y <= 768; y += 64) {
+      EXPECT_NEAR(field.Sample(x, y), Exact(x, y), 1e-9 * Exact(x, y))
+        << "FAIL: ExactAtNodes - Node (" << x << ", " << y << ") differs.";
+    }
+  }
+};
+
+// Between nodes a sensor's reading is within a percent of the exact one.
+// Right on top of a source the error is larger, but the reading saturates.
+TEST_F(IntensityFieldTest, CloseBetweenNodes) {
+  for (double x = 3.3; x < 1024; x += 37.1) {
+    for (double y = 5.7; y < 768; y += 29.3) {
+      double exact = std::min(1000.0, 2000 * Exact(x, y));
+      EXPECT_NEAR(std::min(1000.0, 2000 * field.Sample(x, y)), exact,
+                  0.01 * exact)
+        << "FAIL: CloseBetweenNodes - (" << x << ", " << y << ") too far.";
+    }
+  }
+};
+
+// Positions outside of the Arena read the border.
+TEST_F(IntensityFieldTest, ClampedOutside) {
+  EXPECT_DOUBLE_EQ(field.Sample(-50, 100), field.Sample(0, 100))
+    << "FAIL: ClampedOutside - Left of the Arena.";
+  EXPECT_DOUBLE_EQ(field.Sample(2000, 900), field.Sample(1024, 768))
+    << "FAIL: ClampedOutside - Past the far corner.";
+};
+
+#endif
@@ -0,0 +1,116 @@
+// Google Test Framework
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+
+// Project code from the ../src directory
+#include "../src/kinematics_kernel.h"
+#include "../src/pose.h"
+
+#ifdef KINEMATICS_KERNEL_TEST
+
+/************************************************************************
+* SETUP
+*************************************************************************/
+
+class KinematicsKernelTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    // Headings well past a full turn, and a mix of straight (equal wheels),
+    // turning and stopped entities.
+    for (int i = 0; i < 23; ++i) {
+      x.push_back(10.0 * i);
+      y.push_back(500 - 7.0 * i);
+      theta.push_back(-1500 + 131.7 * i);
+      vel_left.push_back((i % 4) * 1.5);
+      vel_right.push_back((i % 3) * 1.5);
+    }
+  }
+
+  // The pose update as MotionBehaviorDifferential::UpdatePose() originally
+  // computed it, from the ICC.
+  static csci3081::Pose Reference(csci3081::Pose pose, double left,
+                                  double right, double dt) {
+    double heading = csci3081::deg2rad(pose.theta);
+    if (std::fabs(left - right) > 0) {
+      double omega = (left - right) / 0.5;
+      double icc_radius = 0.5 * (left + right) / (left - right);
+      double icc_x = pose.x - icc_radius * std::sin(heading);
+      double icc_y = pose.y + icc_radius * std::cos(heading);
+      return csci3081::Pose(
+        (pose.x - icc_x) * std::cos(omega * dt) -
+        (pose.y - icc_y) * std::sin(omega * dt) + icc_x,
+        (pose.x - icc_x) * std::sin(omega * dt) +
+        (pose.y - icc_y) * std::cos(omega * dt) + icc_y,
+        pose.theta + omega * dt);
+    }
+    return csci3081::Pose(pose.x + std::cos(heading) * left * dt,
+                          pose.y + std::sin(heading) * left * dt,
+                          pose.theta);
+  }
+
+  std::vector<double> x;
+  std::vector<double> y;
+  std::vector<double> theta;
+  std::vector<double> vel_left;
+  std::vector<double> vel_right;
+};
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+TEST_F(KinematicsKernelTest, SinCos) {
+  for (double a = -5000; a < 5000; a += 0.731) {
+    double sine, cosine;
+    csci3081::KinematicsKernelSinCos(a, &sine, &cosine);
+    EXPECT_NEAR(sine, std::sin(a), 3e-16)
+      << "FAIL: SinCos - Approximation too far from sin(" << a << ").";
+    EXPECT_NEAR(cosine, std::cos(a), 3e-16)
+      << "FAIL: SinCos - Approximation too far from cos(" << a << ").";
+  }
+};
+
+// The batched update must match the ICC model it replaced.
+TEST_F(KinematicsKernelTest, MatchesDifferentialModel) {
+  std::vector<double> x0 = x, y0 = y, theta0 = theta;
+  csci3081::IntegrateDifferentialDrive(x.data(), y.data(), theta.data(),
+    vel_left.data(), vel_right.data(), x.size(), 1);
+  for (size_t i = 0; i < x.size(); ++i) {
+    csci3081::Pose expected = Reference(
+      csci3081::Pose(x0[i], y0[i], theta0[i]), vel_left[i], vel_right[i], 1);
+    EXPECT_NEAR(x[i], expected.x, 1e-10)
+      << "FAIL: MatchesDifferentialModel - Entity " << i << " x differs.";
+    EXPECT_NEAR(y[i], expected.y, 1e-10)
+      << "FAIL: MatchesDifferentialModel - Entity " << i << " y differs.";
+    EXPECT_DOUBLE_EQ(theta[i], expected.theta)
+      << "FAIL: MatchesDifferentialModel - Entity " << i << " heading differs.";
+  }
+};
+
+// Vector and scalar paths round identically, so an entity ends up in the
+// same place whichever lane (or batch) it was in.
+TEST_F(KinematicsKernelTest, SameInAnyBatch) {
+  std::vector<double> x1 = x, y1 = y, theta1 = theta;
+  csci3081::IntegrateDifferentialDrive(x.data(), y.data(), theta.data(),
+    vel_left.data(), vel_right.data(), x.size(), 1);
+  for (size_t i = 0; i < x.size(); ++i) {
+    csci3081::IntegrateDifferentialDrive(&x1[i], &y1[i], &theta1[i],
+      &vel_left[i], &vel_right[i], 1, 1);
+    EXPECT_EQ(x[i], x1[i]) << "FAIL: SameInAnyBatch - Entity " << i;
+    EXPECT_EQ(y[i], y1[i]) << "FAIL: SameInAnyBatch - Entity " << i;
+    EXPECT_EQ(theta[i], theta1[i]) << "FAIL: SameInAnyBatch - Entity " << i;
+  }
+};
+
+// Zero wheel velocities leave the pose exactly as it was.
+TEST_F(KinematicsKernelTest, Stopped) {
+  std::vector<double> x0 = x, y0 = y, theta0 = theta;
+  std::vector<double> zero(x.size(), 0);
+  csci3081::IntegrateDifferentialDrive(x.data(), y.data(), theta.data(),
+    zero.data(), zero.data(), x.size(), 1);
+  EXPECT_EQ(x, x0) << "FAIL: Stopped - Entities moved.";
+  EXPECT_EQ(y, y0) << "FAIL: Stopped - Entities moved.";
+  EXPECT_EQ(theta, theta0) << "FAIL: Stopped - Entities turned.";
+};
+
+#endif /* KINEMATICS_KERNEL_TEST */
@@ -0,0 +1,53 @@
+// Google Test Framework
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+
+// Project code from the ../src directory
+#include "../src/phase_profiler.h"
+
+#ifdef PHASE_PROFILER_TEST
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+TEST(PhaseProfilerTest, Percentiles) {
+  csci3081::PhaseProfiler profiler(100);
+  EXPECT_EQ(profiler.Stats(csci3081::kPhaseSensors).samples, 0u);
+
+  // Recorded out of order: 1..100
+  for (int i = 0; i < 100; ++i) {
+    profiler.Record(csci3081::kPhaseSensors, (i * 37) % 100 + 1);
+  }
+  csci3081::PhaseStats stats = profiler.Stats(csci3081::kPhaseSensors);
+  EXPECT_EQ(stats.samples, 100u);
+  EXPECT_DOUBLE_EQ(stats.p50, 50);
+  EXPECT_DOUBLE_EQ(stats.p99, 99);
+  EXPECT_DOUBLE_EQ(stats.max, 100);
+
+  // Other phases are unaffected
+  EXPECT_EQ(profiler.Stats(csci3081::kPhaseHunger).samples, 0u);
+}
+
+TEST(PhaseProfilerTest, RollingWindow) {
+  csci3081::PhaseProfiler profiler(4);
+  profiler.Record(csci3081::kPhaseStep, 1000);
+  for (int i = 1; i <= 4; ++i) {
+    profiler.Record(csci3081::kPhaseStep, i);
+  }
+  // The 1000 has been pushed out of the window
+  csci3081::PhaseStats stats = profiler.Stats(csci3081::kPhaseStep);
+  EXPECT_EQ(stats.samples, 4u);
+  EXPECT_DOUBLE_EQ(stats.p50, 2);
+  EXPECT_DOUBLE_EQ(stats.max, 4);
+
+  profiler.Clear();
+  EXPECT_EQ(profiler.Stats(csci3081::kPhaseStep).samples, 0u);
+
+  std::ostringstream csv;
+  profiler.WriteCsv(csv);
+  EXPECT_EQ(csv.str().substr(0, csv.str().find('\n')),
+            "phase,samples,p50_us,p99_us,max_us");
+}
+
+#endif
@@ -0,0 +1,100 @@
+// Google Test Framework
+#include <gtest/gtest.h>
+#include <thread>
+
+// Project code from the ../src directory
+#include "../src/arena.h"
+#include "../src/arena_params.h"
+#include "../src/render_snapshot.h"
+
+#ifdef RENDER_SNAPSHOT_TEST
+
+/************************************************************************
+* SETUP
+*************************************************************************/
+// A snapshot whose entities all carry `version`, so a torn read shows.
+static void Fill(csci3081::RenderSnapshot *snapshot, int version) {
+  snapshot->entities.resize(1 + version % 7);
+  for (auto &entity : snapshot->entities) {
+    entity.id = version;
+  }
+  snapshot->game_status = version;
+}
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+TEST(RenderSnapshotTest, LatestPublished) {
+  csci3081::RenderSnapshotBuffer buffer;
+  Fill(buffer.back(), 1);
+  buffer.Publish();
+  Fill(buffer.back(), 2);
+  EXPECT_EQ(buffer.Latest().game_status, 1)
+    << "FAIL: LatestPublished - Saw a snapshot before it was published.";
+  buffer.Publish();
+  Fill(buffer.back(), 3);
+  buffer.Publish();
+  EXPECT_EQ(buffer.Latest().game_status, 3)
+    << "FAIL: LatestPublished - Did not get the newest snapshot.";
+  EXPECT_EQ(buffer.Latest().game_status, 3)
+    << "FAIL: LatestPublished - Snapshot changed without a Publish().";
+};
+
+// The reader only ever sees whole snapshots, in order.
+TEST(RenderSnapshotTest, Concurrent) {
+  csci3081::RenderSnapshotBuffer buffer;
+  const int kVersions = 100000;
+  Fill(buffer.back(), 0);
+  buffer.Publish();
+  std::thread writer([&buffer, kVersions]() {
+    for (int v = 1; v <= kVersions; ++v) {
+      Fill(buffer.back(), v);
+      buffer.Publish();
+    }
+  });
+  int last = 0;
+  while (last < kVersions) {
+    const csci3081::RenderSnapshot &snapshot = buffer.Latest();
+    int version = snapshot.game_status;
+    ASSERT_GE(version, last) << "FAIL: Concurrent - Went back in time.";
+    ASSERT_EQ(snapshot.entities.size(), 1u + version % 7)
+      << "FAIL: Concurrent - Torn snapshot.";
+    for (auto &entity : snapshot.entities) {
+      ASSERT_EQ(entity.id, version) << "FAIL: Concurrent - Torn snapshot.";
+    }
+    last = version;
+  }
+  writer.join();
+};
+
+TEST(RenderSnapshotTest, FillSnapshot) {
+  csci3081::arena_params aparams;
+  aparams.seed = 1;
+  csci3081::Arena arena(&aparams);
+  arena.AddRobot(3, csci3081::kExplore);
+  arena.AddLight(2);
+  arena.AddFood(1);
+  arena.set_game_status(PLAYING);
+  arena.AdvanceTime(10);
+  csci3081::RenderSnapshot snapshot;
+  arena.FillSnapshot(&snapshot);
+  ASSERT_EQ(snapshot.entities.size(), arena.get_entities().size());
+  EXPECT_EQ(snapshot.game_status, arena.get_game_status());
+  for (size_t i = 0; i < snapshot.entities.size(); ++i) {
+    const csci3081::RenderEntity &entity = snapshot.entities[i];
+    const csci3081::ArenaEntity *original = arena.get_entities()[i];
+    EXPECT_EQ(entity.type, original->get_type());
+    EXPECT_EQ(entity.get_name(), original->get_name());
+    EXPECT_DOUBLE_EQ(entity.x, original->get_pose().x);
+    EXPECT_DOUBLE_EQ(entity.y, original->get_pose().y);
+    EXPECT_DOUBLE_EQ(entity.radius, original->get_radius());
+  }
+  const csci3081::RenderEntity &robot = snapshot.entities[0];
+  const csci3081::Robot *original = arena.get_robots().entity(0);
+  EXPECT_DOUBLE_EQ(robot.left_sensor_x, original->get_left_sensor_pose().x)
+    << "FAIL: FillSnapshot - Wrong sensor position.";
+  EXPECT_DOUBLE_EQ(robot.right_sensor_y, original->get_right_sensor_pose().y)
+    << "FAIL: FillSnapshot - Wrong sensor position.";
+};
+
+#endif
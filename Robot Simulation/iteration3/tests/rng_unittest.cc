@@ -0,0 +1,107 @@
+// Google Test Framework
+#include <gtest/gtest.h>
+#include <vector>
+
+// Project code from the ../src directory
+#include "../src/arena.h"
+#include "../src/arena_params.h"
+#include "../src/rng.h"
+
+#ifdef RNG_TEST
+
+/************************************************************************
+* SETUP
+*************************************************************************/
+class RngTest : public ::testing::Test {
+ protected:
+  // An Arena with a few of every entity, all placed by its Rng.
+  csci3081::Arena *Build(uint64_t seed) {
+    params.seed = seed;
+    csci3081::Arena *arena = new csci3081::Arena(&params);
+    arena->AddRobot(6, csci3081::kCoward);
+    arena->AddRobot(6, csci3081::kExplore);
+    arena->AddLight(4);
+    arena->AddFood(4);
+    return arena;
+  }
+
+  csci3081::arena_params params;
+};
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+TEST_F(RngTest, SameSeedSameSequence) {
+  csci3081::Rng a(42);
+  csci3081::Rng b(42);
+  EXPECT_EQ(a.get_seed(), 42u) << "FAIL: SameSeedSameSequence - Wrong seed.";
+  for (int i = 0; i < 1000; ++i) {
+    ASSERT_EQ(a.Next(), b.Next())
+      << "FAIL: SameSeedSameSequence - Next() differs at " << i << ".";
+  }
+
+  // Seed() restarts the sequence.
+  std::vector<int> first;
+  a.Seed(7);
+  for (int i = 0; i < 100; ++i) { first.push_back(a.Below(10)); }
+  a.Seed(7);
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_EQ(a.Below(10), first[i])
+      << "FAIL: SameSeedSameSequence - Below() differs after Seed().";
+  }
+};
+
+TEST_F(RngTest, BelowInRange) {
+  csci3081::Rng rng(0);
+  std::vector<int> counts(7, 0);
+  for (int i = 0; i < 7000; ++i) {
+    int value = rng.Below(7);
+    ASSERT_GE(value, 0) << "FAIL: BelowInRange - Below(7) < 0.";
+    ASSERT_LT(value, 7) << "FAIL: BelowInRange - Below(7) >= 7.";
+    ++counts[value];
+  }
+  for (int count : counts) {
+    EXPECT_GT(count, 0) << "FAIL: BelowInRange - A value never came up.";
+  }
+  EXPECT_EQ(rng.Below(1), 0) << "FAIL: BelowInRange - Below(1) != 0.";
+};
+
+TEST_F(RngTest, SameSeedSameArena) {
+  csci3081::Arena *a = Build(11);
+  csci3081::Arena *b = Build(11);
+  EXPECT_EQ(a->get_seed(), 11u) << "FAIL: SameSeedSameArena - Wrong seed.";
+  EXPECT_EQ(a->get_seed(), b->get_seed())
+    << "FAIL: SameSeedSameArena - Seeds differ.";
+
+  const csci3081::EntityStore &sa = a->get_store();
+  const csci3081::EntityStore &sb = b->get_store();
+  ASSERT_EQ(sa.size(), sb.size()) << "FAIL: SameSeedSameArena - Sizes differ.";
+  EXPECT_EQ(sa.type, sb.type) << "FAIL: SameSeedSameArena - type differs.";
+  EXPECT_EQ(sa.x, sb.x) << "FAIL: SameSeedSameArena - x differs.";
+  EXPECT_EQ(sa.y, sb.y) << "FAIL: SameSeedSameArena - y differs.";
+  EXPECT_EQ(sa.theta, sb.theta) << "FAIL: SameSeedSameArena - theta differs.";
+  EXPECT_EQ(sa.radius, sb.radius)
+    << "FAIL: SameSeedSameArena - radius differs.";
+  EXPECT_EQ(sa.vel_left, sb.vel_left)
+    << "FAIL: SameSeedSameArena - vel_left differs.";
+  EXPECT_EQ(sa.vel_right, sb.vel_right)
+    << "FAIL: SameSeedSameArena - vel_right differs.";
+  delete a;
+  delete b;
+};
+
+TEST_F(RngTest, OtherSeedOtherArena) {
+  csci3081::Arena *a = Build(11);
+  csci3081::Arena *b = Build(12);
+  EXPECT_EQ(b->get_seed(), 12u) << "FAIL: OtherSeedOtherArena - Wrong seed.";
+  ASSERT_EQ(a->get_store().size(), b->get_store().size())
+    << "FAIL: OtherSeedOtherArena - Sizes differ.";
+  EXPECT_NE(a->get_store().x, b->get_store().x)
+    << "FAIL: OtherSeedOtherArena - Same x positions.";
+  EXPECT_NE(a->get_store().y, b->get_store().y)
+    << "FAIL: OtherSeedOtherArena - Same y positions.";
+  delete a;
+  delete b;
+};
+
+#endif /* RNG_TEST */
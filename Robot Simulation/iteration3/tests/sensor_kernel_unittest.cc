@@ -0,0 +1,79 @@
+// Google Test Framework
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+
+// Project code from the ../src directory
+#include "../src/light_sensor.h"
+#include "../src/pose.h"
+#include "../src/sensor_kernel.h"
+#include "../src/params.h"
+
+#ifdef SENSOR_KERNEL_TEST
+
+/************************************************************************
+* SETUP
+*************************************************************************/
+
+class SensorKernelTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    // A line of sensors, from inside a light out to the far corner.
+    for (int i = 0; i < 11; ++i) {
+      sensor_x.push_back(i * 97.0);
+      sensor_y.push_back(i * 71.0);
+      gain.push_back(2000 * (0.5 + 0.1 * i));
+      reading.push_back(0);
+    }
+  }
+  std::vector<double> sensor_x;
+  std::vector<double> sensor_y;
+  std::vector<double> gain;
+  std::vector<double> reading;
+  std::vector<double> source_x = {0, 300, 650, 1000};
+  std::vector<double> source_y = {0, 500, 120, 760};
+};
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+TEST_F(SensorKernelTest, Exp) {
+  for (double x = -40; x < 5; x += 0.37) {
+    EXPECT_NEAR(csci3081::SensorKernelExp(x), std::exp(x), 4e-16 * std::exp(x))
+      << "FAIL: Exp - Approximation too far from exp(" << x << ").";
+  }
+};
+
+// The batched readings must match LightSensor::CalculateReading().
+TEST_F(SensorKernelTest, MatchesCalculateReading) {
+  csci3081::AccumulateSensorReadings(sensor_x.data(), sensor_y.data(),
+    gain.data(), sensor_x.size(), source_x.data(), source_y.data(),
+    source_x.size(), reading.data());
+  for (size_t i = 0; i < sensor_x.size(); ++i) {
+    csci3081::LightSensor sensor(csci3081::Pose(sensor_x[i], sensor_y[i]));
+    sensor.SetLightSensitivity(gain[i] / 2000);
+    for (size_t j = 0; j < source_x.size(); ++j) {
+      sensor.CalculateReading(csci3081::Pose(source_x[j], source_y[j]));
+    }
+    EXPECT_NEAR(reading[i], sensor.GetReading(), 1e-12 * sensor.GetReading())
+      << "FAIL: MatchesCalculateReading - Sensor " << i << " differs.";
+    EXPECT_LE(reading[i], 1000.0) << "FAIL: MatchesCalculateReading - Reading was not clamped.";
+  }
+  EXPECT_EQ(reading[0], 1000.0) << "FAIL: MatchesCalculateReading - Sensor on a light did not produce maximum reading.";
+};
+
+// Sensors processed in a vector must give the same bits as one at a time.
+TEST_F(SensorKernelTest, BatchIndependent) {
+  reading[3] = 250;
+  std::vector<double> single(reading);
+  csci3081::AccumulateSensorReadings(sensor_x.data(), sensor_y.data(),
+    gain.data(), sensor_x.size(), source_x.data(), source_y.data(),
+    source_x.size(), reading.data());
+  for (size_t i = 0; i < sensor_x.size(); ++i) {
+    csci3081::AccumulateSensorReadings(&sensor_x[i], &sensor_y[i], &gain[i], 1,
+      source_x.data(), source_y.data(), source_x.size(), &single[i]);
+    EXPECT_EQ(reading[i], single[i]) << "FAIL: BatchIndependent - Sensor " << i << " depends on its batch (" << csci3081::SensorKernelIsa() << ").";
+  }
+};
+
+#endif
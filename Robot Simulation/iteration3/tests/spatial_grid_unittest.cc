@@ -0,0 +1,100 @@
+// Google Test Framework
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <vector>
+
+// Project code from the ../src directory
+#include "../src/spatial_grid.h"
+
+#ifdef SPATIAL_GRID_TEST
+
+/************************************************************************
+* SETUP
+*************************************************************************/
+
+class SpatialGridTest : public ::testing::Test {
+ protected:
+  // A 20 x 16 grid of 50 pixel cells.
+  virtual void SetUp() { grid.Resize(1000, 800, 50); }
+
+  // The ids near (x, y), sorted.
+  std::vector<int> Near(double x, double y) {
+    std::vector<int> ids;
+    grid.Query(x, y, &ids);
+    std::sort(ids.begin(), ids.end());
+    return ids;
+  }
+
+  csci3081::SpatialGrid grid;
+};
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+// Neighbors on either side of a cell border are found; ids two cells away
+// are not.
+TEST_F(SpatialGridTest, QueryAcrossBorder) {
+  grid.Insert(0, 49, 10);
+  grid.Insert(1, 51, 10);
+  grid.Insert(2, 140, 10);
+  grid.Insert(3, 49, 51);
+  EXPECT_EQ(Near(49, 10), std::vector<int>({0, 1, 3}))
+    << "FAIL: QueryAcrossBorder - Missed a neighbor in the next cell.";
+  EXPECT_EQ(Near(51, 10), std::vector<int>({0, 1, 2, 3}));
+  EXPECT_EQ(Near(140, 10), std::vector<int>({1, 2}))
+    << "FAIL: QueryAcrossBorder - Found ids two cells away.";
+};
+
+// Positions outside the arena fall in the border cells, however far out.
+TEST_F(SpatialGridTest, ClampsOutsidePositions) {
+  grid.Insert(0, -30, -1e9);
+  grid.Insert(1, 1e12, 2000);
+  grid.Insert(2, -1e300, 1e300);
+  EXPECT_EQ(Near(5, 5), std::vector<int>({0}))
+    << "FAIL: ClampsOutsidePositions - Not in the top left cell.";
+  EXPECT_EQ(Near(990, 790), std::vector<int>({1}))
+    << "FAIL: ClampsOutsidePositions - Not in the bottom right cell.";
+  EXPECT_EQ(Near(0, 799), std::vector<int>({2}))
+    << "FAIL: ClampsOutsidePositions - Not in the bottom left cell.";
+  EXPECT_EQ(Near(-5, -5), std::vector<int>({0}));
+  EXPECT_EQ(Near(500, 400), std::vector<int>());
+};
+
+TEST_F(SpatialGridTest, Move) {
+  grid.Insert(0, 10, 10);
+  grid.Insert(1, 12, 12);
+  grid.Insert(2, 14, 14);
+  grid.Move(0, 500, 500);
+  EXPECT_EQ(Near(10, 10), std::vector<int>({1, 2}))
+    << "FAIL: Move - Still in its old cell.";
+  EXPECT_EQ(Near(500, 500), std::vector<int>({0}))
+    << "FAIL: Move - Not in its new cell.";
+  // Within the same cell, and back.
+  grid.Move(0, 510, 510);
+  EXPECT_EQ(Near(500, 500), std::vector<int>({0}));
+  grid.Move(0, 10, 10);
+  EXPECT_EQ(Near(10, 10), std::vector<int>({0, 1, 2}));
+  EXPECT_EQ(Near(500, 500), std::vector<int>());
+};
+
+// Larger cells, e.g. once a bigger robot shows up, reach further. Resize()
+// empties the grid.
+TEST_F(SpatialGridTest, Resize) {
+  grid.Insert(0, 10, 10);
+  grid.Insert(1, 130, 10);
+  EXPECT_EQ(Near(10, 10), std::vector<int>({0}));
+  grid.Resize(1000, 800, 150);
+  EXPECT_DOUBLE_EQ(grid.get_cell_size(), 150);
+  EXPECT_EQ(Near(10, 10), std::vector<int>())
+    << "FAIL: Resize - The grid was not emptied.";
+  grid.Insert(0, 10, 10);
+  grid.Insert(1, 130, 10);
+  EXPECT_EQ(Near(10, 10), std::vector<int>({0, 1}))
+    << "FAIL: Resize - Larger cells missed a neighbor.";
+  EXPECT_EQ(Near(999, 799), std::vector<int>());
+  grid.Resize(1000, 800, 0);
+  EXPECT_DOUBLE_EQ(grid.get_cell_size(), 1)
+    << "FAIL: Resize - Cell size was not kept above zero.";
+};
+
+#endif /* SPATIAL_GRID_TEST */
@@ -0,0 +1,85 @@
+// Google Test Framework
+#include <gtest/gtest.h>
+
+// Project code from the ../src directory
+#include "../src/params.h"
+#include "../src/step_accumulator.h"
+
+#ifdef STEP_ACCUMULATOR_TEST
+
+/************************************************************************
+* SETUP
+*************************************************************************/
+// Step sizes and times are binary fractions, so the sums are exact.
+class StepAccumulatorTest : public ::testing::Test {
+ protected:
+  csci3081::StepAccumulator steps{0.25, 4};
+};
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+// Time short of a whole step carries over to the next frame.
+TEST_F(StepAccumulatorTest, CarriesRemainder) {
+  EXPECT_EQ(steps.Advance(0.375), 1);
+  EXPECT_EQ(steps.Advance(0.125), 1)
+    << "FAIL: CarriesRemainder - The remainder was lost.";
+  EXPECT_EQ(steps.Advance(0.125), 0);
+  EXPECT_EQ(steps.Advance(0.125), 1);
+  EXPECT_EQ(steps.Advance(0.625), 2);
+  steps.Reset();
+  EXPECT_EQ(steps.Advance(0.125), 0)
+    << "FAIL: CarriesRemainder - Reset() kept the remainder.";
+  EXPECT_DOUBLE_EQ(steps.get_dropped_time(), 0);
+};
+
+// At most max_substeps per frame; the rest of the backlog is dropped and
+// counted.
+TEST_F(StepAccumulatorTest, CapsSubsteps) {
+  EXPECT_EQ(steps.Advance(1.0), 4);
+  EXPECT_DOUBLE_EQ(steps.get_dropped_time(), 0)
+    << "FAIL: CapsSubsteps - Dropped time at exactly the cap.";
+  EXPECT_EQ(steps.Advance(2.125), 4);
+  EXPECT_DOUBLE_EQ(steps.get_dropped_time(), 1.125)
+    << "FAIL: CapsSubsteps - Wrong dropped time.";
+  // Nothing of the backlog is left over.
+  EXPECT_EQ(steps.Advance(0.125), 0);
+  EXPECT_EQ(steps.Advance(0.125), 1);
+  EXPECT_EQ(steps.Advance(10.0), 4);
+  EXPECT_DOUBLE_EQ(steps.get_dropped_time(), 10.125);
+};
+
+TEST_F(StepAccumulatorTest, Speed) {
+  steps.set_speed(4);
+  EXPECT_EQ(steps.Advance(0.25), 4)
+    << "FAIL: Speed - Fast-forward did not scale the time.";
+  steps.set_speed(0.5);
+  EXPECT_EQ(steps.Advance(0.25), 0);
+  EXPECT_EQ(steps.Advance(0.25), 1)
+    << "FAIL: Speed - Slow motion did not scale the time.";
+  steps.set_speed(0);
+  steps.set_speed(-2);
+  EXPECT_DOUBLE_EQ(steps.get_speed(), 0.5)
+    << "FAIL: Speed - Accepted a speed that is not positive.";
+};
+
+// Non-positive times and sizes are ignored.
+TEST_F(StepAccumulatorTest, IgnoresNonPositive) {
+  EXPECT_EQ(steps.Advance(0.125), 0);
+  EXPECT_EQ(steps.Advance(-5), 0);
+  EXPECT_EQ(steps.Advance(0), 0);
+  EXPECT_EQ(steps.Advance(0.125), 1)
+    << "FAIL: IgnoresNonPositive - A negative dt changed the accumulator.";
+
+  steps.set_step_size(0);
+  steps.set_step_size(-1);
+  EXPECT_DOUBLE_EQ(steps.get_step_size(), 0.25);
+  steps.set_max_substeps(0);
+  EXPECT_EQ(steps.get_max_substeps(), 1);
+
+  csci3081::StepAccumulator defaults(0, -3);
+  EXPECT_DOUBLE_EQ(defaults.get_step_size(), SIM_STEP_SIZE);
+  EXPECT_EQ(defaults.get_max_substeps(), 1);
+};
+
+#endif /* STEP_ACCUMULATOR_TEST */
@@ -0,0 +1,164 @@
+// Google Test Framework
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Project code from the ../src directory
+#include "../src/sweep.h"
+#include "../src/work_stealing_pool.h"
+
+#ifdef SWEEP_TEST
+
+/************************************************************************
+* SETUP
+*************************************************************************/
+class SweepTest : public ::testing::Test {
+ protected:
+  bool Parse(const std::string &spec) {
+    std::istringstream in(spec);
+    return design.Parse(in, &error);
+  }
+
+  csci3081::SweepDesign design;
+  std::string error;
+};
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+// Every combination, repeated, with its own seed.
+TEST_F(SweepTest, Grid) {
+  ASSERT_TRUE(Parse("# comment\n"
+                    "robots = 4, 8, 16\n"
+                    "foods = 0,2\n"
+                    "  ratio = 0.25 # explorers\n"
+                    "repeats = 2\n"
+                    "steps = 50\n")) << error;
+  std::vector<csci3081::SweepRun> runs = design.Runs();
+  ASSERT_EQ(runs.size(), 12u)
+    << "FAIL: Grid - Wrong number of runs.";
+  EXPECT_EQ(runs[0].params.n_robots, 4u);
+  EXPECT_EQ(runs[0].params.n_foods, 0u);
+  EXPECT_EQ(runs[2].params.n_foods, 2u);
+  EXPECT_EQ(runs[11].params.n_robots, 16u);
+  EXPECT_EQ(runs[11].params.n_lights, static_cast<size_t>(N_LIGHTS));
+  for (size_t i = 0; i < runs.size(); ++i) {
+    EXPECT_EQ(runs[i].index, i);
+    EXPECT_EQ(runs[i].steps, 50);
+    EXPECT_DOUBLE_EQ(runs[i].robot_ratio, 0.25);
+    EXPECT_NE(runs[i].params.seed, 0u);
+  }
+  EXPECT_NE(runs[0].params.seed, runs[1].params.seed)
+    << "FAIL: Grid - Repeats share a seed.";
+};
+
+// Random values stay in their ranges and lists, the same for the same seed.
+TEST_F(SweepTest, Random) {
+  std::string spec = "design = random\n"
+                     "runs = 200\n"
+                     "seed = 7\n"
+                     "robots = 5..20\n"
+                     "sensitivity = 0.5..2\n"
+                     "lights = 1, 3\n";
+  ASSERT_TRUE(Parse(spec)) << error;
+  std::vector<csci3081::SweepRun> runs = design.Runs();
+  ASSERT_EQ(runs.size(), 200u);
+  bool saw_one = false, saw_three = false;
+  for (const csci3081::SweepRun &run : runs) {
+    EXPECT_GE(run.params.n_robots, 5u);
+    EXPECT_LE(run.params.n_robots, 20u);
+    EXPECT_GE(run.light_sensitivity, 0.5);
+    EXPECT_LT(run.light_sensitivity, 2.0);
+    saw_one |= run.params.n_lights == 1;
+    saw_three |= run.params.n_lights == 3;
+    EXPECT_TRUE(run.params.n_lights == 1 || run.params.n_lights == 3);
+  }
+  EXPECT_TRUE(saw_one && saw_three)
+    << "FAIL: Random - A listed value was never drawn.";
+
+  csci3081::SweepDesign again;
+  std::istringstream in(spec);
+  ASSERT_TRUE(again.Parse(in, &error));
+  std::vector<csci3081::SweepRun> rerun = again.Runs();
+  for (size_t i = 0; i < runs.size(); ++i) {
+    EXPECT_EQ(runs[i].params.seed, rerun[i].params.seed);
+    EXPECT_EQ(runs[i].params.n_robots, rerun[i].params.n_robots);
+  }
+};
+
+TEST_F(SweepTest, ParseErrors) {
+  EXPECT_FALSE(Parse("robots 10\n"));
+  EXPECT_FALSE(Parse("planets = 3\n"));
+  EXPECT_FALSE(Parse("robots = 10, ten\n"));
+  EXPECT_FALSE(Parse("ratio = 1.5\n"));
+  EXPECT_FALSE(Parse("foods = -1\n"));
+  EXPECT_FALSE(Parse("steps = 0\n"));
+  EXPECT_FALSE(Parse("design = latin\n"));
+  EXPECT_FALSE(Parse("robots = 20..5\ndesign = random\n"));
+  EXPECT_FALSE(Parse("robots = 5..20\n"))
+    << "FAIL: ParseErrors - Accepted a range in a grid design.";
+  EXPECT_NE(error.find("random"), std::string::npos);
+};
+
+// Each task runs exactly once, even when a few are much longer than the rest.
+TEST(WorkStealingPoolTest, RunsEveryTaskOnce) {
+  csci3081::WorkStealingPool pool(4);
+  ASSERT_EQ(pool.get_n_threads(), 4u);
+  for (size_t n_tasks : {0u, 1u, 3u, 97u}) {
+    std::vector<std::atomic<int>> count(n_tasks);
+    for (auto &c : count) {
+      c = 0;
+    }
+    std::atomic<bool> bad_thread{false};
+    pool.Run(n_tasks, [&](size_t task, size_t thread) {
+        if (thread >= 4) {
+          bad_thread = true;
+        }
+        if (task < 4) {
+          std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+        ++count[task];
+      });
+    EXPECT_FALSE(bad_thread);
+    for (size_t task = 0; task < n_tasks; ++task) {
+      EXPECT_EQ(count[task], 1) << "FAIL: RunsEveryTaskOnce - Task " << task
+                                << " of " << n_tasks;
+    }
+  }
+};
+
+// A run depends only on its configuration, not on where it ran.
+TEST_F(SweepTest, Deterministic) {
+  ASSERT_TRUE(Parse("robots = 12\nfoods = 2\nsteps = 300\nlove = 0.25\n"))
+    << error;
+  csci3081::SweepRun run = design.Runs()[0];
+  csci3081::SweepResult first = csci3081::RunConfiguration(run);
+  csci3081::SweepResult second;
+  std::thread other([&] { second = csci3081::RunConfiguration(run); });
+  other.join();
+  EXPECT_GT(first.survival_steps, 0);
+  EXPECT_EQ(first.survival_steps, second.survival_steps);
+  EXPECT_EQ(first.game_status, second.game_status);
+  EXPECT_EQ(first.food_captures, second.food_captures);
+  EXPECT_EQ(first.robot_collisions, second.robot_collisions);
+  EXPECT_EQ(first.robot_wall_collisions, second.robot_wall_collisions);
+  EXPECT_DOUBLE_EQ(first.mean_hunger, second.mean_hunger);
+
+  std::ostringstream csv;
+  csci3081::WriteSweepCsvHeader(csv);
+  csci3081::WriteSweepCsvRow(csv, run, first);
+  std::string text = csv.str();
+  EXPECT_EQ(std::count(text.begin(), text.end(), '\n'), 2);
+  size_t header_commas = std::count(text.begin(), text.begin() +
+                                    text.find('\n'), ',');
+  EXPECT_EQ(std::count(text.begin(), text.end(), ','),
+            static_cast<long>(2 * header_commas))
+    << "FAIL: Deterministic - Row and header have different columns.";
+};
+
+#endif /* SWEEP_TEST */
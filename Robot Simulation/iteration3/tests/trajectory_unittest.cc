@@ -0,0 +1,184 @@
+// Google Test Framework
+#include <gtest/gtest.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Project code from the ../src directory
+#include "../src/arena.h"
+#include "../src/arena_params.h"
+#include "../src/trajectory.h"
+
+#ifdef TRAJECTORY_TEST
+
+/************************************************************************
+* SETUP
+*************************************************************************/
+class TrajectoryTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    params.n_threads = 2;
+    params.seed = 11;
+    path = "trajectory_test_" + std::to_string(getpid()) + ".trj";
+  }
+  virtual void TearDown() { std::remove(path.c_str()); }
+
+  // Record `steps` timesteps of a busy arena, keeping what was recorded.
+  // Food is removed half way through, which must start a new chunk.
+  void Record(int steps, int keyframe_interval) {
+    csci3081::Arena arena(&params);
+    arena.AddRobot(15, csci3081::kCoward);
+    arena.AddRobot(15, csci3081::kExplore);
+    arena.AddLight(4);
+    arena.AddFood(4);
+    arena.AcceptCommand(csci3081::kFoodOn);
+    arena.AcceptCommand(csci3081::kPlay);
+    arena.set_record_events(true);
+    csci3081::TrajectoryWriter writer;
+    ASSERT_TRUE(writer.Open(path, arena.get_x_dim(), arena.get_y_dim(),
+                            keyframe_interval));
+    for (int step = 0; step < steps; ++step) {
+      if (step == steps / 2) {
+        arena.AcceptCommand(csci3081::kFoodOff);
+      }
+      arena.AdvanceTime(1);
+      ASSERT_TRUE(writer.AddFrame(arena.get_store(), arena.get_game_status(),
+                                  arena.get_events()));
+      expected.emplace_back();
+      arena.FillSnapshot(&expected.back());
+      events.push_back(arena.get_events());
+      arena.ClearEvents();
+    }
+    ASSERT_TRUE(writer.Close());
+    EXPECT_EQ(writer.get_n_frames(), static_cast<uint64_t>(steps));
+  }
+
+  csci3081::arena_params params;
+  std::string path;
+  std::vector<csci3081::RenderSnapshot> expected;
+  std::vector<std::vector<csci3081::ArenaEvent>> events;
+};
+
+// Positions come back to within the fixed point resolution.
+static void ExpectSameSnapshot(const csci3081::RenderSnapshot &expected,
+                               const csci3081::RenderSnapshot &actual) {
+  const double tolerance = 0.5 / TRAJECTORY_SCALE + 1e-9;
+  ASSERT_EQ(expected.entities.size(), actual.entities.size());
+  EXPECT_EQ(expected.game_status, actual.game_status);
+  for (size_t i = 0; i < expected.entities.size(); ++i) {
+    const csci3081::RenderEntity &e = expected.entities[i];
+    const csci3081::RenderEntity &a = actual.entities[i];
+    EXPECT_EQ(e.type, a.type);
+    EXPECT_EQ(e.id, a.id);
+    EXPECT_TRUE(e.color == a.color);
+    EXPECT_NEAR(e.x, a.x, tolerance);
+    EXPECT_NEAR(e.y, a.y, tolerance);
+    EXPECT_NEAR(e.radius, a.radius, tolerance);
+  }
+}
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+TEST_F(TrajectoryTest, RoundTrip) {
+  Record(300, 25);
+  csci3081::TrajectoryReader reader;
+  ASSERT_TRUE(reader.Open(path))
+    << "FAIL: RoundTrip - Could not open the recording.";
+  ASSERT_EQ(reader.get_n_frames(), expected.size());
+  csci3081::RenderSnapshot snapshot;
+  std::vector<csci3081::ArenaEvent> read_events;
+  size_t n_events = 0;
+  for (size_t step = 0; step < expected.size(); ++step) {
+    ASSERT_TRUE(reader.Next(&snapshot, &read_events))
+      << "FAIL: RoundTrip - Stopped at step " << step;
+    ExpectSameSnapshot(expected[step], snapshot);
+    ASSERT_EQ(read_events.size(), events[step].size());
+    for (size_t e = 0; e < read_events.size(); ++e) {
+      EXPECT_EQ(read_events[e].type, events[step][e].type);
+      EXPECT_EQ(read_events[e].id, events[step][e].id);
+      EXPECT_EQ(read_events[e].other, events[step][e].other);
+    }
+    n_events += read_events.size();
+  }
+  EXPECT_GT(n_events, 0u) << "FAIL: RoundTrip - Nothing happened.";
+  EXPECT_FALSE(reader.Next(&snapshot, &read_events))
+    << "FAIL: RoundTrip - Read past the end.";
+};
+
+TEST_F(TrajectoryTest, Seek) {
+  Record(200, 30);
+  csci3081::TrajectoryReader reader;
+  ASSERT_TRUE(reader.Open(path));
+  csci3081::RenderSnapshot snapshot;
+  for (uint64_t step : {150u, 30u, 31u, 0u, 199u}) {
+    ASSERT_TRUE(reader.Seek(step));
+    EXPECT_EQ(reader.get_step(), step);
+    ASSERT_TRUE(reader.Next(&snapshot, nullptr));
+    ExpectSameSnapshot(expected[step], snapshot);
+  }
+  EXPECT_FALSE(reader.Seek(200))
+    << "FAIL: Seek - Sought past the end.";
+};
+
+// A recording cut short (e.g. by a crash) keeps its complete chunks.
+TEST_F(TrajectoryTest, Unfinished) {
+  Record(100, 20);
+  FILE *file = fopen(path.c_str(), "rb");
+  ASSERT_NE(file, nullptr);
+  csci3081::TrajectoryTrailer trailer;
+  fseek(file, -static_cast<long>(sizeof(trailer)), SEEK_END);
+  ASSERT_EQ(fread(&trailer, sizeof(trailer), 1, file), 1u);
+  fclose(file);
+  // Drop the index, the trailer and the end of the last chunk, which
+  // starts at step 90 (chunks start every 20 steps, and at step 50).
+  ASSERT_EQ(truncate(path.c_str(), trailer.index_offset - 1), 0);
+  csci3081::TrajectoryReader reader;
+  ASSERT_TRUE(reader.Open(path))
+    << "FAIL: Unfinished - Could not open the recording.";
+  EXPECT_EQ(reader.get_n_frames(), 90u);
+  csci3081::RenderSnapshot snapshot;
+  ASSERT_TRUE(reader.Seek(89));
+  ASSERT_TRUE(reader.Next(&snapshot, nullptr));
+  ExpectSameSnapshot(expected[89], snapshot);
+};
+
+// Sizes in a damaged file are checked against the file before anything is
+// allocated for them.
+TEST_F(TrajectoryTest, Corrupt) {
+  Record(60, 20);
+  FILE *file = fopen(path.c_str(), "r+b");
+  ASSERT_NE(file, nullptr);
+  csci3081::TrajectoryTrailer trailer;
+  fseek(file, -static_cast<long>(sizeof(trailer)), SEEK_END);
+  ASSERT_EQ(fread(&trailer, sizeof(trailer), 1, file), 1u);
+  // n_chunks * 16 wraps around to the real size of the index.
+  trailer.n_chunks += uint64_t{1} << 60;
+  fseek(file, -static_cast<long>(sizeof(trailer)), SEEK_END);
+  ASSERT_EQ(fwrite(&trailer, sizeof(trailer), 1, file), 1u);
+  fflush(file);
+  csci3081::TrajectoryReader reader;
+  ASSERT_TRUE(reader.Open(path))
+    << "FAIL: Corrupt - Could not walk the chunks past a bad index.";
+  EXPECT_EQ(reader.get_n_frames(), 60u);
+
+  // With the index restored, a first chunk claiming almost 4 GiB.
+  trailer.n_chunks -= uint64_t{1} << 60;
+  fseek(file, -static_cast<long>(sizeof(trailer)), SEEK_END);
+  ASSERT_EQ(fwrite(&trailer, sizeof(trailer), 1, file), 1u);
+  csci3081::TrajectoryChunk chunk;
+  fseek(file, sizeof(csci3081::TrajectoryHeader), SEEK_SET);
+  ASSERT_EQ(fread(&chunk, sizeof(chunk), 1, file), 1u);
+  chunk.size = 0xfffffff0u;
+  fseek(file, sizeof(csci3081::TrajectoryHeader), SEEK_SET);
+  ASSERT_EQ(fwrite(&chunk, sizeof(chunk), 1, file), 1u);
+  fclose(file);
+  errno = 0;
+  EXPECT_FALSE(reader.Open(path))
+    << "FAIL: Corrupt - Opened a chunk larger than the file.";
+  EXPECT_EQ(errno, EINVAL);
+};
+
+#endif /* TRAJECTORY_TEST */